@@ -47,6 +47,8 @@
 #ifndef rubics_cube_H
 #define rubics_cube_H
 
+#include "rubics_cube_random.h"
+
 #include <inttypes.h>
 #include <stdbool.h>
 
@@ -60,6 +62,20 @@
 ///the maximum size is 255 blocks. The original size is 3 blocks (3x3x3 cube).
 #define CUBE_SIZE 3
 
+/// Bits of the block count of one color in the color counts of a face, and
+///the number of 64-bit words of the counts. A small cube has all counts in
+///one word.
+#if CUBE_SIZE<32
+#define CUBE_COLOR_COUNT_BITS 10
+#define CUBE_COLOR_WORD_COUNT 1
+#else
+#define CUBE_COLOR_COUNT_BITS 16
+#define CUBE_COLOR_WORD_COUNT 2
+#endif
+
+/// Number of random moves that shuffles a cube well.
+#define CUBE_SHUFFLE_LENGTH (CUBE_SIZE*10)
+
 /******************************************************************************\
 **
 **  TYPE DEFINES
@@ -135,6 +151,90 @@ CubeDirection_t{
         CUBE_DIRECTION_COUNT
 } CubeDirection_t;
 
+/**
+**  @brief Outer layer turns in the standard (Singmaster) notation.
+**
+**  U, R, F, D, L and B are the top, right, front, bottom, left and back
+**  layers. Each layer has a clockwise quarter turn, a half turn and a
+**  counter-clockwise quarter turn, in this order.
+*/
+typedef enum
+CubeTurn_t{
+        /// Top layer clockwise.
+        CUBE_TURN_U=0,
+        /// Top layer half turn.
+        CUBE_TURN_U2,
+        /// Top layer counter-clockwise.
+        CUBE_TURN_U_PRIME,
+        /// Right layer clockwise.
+        CUBE_TURN_R,
+        /// Right layer half turn.
+        CUBE_TURN_R2,
+        /// Right layer counter-clockwise.
+        CUBE_TURN_R_PRIME,
+        /// Front layer clockwise.
+        CUBE_TURN_F,
+        /// Front layer half turn.
+        CUBE_TURN_F2,
+        /// Front layer counter-clockwise.
+        CUBE_TURN_F_PRIME,
+        /// Bottom layer clockwise.
+        CUBE_TURN_D,
+        /// Bottom layer half turn.
+        CUBE_TURN_D2,
+        /// Bottom layer counter-clockwise.
+        CUBE_TURN_D_PRIME,
+        /// Left layer clockwise.
+        CUBE_TURN_L,
+        /// Left layer half turn.
+        CUBE_TURN_L2,
+        /// Left layer counter-clockwise.
+        CUBE_TURN_L_PRIME,
+        /// Back layer clockwise.
+        CUBE_TURN_B,
+        /// Back layer half turn.
+        CUBE_TURN_B2,
+        /// Back layer counter-clockwise.
+        CUBE_TURN_B_PRIME,
+        /// Turn count.
+        CUBE_TURN_COUNT
+} CubeTurn_t;
+
+/**
+**  @brief Axes of the layers.
+**
+**  The layers are numbered from 0 along the axis. A positive quarter turn of
+**  any layer goes in the same direction as the face turn named below.
+*/
+typedef enum
+CubeAxis_t{
+        /// From the left side (column 0) to the right side, turns like R.
+        CUBE_AXIS_X=0,
+        /// From the top side (row 0) to the bottom side, turns like U.
+        CUBE_AXIS_Y,
+        /// From the front side to the back side, turns like F.
+        CUBE_AXIS_Z,
+        /// Axis count.
+        CUBE_AXIS_COUNT
+} CubeAxis_t;
+
+/**
+**  @brief A move of one or more adjacent layers.
+**
+**  Any face, wide, slice or whole cube turn is a move of a layer range.
+*/
+typedef struct
+CubeMove_t{
+        /// Axis of the layers (CubeAxis_t).
+        uint8_t axis;
+        /// First layer to turn.
+        uint8_t first;
+        /// Last layer to turn.
+        uint8_t last;
+        /// Quarter turns (1-3), positive direction of the axis.
+        uint8_t turns;
+} CubeMove_t;
+
 /**
 **  @brief Colors of the face blocks.
 **
@@ -149,8 +249,15 @@ CubeBlocks_t[CUBE_SIZE][CUBE_SIZE];
 */
 typedef struct
 CubeFace_t{
-        /// Face blocks.
+        /// Face blocks. Every block must be a valid color, below
+        /// CUBE_COLOR_COUNT, as the colors index the count and hash tables.
         CubeBlocks_t blocks;
+        /// Number of blocks of each color in CUBE_COLOR_COUNT_BITS wide
+        /// fields, in the order of the colors. The counts move with the
+        /// blocks, and all fields of a word are updated with one addition.
+        uint64_t colorCount[CUBE_COLOR_WORD_COUNT];
+        /// All blocks are of the same color.
+        bool isSolved;
 }CubeFace_t;
 
 /**
@@ -164,6 +271,8 @@ Cube_t{
         uint8_t row;
         /// Current column.
         uint8_t col;
+        /// Number of solved faces.
+        uint8_t solvedFaces;
 } Cube_t;
 
 /******************************************************************************\
@@ -183,15 +292,60 @@ cube_reset(
 );
 
 /*-------------------------------------------------------------------------*//**
-**  @brief Shuffles a cube.
+**  @brief Counts the colors of the faces again.
+**
+**  Must be called after the blocks are written directly instead of with the
+**  cube functions. The blocks must be valid colors, which is not checked.
 **
 **  @param[in] cube A pointer to a cube.
 */
-void 
-cube_shuffle(
+void
+cube_recount(
         Cube_t *cube
 );
 
+/*-------------------------------------------------------------------------*//**
+**  @brief Shuffles a cube with random moves.
+**
+**  Each move turns one layer of a random axis by a random amount. The middle
+**  layer of an odd sized cube is not turned. Consecutive moves of the same
+**  axis are made in the order of the layers, so no moves cancel each other.
+**  The same generator state always gives the same moves, and the cursors
+**  are not used or changed.
+**
+**  @param[in] cube A pointer to a cube, or NULL to only draw the moves.
+**  @param[in,out] random A pointer to a random number generator.
+**  @param[in] length Number of moves, for example CUBE_SHUFFLE_LENGTH.
+**  @param[out] moves A buffer of length moves for the moves made, or NULL.
+*/
+void
+cube_shuffle(
+        Cube_t *cube,
+        CubeRandom_t *random,
+        uint32_t length,
+        CubeMove_t *moves
+);
+
+#if CUBE_SIZE==3
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets a cube to a uniformly random state.
+**
+**  Every reachable state is equally likely. Unlike random moves, this takes
+**  constant time and the result does not depend on a scramble length. The
+**  faces get the colors of a reset cube and the cursors are not changed.
+**
+**  @param[out] cube A pointer to a cube.
+**  @param[in,out] random A pointer to a random number generator.
+*/
+void
+cube_shuffle_state(
+        Cube_t *cube,
+        CubeRandom_t *random
+);
+
+#endif // if CUBE_SIZE==3
+
 /*-------------------------------------------------------------------------*//**
 **  @brief Rotates the whole cube.
 **
@@ -240,9 +394,67 @@ cube_rotate_front_face(
         CubeDirection_t dir
 );
 
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns one layer.
+**
+**  The layer is addressed directly, so the row and column cursors are not
+**  used or changed, and a half turn is done in a single pass. The function
+**  only accesses the given cube. The blocks must be valid colors, which is
+**  not checked.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] axis Axis of the layer.
+**  @param[in] layer Index of the layer along the axis (0 - CUBE_SIZE-1).
+**  @param[in] turns Quarter turns in the positive direction of the axis
+**                   (1-3). 0 leaves the cube as it is.
+*/
+void
+cube_turn(
+        Cube_t *cube,
+        CubeAxis_t axis,
+        uint8_t layer,
+        uint8_t turns
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies a sequence of moves.
+**
+**  The moves address the layers directly, so the row and column cursors are
+**  not used or changed. Layers beyond the cube size are ignored.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] moves Moves to apply.
+**  @param[in] count Number of moves.
+*/
+void
+cube_apply_moves(
+        Cube_t *cube,
+        CubeMove_t *moves,
+        uint32_t count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies a sequence of outer layer turns.
+**
+**  The turns do not use or change the row and column cursors.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] turns Turns to apply.
+**  @param[in] count Number of turns.
+*/
+void
+cube_apply_turns(
+        Cube_t *cube,
+        CubeTurn_t *turns,
+        uint32_t count
+);
+
 /*-------------------------------------------------------------------------*//**
 **  @brief Checks if the cube is solved.
 **
+**  The moves keep count of the colors of each face, so the check takes
+**  constant time.
+**
 **  @param[in] cube A pointer to a cube.
 **
 **  @retval true Cube is solved.
@@ -253,6 +465,36 @@ cube_is_solved(
         Cube_t *cube
 );
 
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets a hash of the state of a cube.
+**
+**  The hash is computed from the blocks when asked, so the moves do not pay
+**  for it. Equal states have equal hashes in every process, and
+**  the cursors do not affect the hash. Every block has an independent random
+**  key, so two different states have the same hash with the probability of
+**  about 2^-64.
+**
+**  @param[in] cube A pointer to a cube.
+**
+**  @return The 64-bit hash.
+*/
+uint64_t
+cube_get_hash(
+        Cube_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the color of a side of a reset cube.
+**
+**  @param[in] side A side of the cube.
+**
+**  @return The color of the side after reset.
+*/
+CubeColor_t
+cube_get_reset_color(
+        CubeSide_t side
+);
+
 /*-------------------------------------------------------------------------*//**
 **  @brief Moves the row and column cursors.
 **
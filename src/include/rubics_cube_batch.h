@@ -0,0 +1,253 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_batch.h
+**  @ingroup    rubicscube
+**  @brief      Batches of cubes in structure-of-arrays layout.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_batch_H
+#define rubics_cube_batch_H
+
+#include "rubics_cube_packed.h"
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Alignment of the sticker planes in bytes. The number of lanes of a plane
+///is rounded up to it, so every plane starts on a cache line.
+#define CUBE_BATCH_ALIGN 64
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A batch of cubes in structure-of-arrays layout.
+**
+**  The stickers are stored by plane: plane i holds sticker i of every cube
+**  of the batch, one byte per cube, and the cube of lane k is byte k of each
+**  plane. The stickers are numbered as in a packed cube
+**  (CUBE_PACKED_INDEX()).
+**
+**  A turn of the same layer in every cube moves whole planes, so it is one
+**  pass over the planes of the layer that the compiler vectorizes. Each lane
+**  can also take a turn of its own, in which case every plane a turn moves
+**  is blended from its source plane in the lanes of the turn.
+*/
+typedef struct
+CubeBatch_t{
+        /// Sticker planes (CubeColor_t), CUBE_PACKED_STICKERS*stride bytes.
+        uint8_t *sticker;
+        /// Second set of planes, where the lanes turned one by one are built.
+        uint8_t *spare;
+        /// The turn of each lane, one byte per lane.
+        uint8_t *lane;
+        /// The allocation of the planes.
+        void *memory;
+        /// Number of cubes.
+        uint32_t count;
+        /// Bytes per plane, the number of cubes rounded up to
+        /// CUBE_BATCH_ALIGN. The lanes after the cubes are reset cubes.
+        uint32_t stride;
+} CubeBatch_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Allocates a batch of reset cubes.
+**
+**  @param[out] batch A pointer to a batch.
+**  @param[in] count Number of cubes, for example 1024.
+**
+**  @retval true The batch was allocated.
+**  @retval false The count is zero, or out of memory.
+*/
+bool
+cube_batch_init(
+        CubeBatch_t *batch,
+        uint32_t count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Frees a batch.
+**
+**  @param[in] batch A pointer to a batch.
+*/
+void
+cube_batch_free(
+        CubeBatch_t *batch
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Resets every cube of a batch.
+**
+**  @param[in] batch A pointer to a batch.
+*/
+void
+cube_batch_reset(
+        CubeBatch_t *batch
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Copies the blocks of a cube to a lane.
+**
+**  @param[in] batch A pointer to a batch.
+**  @param[in] lane A lane (0 - count-1).
+**  @param[in] cube A pointer to the cube to copy.
+*/
+void
+cube_batch_set_cube(
+        CubeBatch_t *batch,
+        uint32_t lane,
+        Cube_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Copies the blocks of a lane to a cube.
+**
+**  The colors of the cube are counted again. The row and column cursors
+**  are left untouched.
+**
+**  @param[in] batch A pointer to a batch.
+**  @param[in] lane A lane (0 - count-1).
+**  @param[out] cube A pointer to the destination cube.
+*/
+void
+cube_batch_get_cube(
+        CubeBatch_t *batch,
+        uint32_t lane,
+        Cube_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns the same layer of every cube.
+**
+**  The same as cube_turn() for each cube.
+**
+**  @param[in] batch A pointer to a batch.
+**  @param[in] axis Axis of the layer.
+**  @param[in] layer Index of the layer along the axis (0 - CUBE_SIZE-1).
+**  @param[in] turns Quarter turns in the positive direction of the axis
+**                   (1-3). 0 leaves the cubes as they are.
+*/
+void
+cube_batch_turn(
+        CubeBatch_t *batch,
+        CubeAxis_t axis,
+        uint8_t layer,
+        uint8_t turns
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies a sequence of moves to every cube.
+**
+**  Layers beyond the cube size are ignored.
+**
+**  @param[in] batch A pointer to a batch.
+**  @param[in] moves Moves to apply.
+**  @param[in] count Number of moves.
+*/
+void
+cube_batch_apply_moves(
+        CubeBatch_t *batch,
+        CubeMove_t *moves,
+        uint32_t count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies a sequence of outer layer turns to every cube.
+**
+**  @param[in] batch A pointer to a batch.
+**  @param[in] turns Turns to apply.
+**  @param[in] count Number of turns.
+*/
+void
+cube_batch_apply_turns(
+        CubeBatch_t *batch,
+        CubeTurn_t *turns,
+        uint32_t count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies an outer layer turn of its own to each cube.
+**
+**  The planes each turn moves are blended from their source planes in the
+**  lanes of the turn, a block of CUBE_BATCH_ALIGN lanes at a time. The cost
+**  grows with the number of different turns in a block, up to
+**  CUBE_TURN_COUNT times the cost of turning every cube the same way. When
+**  all cubes take the same turn, it is made as with cube_batch_apply_turns().
+**
+**  @param[in] batch A pointer to a batch.
+**  @param[in] turns A turn for each cube, count turns. A value of
+**                   CUBE_TURN_COUNT or more leaves the cube as it is.
+*/
+void
+cube_batch_turn_lanes(
+        CubeBatch_t *batch,
+        CubeTurn_t *turns
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks which cubes are solved.
+**
+**  The stickers are not counted by the turns, so the check compares every
+**  plane of a face with the first one, for all cubes at once.
+**
+**  @param[in] batch A pointer to a batch.
+**  @param[out] solved A flag for each cube, count flags, or NULL.
+**
+**  @return Number of solved cubes.
+*/
+uint32_t
+cube_batch_count_solved(
+        CubeBatch_t *batch,
+        bool *solved
+);
+
+#endif // ifndef rubics_cube_batch_H
+
+/* EOF */
\ No newline at end of file
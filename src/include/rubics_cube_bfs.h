@@ -0,0 +1,146 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_bfs.h
+**  @ingroup    rubicscube
+**  @brief      Breadth-first enumeration of the 2x2x2 positions.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_bfs_H
+#define rubics_cube_bfs_H
+
+#include "rubics_cube.h"
+
+#if CUBE_SIZE==2
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Number of positions of the 2x2x2 cube with the bottom, back, left corner
+///fixed.
+#define CUBE_BFS_STATE_COUNT 3674160
+
+/// Number of distances counted. The largest distance is 11 half turn metric
+///moves and 14 quarter turns.
+#define CUBE_BFS_DEPTH_COUNT 32
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Breadth-first enumeration of the 2x2x2 positions.
+**
+**  Starting from the reset cube, all positions are visited in the order of
+**  their distance with the turns of the top, right and front sides, which
+**  keep the bottom, back, left corner in place. The number of positions at
+**  each distance is a known distribution, so it checks the turns of the
+**  cube.
+**
+**  The visited positions are a bit set of 460 kB shared by the threads. The
+**  positions of a distance are kept in frontier files, one per thread,
+**  which are written and read sequentially in blocks and removed when the
+**  next distance is done. The threads take the blocks of the frontier in
+**  turn, and each new position is found by exactly one thread.
+*/
+typedef struct
+CubeBfs_t{
+        /// Directory of the frontier files, NULL for the working directory.
+        char *directory;
+        /// Number of threads.
+        uint32_t threadCount;
+        /// Count the quarter turns, a half turn is not a move.
+        bool quarterTurns;
+        /// Turn the cubes with the layer turns of Cube_t instead of the
+        /// packed turn engine.
+        bool layerTurns;
+        /// Number of positions at each distance.
+        uint32_t count[CUBE_BFS_DEPTH_COUNT];
+        /// The largest distance.
+        uint8_t depth;
+        /// Number of positions found.
+        uint32_t total;
+        /// Number of turned cubes that were not valid, 0 unless the turns
+        /// are broken.
+        uint32_t invalid;
+} CubeBfs_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Initializes an enumeration.
+**
+**  The frontier files are written to the working directory by a thread for
+**  each processor, in the half turn metric with the packed turn engine.
+**
+**  @param[out] bfs A pointer to an enumeration.
+*/
+void
+cube_bfs_init(
+        CubeBfs_t *bfs
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Enumerates the positions.
+**
+**  @param[in,out] bfs A pointer to an initialized enumeration. The counts
+**                     are set.
+**
+**  @retval true All positions were enumerated. The total is
+**               CUBE_BFS_STATE_COUNT if the turns are correct.
+**  @retval false Out of memory, a frontier file could not be written or
+**                read, or the distances exceeded CUBE_BFS_DEPTH_COUNT.
+*/
+bool
+cube_bfs_run(
+        CubeBfs_t *bfs
+);
+
+#endif // if CUBE_SIZE==2
+
+#endif // ifndef rubics_cube_bfs_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,451 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_cubie.h
+**  @ingroup    rubicscube
+**  @brief      Cubie level model of a 3x3x3 Rubic's cube.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_cubie_H
+#define rubics_cube_cubie_H
+
+#include "rubics_cube_packed.h"
+#include "rubics_cube_random.h"
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Corner positions and cubies.
+*/
+typedef enum
+CubeCorner_t{
+        /// Top, right, front.
+        CUBE_CORNER_URF=0,
+        /// Top, front, left.
+        CUBE_CORNER_UFL,
+        /// Top, left, back.
+        CUBE_CORNER_ULB,
+        /// Top, back, right.
+        CUBE_CORNER_UBR,
+        /// Bottom, front, right.
+        CUBE_CORNER_DFR,
+        /// Bottom, left, front.
+        CUBE_CORNER_DLF,
+        /// Bottom, back, left.
+        CUBE_CORNER_DBL,
+        /// Bottom, right, back.
+        CUBE_CORNER_DRB,
+        /// Corner count.
+        CUBE_CORNER_COUNT
+} CubeCorner_t;
+
+/**
+**  @brief Edge positions and cubies.
+*/
+typedef enum
+CubeEdge_t{
+        /// Top, right.
+        CUBE_EDGE_UR=0,
+        /// Top, front.
+        CUBE_EDGE_UF,
+        /// Top, left.
+        CUBE_EDGE_UL,
+        /// Top, back.
+        CUBE_EDGE_UB,
+        /// Bottom, right.
+        CUBE_EDGE_DR,
+        /// Bottom, front.
+        CUBE_EDGE_DF,
+        /// Bottom, left.
+        CUBE_EDGE_DL,
+        /// Bottom, back.
+        CUBE_EDGE_DB,
+        /// Front, right.
+        CUBE_EDGE_FR,
+        /// Front, left.
+        CUBE_EDGE_FL,
+        /// Back, left.
+        CUBE_EDGE_BL,
+        /// Back, right.
+        CUBE_EDGE_BR,
+        /// Edge count.
+        CUBE_EDGE_COUNT
+} CubeEdge_t;
+
+/**
+**  @brief A 3x3x3 cube on the cubie level.
+**
+**  The state is given as the cubie in each corner and edge position and its
+**  orientation. Corner orientation is the number of clockwise twists (0-2)
+**  of the top or bottom colored sticker from the top or bottom face, and edge
+**  orientation is 1 when the edge is flipped. The centers are fixed.
+*/
+typedef struct
+CubeCubie_t{
+        /// Corner permutation (CubeCorner_t).
+        uint8_t cp[CUBE_CORNER_COUNT];
+        /// Corner orientation.
+        uint8_t co[CUBE_CORNER_COUNT];
+        /// Edge permutation (CubeEdge_t).
+        uint8_t ep[CUBE_EDGE_COUNT];
+        /// Edge orientation.
+        uint8_t eo[CUBE_EDGE_COUNT];
+} CubeCubie_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Resets a cubie level cube to the solved state.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+*/
+void
+cube_cubie_reset(
+        CubeCubie_t *cubie
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns an outer layer of a cubie level cube.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**  @param[in] turn A turn to apply.
+*/
+void
+cube_cubie_turn(
+        CubeCubie_t *cubie,
+        CubeTurn_t turn
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Multiplies two cubie level cubes.
+**
+**  The result is the state reached by applying the moves of b after the
+**  moves of a. The result must not point to either of the operands.
+**
+**  Either operand may also be a symmetry of the cube with mirrored corners,
+**  which have the orientations 3-5.
+**
+**  @param[in] a A pointer to the first operand.
+**  @param[in] b A pointer to the second operand.
+**  @param[out] result A pointer to the product.
+*/
+void
+cube_cubie_multiply(
+        CubeCubie_t *a,
+        CubeCubie_t *b,
+        CubeCubie_t *result
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Inverts a cubie level cube.
+**
+**  The result is the state reached by applying the moves of the cube in
+**  reverse. The result must not point to the cube.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**  @param[out] result A pointer to the inverse.
+*/
+void
+cube_cubie_inverse(
+        CubeCubie_t *cubie,
+        CubeCubie_t *result
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if a cubie level cube is solved.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**
+**  @retval true Cube is solved.
+**  @retval false Cube is not solved.
+*/
+bool
+cube_cubie_is_solved(
+        CubeCubie_t *cubie
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if a cubie level cube can be reached with legal moves.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**
+**  @retval true Every cubie is present once, the twist and flip sums are
+**               zero and the corner and edge permutations have equal parity.
+**  @retval false The state is not reachable.
+*/
+bool
+cube_cubie_is_valid(
+        CubeCubie_t *cubie
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets a uniformly random reachable state.
+**
+**  Every one of the 43252003274489856000 reachable states is equally likely.
+**  The state is drawn directly in constant time, without turns.
+**
+**  @param[out] cubie A pointer to a cubie level cube.
+**  @param[in,out] random A pointer to a random number generator.
+*/
+void
+cube_cubie_random(
+        CubeCubie_t *cubie,
+        CubeRandom_t *random
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the corner orientation coordinate.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**
+**  @return The orientations of the first seven corners as a base 3 number
+**          (0-2186). The last orientation follows from the others.
+*/
+uint16_t
+cube_cubie_get_twist(
+        CubeCubie_t *cubie
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets the corner orientations from their coordinate.
+**
+**  @param[out] cubie A pointer to a cubie level cube.
+**  @param[in] twist The corner orientation coordinate.
+*/
+void
+cube_cubie_set_twist(
+        CubeCubie_t *cubie,
+        uint16_t twist
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the edge orientation coordinate.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**
+**  @return The orientations of the first eleven edges as a base 2 number
+**          (0-2047). The last orientation follows from the others.
+*/
+uint16_t
+cube_cubie_get_flip(
+        CubeCubie_t *cubie
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets the edge orientations from their coordinate.
+**
+**  @param[out] cubie A pointer to a cubie level cube.
+**  @param[in] flip The edge orientation coordinate.
+*/
+void
+cube_cubie_set_flip(
+        CubeCubie_t *cubie,
+        uint16_t flip
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the rank of a permutation.
+**
+**  @param[in] p A permutation of the numbers 0 - n-1.
+**  @param[in] n Length of the permutation (8 at most).
+**
+**  @return The lexicographic rank, 0 for the identity.
+*/
+uint16_t
+cube_cubie_get_permutation(
+        uint8_t *p,
+        uint8_t n
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets a permutation from its rank.
+**
+**  @param[out] p A permutation of the numbers 0 - n-1.
+**  @param[in] n Length of the permutation (8 at most).
+**  @param[in] rank The lexicographic rank.
+*/
+void
+cube_cubie_set_permutation(
+        uint8_t *p,
+        uint8_t n,
+        uint16_t rank
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the middle layer edge coordinate.
+**
+**  The coordinate is the set of positions of the FR, FL, BL and BR edges
+**  times 24 plus their order. It is below 24 when the edges are in the
+**  middle layer.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**
+**  @return The coordinate (0-11879).
+*/
+uint16_t
+cube_cubie_get_slice(
+        CubeCubie_t *cubie
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets the edge permutation from the middle layer edge coordinate.
+**
+**  The other edges are placed in order to the remaining positions.
+**
+**  @param[out] cubie A pointer to a cubie level cube.
+**  @param[in] slice The middle layer edge coordinate.
+*/
+void
+cube_cubie_set_slice(
+        CubeCubie_t *cubie,
+        uint16_t slice
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Converts the corners of a cube of any size to the cubie level.
+**
+**  The faces are identified by the colors of the bottom, back, left corner,
+**  which therefore is always in place. The edges are set solved and the
+**  permutation parity is not checked, so the result suits a 2x2x2 cube.
+**
+**  @param[out] cubie A pointer to a cubie level cube.
+**  @param[in] cube A pointer to a cube.
+**
+**  @retval true Conversion succeeded.
+**  @retval false The corner stickers do not form a valid cube.
+*/
+bool
+cube_cubie_from_cube_corners(
+        CubeCubie_t *cubie,
+        Cube_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Converts the corners of a packed cube of any size to the cubie
+**         level.
+**
+**  The same as cube_cubie_from_cube_corners() for a packed cube.
+**
+**  @param[out] cubie A pointer to a cubie level cube.
+**  @param[in] packed A pointer to a packed cube.
+**
+**  @retval true Conversion succeeded.
+**  @retval false The corner stickers do not form a valid cube.
+*/
+bool
+cube_cubie_from_packed_corners(
+        CubeCubie_t *cubie,
+        CubePacked_t *packed
+);
+
+#if CUBE_SIZE==3
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Converts a packed cube to the cubie level.
+**
+**  The faces are identified by the colors of their centers, so the whole
+**  cube may be in any orientation.
+**
+**  @param[out] cubie A pointer to a cubie level cube.
+**  @param[in] packed A pointer to a packed cube.
+**
+**  @retval true Conversion succeeded.
+**  @retval false The stickers do not form a valid cube.
+*/
+bool
+cube_cubie_from_packed(
+        CubeCubie_t *cubie,
+        CubePacked_t *packed
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Converts a cubie level cube to a packed cube.
+**
+**  The faces get the colors of a reset cube.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**  @param[out] packed A pointer to a packed cube.
+*/
+void
+cube_cubie_to_packed(
+        CubeCubie_t *cubie,
+        CubePacked_t *packed
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Converts a cube to the cubie level.
+**
+**  @param[out] cubie A pointer to a cubie level cube.
+**  @param[in] cube A pointer to a cube.
+**
+**  @retval true Conversion succeeded.
+**  @retval false The stickers do not form a valid cube.
+*/
+bool
+cube_cubie_from_cube(
+        CubeCubie_t *cubie,
+        Cube_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Converts a cubie level cube to a cube.
+**
+**  The faces get the colors of a reset cube. The row and column cursors of
+**  the destination cube are left untouched.
+**
+**  @param[in] cubie A pointer to a cubie level cube.
+**  @param[out] cube A pointer to a cube.
+*/
+void
+cube_cubie_to_cube(
+        CubeCubie_t *cubie,
+        Cube_t *cube
+);
+
+#endif // if CUBE_SIZE==3
+
+#endif // ifndef rubics_cube_cubie_H
+
+/* EOF */
\ No newline at end of file
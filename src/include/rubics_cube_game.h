@@ -45,6 +45,8 @@
 
 #include "rubics_cube.h"
 
+#include <time.h>
+
 /******************************************************************************\
 **
 **  TYPE DEFINITIONS
@@ -188,6 +190,52 @@ CubeGameInput_t{
         CubeGame_Input_Get_t funcGet;
 } CubeGameInput_t;
 
+/******************************************************************************\
+**
+**  GAME RECORDER INTERFACE DEFINITION
+**
+\******************************************************************************/
+
+/**
+**  @brief Starts recording a game.
+**
+**  @param[in] context The context given with the interface.
+**  @param[in] seed The seed of the shuffles of the game.
+*/
+typedef void
+(*CubeGame_Recorder_Start_t)(
+        void *context,
+        uint64_t seed
+);
+
+/**
+**  @brief Records a control.
+**
+**  @param[in] context The context given with the interface.
+**  @param[in] control A control applied to the game.
+*/
+typedef void
+(*CubeGame_Recorder_Record_t)(
+        void *context,
+        CubeGameControl_t control
+);
+
+/**
+**  @brief Game recorder interface.
+**
+**  A recorder has a context, so several games can be recorded at the same
+**  time.
+*/
+typedef struct
+CubeGameRecorder_t{
+        /// Starts recording, or NULL if the game is not recorded.
+        CubeGame_Recorder_Start_t funcStart;
+        /// Records a control, or NULL if the game is not recorded.
+        CubeGame_Recorder_Record_t funcRecord;
+        /// Context of the recorder functions.
+        void *context;
+} CubeGameRecorder_t;
+
 /******************************************************************************\
 **
 **  GAME TYPE DEFINITION
@@ -203,12 +251,17 @@ CubeGame_t{
         CubeGameGraphics_t graphics;
         /// A pointer to an input driver.
         CubeGameInput_t input;
+        /// A recorder of the controls. A game not set up with a recorder
+        /// must be zero-initialized.
+        CubeGameRecorder_t recorder;
         /// Turn counter.
         uint32_t turns;
         /// Time counter.
         time_t time;
         /// Rubic's cube.
         Cube_t cube;
+        /// Random number generator of the shuffles.
+        CubeRandom_t random;
         /// Solved state.
         bool isSolved;
 } CubeGame_t;
@@ -251,9 +304,32 @@ cube_game_setup_input_interface(
         CubeGame_Input_Get_t funcGet
 );
 
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets up a recorder interface.
+**
+**  The recorder is started when the game is initialized, and gets every
+**  control of the game except GAME_CONTROL_UNKNOWN.
+**
+**  @param[in] game A pointer to a game instance.
+**  @param[in] funcStart A recorder function pointer, or NULL.
+**  @param[in] funcRecord A recorder function pointer, or NULL.
+**  @param[in] context Context given to the recorder functions.
+*/
+void
+cube_game_setup_recorder_interface(
+        CubeGame_t *game,
+        CubeGame_Recorder_Start_t funcStart,
+        CubeGame_Recorder_Record_t funcRecord,
+        void *context
+);
+
 /*-------------------------------------------------------------------------*//**
 **  @brief Initializes a game.
 **
+**  The shuffles are seeded with the current time. The game must be
+**  zero-initialized, like a static one, unless it is set up with a
+**  recorder.
+**
 **  @param[in] game A pointer to a game instance.
 */
 void
@@ -261,6 +337,22 @@ cube_game_init(
         CubeGame_t *game
 );
 
+/*-------------------------------------------------------------------------*//**
+**  @brief Initializes a game with a seed of the shuffles.
+**
+**  Games with the same seed and the same controls end in the same state.
+**  The game must be zero-initialized, like a static one, unless it is set
+**  up with a recorder.
+**
+**  @param[in] game A pointer to a game instance.
+**  @param[in] seed A seed of the shuffles.
+*/
+void
+cube_game_init_with_seed(
+        CubeGame_t *game,
+        uint64_t seed
+);
+
 /*-------------------------------------------------------------------------*//**
 **  @brief Runs a game.
 **
@@ -0,0 +1,171 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_headless.h
+**  @ingroup    rubicscube
+**  @brief      Headless game driver for replaying controls.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_headless_H
+#define rubics_cube_headless_H
+
+#include "rubics_cube_game.h"
+#include "rubics_cube_log.h"
+
+#include <stdio.h>
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Size of the buffer of a file stream in bytes.
+#define CUBE_GAME_STREAM_BUFFER_SIZE 4096
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A stream of game controls.
+**
+**  Each control is one byte, the value of a CubeGameControl_t. The controls
+**  are read from memory, or from a file through a buffer. They can also be
+**  decoded from a session of a log.
+*/
+typedef struct
+CubeGameStream_t{
+        /// Controls in memory, or the buffered controls of the file.
+        const uint8_t *data;
+        /// Number of controls in data.
+        size_t size;
+        /// Index of the next control in data.
+        size_t position;
+        /// A file to read the controls from, or NULL.
+        FILE *file;
+        /// A log to read the controls from, or NULL.
+        CubeLogReader_t *log;
+        /// Buffer of a file stream.
+        uint8_t buffer[CUBE_GAME_STREAM_BUFFER_SIZE];
+} CubeGameStream_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets up a stream of controls in memory.
+**
+**  The controls are not copied, so they must stay valid while the stream is
+**  read.
+**
+**  @param[out] stream A pointer to a stream.
+**  @param[in] controls Controls, one byte each.
+**  @param[in] count Number of controls.
+*/
+void
+cube_game_stream_memory(
+        CubeGameStream_t *stream,
+        const uint8_t *controls,
+        size_t count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets up a stream of controls read from a file.
+**
+**  The file is read from its current position to the end. It is not closed.
+**
+**  @param[out] stream A pointer to a stream.
+**  @param[in] file A file opened for binary reading.
+*/
+void
+cube_game_stream_file(
+        CubeGameStream_t *stream,
+        FILE *file
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets up a stream of the controls of a log session.
+**
+**  The controls are decoded from the log as they are read, from the session
+**  last read with cube_log_reader_next_session(). Replay the session with
+**  its seed, and only if its size is CUBE_SIZE.
+**
+**  @param[out] stream A pointer to a stream.
+**  @param[in] log A pointer to a log reader.
+*/
+void
+cube_game_stream_log(
+        CubeGameStream_t *stream,
+        CubeLogReader_t *log
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Runs a game without graphics, reading the controls from a stream.
+**
+**  The game runs until the stream ends or gives GAME_CONTROL_EXIT. Nothing
+**  waits for a key or draws, so a session replays at full speed. The final
+**  state is left in the game: compare cube_get_hash() of the cube, the turn
+**  count or the solved state with the recorded ones.
+**
+**  The game is cleared first, so it need not be initialized, and it has no
+**  recorder.
+**
+**  Each thread can run a game of its own at the same time.
+**
+**  @param[in] game A pointer to a game.
+**  @param[in] seed A seed of the shuffles, as given to
+**                  cube_game_init_with_seed().
+**  @param[in] stream A pointer to a stream of controls.
+**
+**  @return Number of controls read, GAME_CONTROL_EXIT included.
+*/
+uint64_t
+cube_game_headless_run(
+        CubeGame_t *game,
+        uint64_t seed,
+        CubeGameStream_t *stream
+);
+
+#endif // ifndef rubics_cube_headless_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,322 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_log.h
+**  @ingroup    rubicscube
+**  @brief      Compact binary logs of game sessions.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_log_H
+#define rubics_cube_log_H
+
+#include "rubics_cube_game.h"
+
+#include <stdio.h>
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Size of the buffer of a log writer in bytes.
+#define CUBE_LOG_BUFFER_SIZE 4096
+
+/// Identifier at the start of a session.
+#define CUBE_LOG_MAGIC "RCLG"
+
+/// Version of the log format.
+#define CUBE_LOG_VERSION 1
+
+/// Size of a session header in bytes.
+#define CUBE_LOG_HEADER_SIZE 22
+
+/// The largest size of a control record in bytes.
+#define CUBE_LOG_RECORD_MAX_SIZE 11
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A log writer.
+**
+**  A log is a sequence of sessions. A session is a header followed by its
+**  control records, and ends with a GAME_CONTROL_EXIT record. The header is:
+**
+**  - CUBE_LOG_MAGIC, 4 bytes.
+**  - CUBE_LOG_VERSION, 1 byte.
+**  - The cube size, 1 byte.
+**  - The seed of the shuffles, 8 bytes, least significant byte first.
+**  - The start time in seconds since the epoch, 8 bytes, least significant
+**    byte first.
+**
+**  A record holds a control and the milliseconds since the previous record
+**  (or the start of the session). Its first byte has the control in bits
+**  0-3, the lowest 3 bits of the time in bits 4-6, and bit 7 set if more
+**  bytes follow. The rest of the time follows in 7 bits per byte, least
+**  significant bits first, with bit 7 set in all but the last byte. A
+**  control made within 8 ms takes one byte, and within 1 s two bytes.
+**
+**  No record holds the first byte of CUBE_LOG_MAGIC: a record that would end
+**  with it gets one more byte of zero time bits. So a session cut off
+**  without its GAME_CONTROL_EXIT record, as when the game is killed, ends
+**  where the next session starts, and no later session is lost.
+**
+**  Records go to a buffer, which is written to the file when it is full and
+**  when a session ends. The file is opened for appending, so new sessions
+**  follow the old ones.
+*/
+typedef struct
+CubeLogWriter_t{
+        /// The log file.
+        FILE *file;
+        /// Clock time of the previous record in milliseconds.
+        uint64_t time;
+        /// A session has been started and not ended.
+        bool isInSession;
+        /// Number of bytes in the buffer.
+        size_t length;
+        /// Buffer of records.
+        uint8_t buffer[CUBE_LOG_BUFFER_SIZE];
+} CubeLogWriter_t;
+
+/**
+**  @brief A session of a log.
+*/
+typedef struct
+CubeLogSession_t{
+        /// The seed of the shuffles.
+        uint64_t seed;
+        /// The start time in seconds since the epoch.
+        int64_t startTime;
+        /// The cube size. A session can be replayed only with the same
+        /// CUBE_SIZE.
+        uint8_t size;
+} CubeLogSession_t;
+
+/**
+**  @brief A log reader.
+**
+**  The records are decoded straight from a log in memory, usually a file
+**  mapped to memory, without copying.
+*/
+typedef struct
+CubeLogReader_t{
+        /// The log.
+        const uint8_t *data;
+        /// Size of the log in bytes.
+        size_t size;
+        /// Index of the next byte to decode.
+        size_t position;
+        /// Milliseconds from the start of the session to the last record.
+        uint64_t time;
+        /// The records of a session are being read.
+        bool isInSession;
+        /// The log is a mapped file.
+        bool isMapped;
+#if defined(_WIN32)
+        /// Handle of the mapping.
+        void *mapping;
+#endif
+} CubeLogReader_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Opens a log file for writing.
+**
+**  The file is created, or opened for appending new sessions.
+**
+**  @param[out] writer A pointer to a writer.
+**  @param[in] path Path of the log file.
+**
+**  @retval true The file was opened.
+**  @retval false The file could not be opened.
+*/
+bool
+cube_log_writer_open(
+        CubeLogWriter_t *writer,
+        const char *path
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Ends the session being written and closes a log file.
+**
+**  @param[in] writer A pointer to a writer.
+**
+**  @retval true The log was written.
+**  @retval false A write error occurred.
+*/
+bool
+cube_log_writer_close(
+        CubeLogWriter_t *writer
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Starts a session.
+**
+**  A session being written is ended first.
+**
+**  @param[in] writer A pointer to a writer.
+**  @param[in] seed The seed of the shuffles of the game.
+*/
+void
+cube_log_writer_start(
+        CubeLogWriter_t *writer,
+        uint64_t seed
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Records a control in the session.
+**
+**  GAME_CONTROL_EXIT ends the session. Controls outside a session and
+**  GAME_CONTROL_UNKNOWN are not recorded.
+**
+**  @param[in] writer A pointer to a writer.
+**  @param[in] control A control.
+*/
+void
+cube_log_writer_record(
+        CubeLogWriter_t *writer,
+        CubeGameControl_t control
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Records the sessions of a game to a log.
+**
+**  Sets the writer up as the recorder of the game.
+**
+**  @param[in] writer A pointer to an open writer.
+**  @param[in] game A pointer to a game.
+*/
+void
+cube_log_writer_attach(
+        CubeLogWriter_t *writer,
+        CubeGame_t *game
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Opens a log file for reading.
+**
+**  The file is mapped to memory.
+**
+**  @param[out] reader A pointer to a reader.
+**  @param[in] path Path of the log file.
+**
+**  @retval true The file was opened.
+**  @retval false The file could not be opened or mapped.
+*/
+bool
+cube_log_reader_open(
+        CubeLogReader_t *reader,
+        const char *path
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets up a reader of a log in memory.
+**
+**  The log is not copied, so it must stay valid while it is read.
+**
+**  @param[out] reader A pointer to a reader.
+**  @param[in] data The log.
+**  @param[in] size Size of the log in bytes.
+*/
+void
+cube_log_reader_memory(
+        CubeLogReader_t *reader,
+        const uint8_t *data,
+        size_t size
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Closes a log reader.
+**
+**  @param[in] reader A pointer to a reader.
+*/
+void
+cube_log_reader_close(
+        CubeLogReader_t *reader
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Reads the header of the next session.
+**
+**  The records left in the current session are skipped, and so are bytes
+**  that do not start a valid header, up to the next header.
+**
+**  @param[in] reader A pointer to a reader.
+**  @param[out] session A pointer to the session header.
+**
+**  @retval true A session was read.
+**  @retval false The log ended, or the header is not valid.
+*/
+bool
+cube_log_reader_next_session(
+        CubeLogReader_t *reader,
+        CubeLogSession_t *session
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Reads the next control of the session.
+**
+**  @param[in] reader A pointer to a reader.
+**  @param[out] control A pointer to the control.
+**  @param[out] time A pointer to the milliseconds from the start of the
+**                   session to the control, or NULL.
+**
+**  @retval true A control was read. The last control of a session is
+**               GAME_CONTROL_EXIT, unless the session was cut off.
+**  @retval false The session or the log ended, or the next session
+**                starts.
+*/
+bool
+cube_log_reader_next_control(
+        CubeLogReader_t *reader,
+        CubeGameControl_t *control,
+        uint64_t *time
+);
+
+#endif // ifndef rubics_cube_log_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,148 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_notation.h
+**  @ingroup    rubicscube
+**  @brief      Move notation parser and formatter.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_notation_H
+#define rubics_cube_notation_H
+
+#include "rubics_cube.h"
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Parses a move sequence.
+**
+**  The text is written in the standard notation. The moves are separated by
+**  white space, which may also be left out:
+**
+**  - U, D, F, B, L and R turn an outer layer.
+**  - Uw or u turns two outer layers, and 3Uw or 3u three outer layers.
+**  - 2U turns the second layer from the top side only.
+**  - M, E and S turn all inner layers (cube size 3 or more).
+**  - x, y and z turn the whole cube.
+**
+**  Each move may be followed by a number of quarter turns and a prime (')
+**  for the counter-clockwise direction, as in R2 or U'. Moves of zero turns
+**  are left out.
+**
+**  @param[in] text A null-terminated move sequence.
+**  @param[out] moves A buffer for the moves.
+**  @param[in] capacity Number of moves the buffer holds.
+**  @param[out] count Number of moves parsed.
+**
+**  @retval true The whole text was parsed.
+**  @retval false The text has an invalid move, or the buffer is too small.
+**                The count tells the moves parsed before the error.
+*/
+bool
+cube_notation_parse(
+        char *text,
+        CubeMove_t *moves,
+        uint32_t capacity,
+        uint32_t *count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Simplifies a move sequence.
+**
+**  Adjacent moves of the same axis are merged, and the ones cancelling each
+**  other are removed. The resulting sequence turns the cube the same way and
+**  is never longer than the original.
+**
+**  @param[in,out] moves Moves to simplify.
+**  @param[in] count Number of moves.
+**
+**  @return Number of moves after simplification.
+*/
+uint32_t
+cube_notation_simplify(
+        CubeMove_t *moves,
+        uint32_t count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Formats a move sequence in the standard notation.
+**
+**  A move of inner layers that has no name of its own is written as two
+**  wide moves.
+**
+**  @param[in] moves Moves to format.
+**  @param[in] count Number of moves.
+**  @param[out] text A buffer for the null-terminated text.
+**  @param[in] size Size of the buffer in characters.
+**
+**  @retval true The text was written.
+**  @retval false The buffer is too small.
+*/
+bool
+cube_notation_format(
+        CubeMove_t *moves,
+        uint32_t count,
+        char *text,
+        uint32_t size
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Formats a sequence of outer layer turns in the standard notation.
+**
+**  @param[in] turns Turns to format.
+**  @param[in] count Number of turns.
+**  @param[out] text A buffer for the null-terminated text.
+**  @param[in] size Size of the buffer in characters.
+**
+**  @retval true The text was written.
+**  @retval false The buffer is too small.
+*/
+bool
+cube_notation_format_turns(
+        CubeTurn_t *turns,
+        uint32_t count,
+        char *text,
+        uint32_t size
+);
+
+#endif // ifndef rubics_cube_notation_H
+
+/* EOF */
\ No newline at end of file
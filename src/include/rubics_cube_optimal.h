@@ -0,0 +1,252 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_optimal.h
+**  @ingroup    rubicscube
+**  @brief      Optimal solver for the 2x2x2 and 3x3x3 cubes.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_optimal_H
+#define rubics_cube_optimal_H
+
+#include "rubics_cube_cubie.h"
+#include "rubics_cube_table.h"
+
+#if CUBE_SIZE==2||CUBE_SIZE==3
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// The longest optimal solution of any position.
+#if CUBE_SIZE==2
+#define CUBE_OPTIMAL_MAX_LENGTH 11
+#else
+#define CUBE_OPTIMAL_MAX_LENGTH 20
+#endif
+
+/// Number of axes the 3x3x3 cube is looked at from.
+#define CUBE_OPTIMAL_AXIS_COUNT 3
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+#if CUBE_SIZE==3
+
+/**
+**  @brief Phase 1 coordinates of the cube looked at from one axis.
+*/
+typedef struct
+CubeOptimalAxis_t{
+        /// Corner orientation.
+        uint16_t twist;
+        /// Edge orientation.
+        uint16_t flip;
+        /// Middle layer edge positions.
+        uint16_t slice;
+} CubeOptimalAxis_t;
+
+#endif // if CUBE_SIZE==3
+
+/**
+**  @brief Optimal solver.
+**
+**  Finds the shortest solution in the face turn metric, where a half turn
+**  counts as one move.
+**
+**  The 2x2x2 cube is solved with an exact distance table of all 3674160
+**  positions, with the bottom, back, left corner fixed.
+**
+**  The 3x3x3 cube is solved with IDA*. The lower bound of the distance is
+**  the largest of a corner pattern database, and an edge orientation and
+**  middle layer edge pattern database combined with the corner orientation.
+**  The latter is the distance to the phase 1 subgroup of the two-phase
+**  solver, and it is looked at from all three axes. The edge table is
+**  reduced by the 16 symmetries that keep the vertical axis. The tables
+**  take about 120 MB.
+**
+**  All distances are stored in 4 bits per entry. The tables are only read by
+**  the searches, so one solver may be shared by any number of threads. A
+**  3x3x3 search may also be split to several threads, which share the
+**  tables and steal the subtrees of the first moves from each other.
+*/
+typedef struct
+CubeOptimal_t{
+        /// All tables in one block, the distance tables first.
+        CubeTable_t table;
+        /// Number of threads of one 3x3x3 search, 1 after the
+        /// initialization. Searches of 12 moves or more are split to the
+        /// threads.
+        uint32_t threadCount;
+        /// Corner orientation move table.
+        uint16_t *twistMove;
+        /// Corner permutation move table.
+        uint16_t *cornerMove;
+#if CUBE_SIZE==2
+        /// Distances of all positions.
+        uint8_t *distance;
+#else
+        /// Edge orientation move table.
+        uint16_t *flipMove;
+        /// Middle layer edge position move table.
+        uint16_t *sliceMove;
+        /// Class and symmetry of each edge orientation and middle layer edge
+        /// position, class*16+symmetry.
+        uint32_t *flipsliceClass;
+        /// Edge orientation and middle layer edge position of each class
+        /// representative.
+        uint32_t *flipsliceRep;
+        /// Symmetries that keep each class representative, one bit each.
+        uint16_t *flipsliceStab;
+        /// Corner orientations looked at through each symmetry.
+        uint16_t *twistConj;
+        /// Distances by the corners.
+        uint8_t *cornerPrune;
+        /// Distances by the phase 1 coordinates.
+        uint8_t *phase1Prune;
+        /// Symmetry to look at the cube from each axis.
+        CubeCubie_t axisSym[CUBE_OPTIMAL_AXIS_COUNT];
+        /// Inverse of the symmetry of each axis.
+        CubeCubie_t axisInv[CUBE_OPTIMAL_AXIS_COUNT];
+        /// Turns as seen from each axis.
+        uint8_t axisMove[CUBE_OPTIMAL_AXIS_COUNT][CUBE_TURN_COUNT];
+#endif
+} CubeOptimal_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Initializes an optimal solver.
+**
+**  The tables are mapped from a file, which takes milliseconds. If the file
+**  does not exist or does not match, the tables are generated and written to
+**  the file. For the 3x3x3 cube this takes about half a minute.
+**
+**  @param[out] optimal A pointer to an optimal solver.
+**  @param[in] path A path of the table file, or NULL to generate the tables
+**                  without a file.
+**
+**  @retval true The solver is ready.
+**  @retval false Out of memory.
+*/
+bool
+cube_optimal_init(
+        CubeOptimal_t *optimal,
+        char *path
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Frees the tables of an optimal solver.
+**
+**  @param[in] optimal A pointer to an optimal solver.
+*/
+void
+cube_optimal_free(
+        CubeOptimal_t *optimal
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Finds the shortest solution of a cubie level cube.
+**
+**  On the 2x2x2 cube only the corners are used, and the solution has only U,
+**  R and F turns.
+**
+**  On the 3x3x3 cube the search time grows about 13 times with each move of
+**  the solution. Positions of 16 moves are solved in seconds, while random
+**  positions, which mostly need 18 moves, take from minutes to half an hour.
+**
+**  @param[in] optimal A pointer to an optimal solver.
+**  @param[in] cubie A pointer to a cube to solve.
+**  @param[in] maxLength The longest accepted solution.
+**  @param[out] solution A buffer of CUBE_OPTIMAL_MAX_LENGTH turns for the
+**                       solution.
+**  @param[out] length Number of turns in the solution.
+**
+**  @retval true A solution was found.
+**  @retval false The cube is not valid, or it has no solution of the given
+**                length.
+*/
+bool
+cube_optimal_solve(
+        CubeOptimal_t *optimal,
+        CubeCubie_t *cubie,
+        uint8_t maxLength,
+        CubeTurn_t *solution,
+        uint8_t *length
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Finds the shortest solution of a cube.
+**
+**  The 3x3x3 faces are identified by the colors of their centers, and the
+**  2x2x2 faces by the colors of the bottom, back, left corner. The solution
+**  is checked by turning a copy of the cube.
+**
+**  @param[in] optimal A pointer to an optimal solver.
+**  @param[in] cube A pointer to a cube to solve.
+**  @param[in] maxLength The longest accepted solution.
+**  @param[out] solution A buffer of CUBE_OPTIMAL_MAX_LENGTH turns for the
+**                       solution.
+**  @param[out] length Number of turns in the solution.
+**
+**  @retval true A solution was found.
+**  @retval false The cube is not valid, or it has no solution of the given
+**                length.
+*/
+bool
+cube_optimal_solve_cube(
+        CubeOptimal_t *optimal,
+        Cube_t *cube,
+        uint8_t maxLength,
+        CubeTurn_t *solution,
+        uint8_t *length
+);
+
+#endif // if CUBE_SIZE==2||CUBE_SIZE==3
+
+#endif // ifndef rubics_cube_optimal_H
+
+/* EOF */
\ No newline at end of file
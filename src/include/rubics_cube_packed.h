@@ -0,0 +1,200 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_packed.h
+**  @ingroup    rubicscube
+**  @brief      Packed Rubic's cube representation.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_packed_H
+#define rubics_cube_packed_H
+
+#include "rubics_cube.h"
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Sticker count of a cube. Six sides, usable in preprocessor conditions.
+#define CUBE_PACKED_STICKERS (6*CUBE_SIZE*CUBE_SIZE)
+
+/// Size of a packed cube in bytes, rounded up to whole cache lines.
+#define CUBE_PACKED_BYTES (((CUBE_PACKED_STICKERS+63)/64)*64)
+
+/// Index of a sticker in a packed cube. The order of the stickers is the same
+///as the order of the blocks in the faces of Cube_t.
+#define CUBE_PACKED_INDEX(side,x,y) (((side)*CUBE_SIZE+(x))*CUBE_SIZE+(y))
+
+/// Alignment attribute for cache line aligned data.
+#if defined(_MSC_VER)
+#define CUBE_ALIGN(n) __declspec(align(n))
+#else
+#define CUBE_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Packed Rubic's cube.
+**
+**  Stores one byte per sticker in a cache line aligned block. A 3x3x3 cube
+**  fits into a single 64-byte cache line. The padding bytes after the
+**  stickers are always zero, so two packed cubes can be compared with
+**  memcmp().
+*/
+typedef struct
+CubePacked_t{
+        /// Sticker colors (CubeColor_t).
+        CUBE_ALIGN(64) uint8_t sticker[CUBE_PACKED_BYTES];
+} CubePacked_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Packs a cube.
+**
+**  @param[out] packed A pointer to a packed cube.
+**  @param[in] cube A pointer to a cube to pack.
+*/
+void
+cube_packed_from_cube(
+        CubePacked_t *packed,
+        Cube_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Unpacks a cube.
+**
+**  The row and column cursors of the destination cube are left untouched.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[out] cube A pointer to a cube where to unpack.
+*/
+void
+cube_packed_to_cube(
+        CubePacked_t *packed,
+        Cube_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Resets a packed cube.
+**
+**  @param[in] packed A pointer to a packed cube.
+*/
+void
+cube_packed_reset(
+        CubePacked_t *packed
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates the whole packed cube.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] dir Direction to rotate (up, down, left or right).
+*/
+void
+cube_packed_rotate(
+        CubePacked_t *packed,
+        CubeDirection_t dir
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates a row of a packed cube.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] row A row to rotate.
+**  @param[in] dir Direction to rotate (left or right).
+*/
+void
+cube_packed_rotate_row(
+        CubePacked_t *packed,
+        uint8_t row,
+        CubeDirection_t dir
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates a column of a packed cube.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] col A column to rotate.
+**  @param[in] dir Direction to rotate (up or down).
+*/
+void
+cube_packed_rotate_column(
+        CubePacked_t *packed,
+        uint8_t col,
+        CubeDirection_t dir
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates the front face of a packed cube.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] dir Direction to rotate (clockwise or counter-clockwise).
+*/
+void
+cube_packed_rotate_front_face(
+        CubePacked_t *packed,
+        CubeDirection_t dir
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if a packed cube is solved.
+**
+**  @param[in] packed A pointer to a packed cube.
+**
+**  @retval true Cube is solved.
+**  @retval false Cube is not solved.
+*/
+bool
+cube_packed_is_solved(
+        CubePacked_t *packed
+);
+
+#endif // ifndef rubics_cube_packed_H
+
+/* EOF */
\ No newline at end of file
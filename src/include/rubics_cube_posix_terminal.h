@@ -0,0 +1,88 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_posix_terminal.h
+**  @ingroup    rubicscube
+**  @brief      Rubic's cube graphics and input drivers for POSIX terminals.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_posix_terminal_H
+#define rubics_cube_posix_terminal_H
+
+#include "rubics_cube_game.h"
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Spacing between the faces in characters.
+#define FACE_SPACING 1
+
+/// Block size in characters.
+#define BLOCK_SIZE 3
+
+/// Size of the output buffer in bytes. A frame is composed in it and written
+/// to the terminal at once, so it holds a whole frame of the cube.
+#define TERMINAL_BUFFER_SIZE 16384
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Runs a Rubic's cube game in a POSIX terminal.
+**
+**  The terminal is switched to raw mode for the game and restored when the
+**  game exits. The output uses ANSI escape sequences.
+**
+**  @param[in] game A pointer to a game.
+**
+**  @retval true The game was run.
+**  @retval false The standard input or output is not a terminal.
+*/
+bool
+cube_game_posix_terminal_run(
+        CubeGame_t *game
+);
+
+#endif // ifndef rubics_cube_posix_terminal_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,165 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_random.h
+**  @ingroup    rubicscube
+**  @brief      Seedable random number generator.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_random_H
+#define rubics_cube_random_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief State of a random number generator.
+**
+**  The generator is xoshiro256**, which passes the statistical test suites
+**  and takes a few cycles per number. The same seed always gives the same
+**  numbers on every platform. The state is owned by the caller, so each
+**  thread uses a generator of its own without locking.
+*/
+typedef struct
+CubeRandom_t{
+        /// Generator state, never all zero.
+        uint64_t s[4];
+} CubeRandom_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Seeds a random number generator.
+**
+**  Any seed, also 0, gives a good state.
+**
+**  @param[out] random A pointer to a random number generator.
+**  @param[in] seed The seed.
+*/
+void
+cube_random_seed(
+        CubeRandom_t *random,
+        uint64_t seed
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Advances a random number generator by 2^128 numbers.
+**
+**  Threads get sequences that never overlap from one seed, when each thread
+**  copies the generator and jumps it once more than the previous thread.
+**
+**  @param[in,out] random A pointer to a random number generator.
+*/
+void
+cube_random_jump(
+        CubeRandom_t *random
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the next random number.
+**
+**  @param[in,out] random A pointer to a random number generator.
+**
+**  @return A uniformly distributed 64-bit number.
+*/
+static inline uint64_t
+cube_random_next(
+        CubeRandom_t *random
+)
+{
+        uint64_t *s;
+        uint64_t r;
+        uint64_t t;
+
+        s=random->s;
+        r=s[1]*5;
+        r=(r<<7|r>>57)*9;
+        t=s[1]<<17;
+        s[2]^=s[0];
+        s[3]^=s[1];
+        s[1]^=s[2];
+        s[0]^=s[3];
+        s[2]^=t;
+        s[3]=s[3]<<45|s[3]>>19;
+        return r;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets a random number below a limit.
+**
+**  The number is unbiased. It is taken from the high bits of a product,
+**  which needs no division in the common case.
+**
+**  @param[in,out] random A pointer to a random number generator.
+**  @param[in] limit The limit, at least 1.
+**
+**  @return A uniformly distributed number (0 - limit-1).
+*/
+static inline uint32_t
+cube_random_below(
+        CubeRandom_t *random,
+        uint32_t limit
+)
+{
+        uint64_t m;
+        uint32_t threshold;
+
+        m=(cube_random_next(random)>>32)*limit;
+        if((uint32_t)m<limit){
+                // The low part of the product is below 2^32 mod limit for
+                // the numbers that would be drawn too often.
+                threshold=(0-limit)%limit;
+                while((uint32_t)m<threshold){
+                        m=(cube_random_next(random)>>32)*limit;
+                }
+        }
+        return (uint32_t)(m>>32);
+}
+
+#endif // ifndef rubics_cube_random_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,159 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_simd.h
+**  @ingroup    rubicscube
+**  @brief      Vectorized turn engine for packed cubes.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_simd_H
+#define rubics_cube_simd_H
+
+#include "rubics_cube_packed.h"
+
+// The engine keeps a whole cube in one 64-byte vector, which fits the 2x2x2
+// and 3x3x3 cubes.
+#if CUBE_PACKED_BYTES==64
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Instruction set levels of the turn engine.
+*/
+typedef enum
+CubeSimdLevel_t{
+        /// Portable C.
+        CUBE_SIMD_SCALAR=0,
+        /// 128-bit byte shuffles (pshufb).
+        CUBE_SIMD_SSSE3,
+        /// 256-bit byte shuffles (vpshufb).
+        CUBE_SIMD_AVX2,
+        /// 512-bit byte permutation (vpermb).
+        CUBE_SIMD_AVX512_VBMI,
+        /// Level count.
+        CUBE_SIMD_LEVEL_COUNT
+} CubeSimdLevel_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Initializes the turn engine.
+**
+**  Builds the permutation tables and selects the best instruction set level
+**  supported by the processor. The engine initializes itself on the first
+**  turn, but the function should be called before starting threads that use
+**  it.
+*/
+void
+cube_simd_init(
+        void
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the selected instruction set level.
+**
+**  @return The instruction set level in use.
+*/
+CubeSimdLevel_t
+cube_simd_get_level(
+        void
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Selects an instruction set level.
+**
+**  @param[in] level An instruction set level.
+**
+**  @retval true The level is in use.
+**  @retval false The processor does not support the level.
+*/
+bool
+cube_simd_set_level(
+        CubeSimdLevel_t level
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns an outer layer of a packed cube.
+**
+**  The turn is applied as a single precomputed permutation of the 64-byte
+**  sticker block.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] turn A turn to apply.
+**
+**  @retval true The cube was turned.
+**  @retval false The turn is CUBE_TURN_COUNT or more. The cube is left as
+**                it is.
+*/
+bool
+cube_packed_turn(
+        CubePacked_t *packed,
+        CubeTurn_t turn
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies a sequence of turns to a packed cube.
+**
+**  The stickers are kept in vector registers for the whole sequence.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] turns Turns to apply.
+**  @param[in] count Number of turns.
+**
+**  @retval true The turns were applied.
+**  @retval false A turn is CUBE_TURN_COUNT or more. No turn is applied.
+*/
+bool
+cube_packed_turns(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+);
+
+#endif // if CUBE_PACKED_BYTES==64
+
+#endif // ifndef rubics_cube_simd_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,288 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_sized.h
+**  @ingroup    rubicscube
+**  @brief      Cubes of any size chosen at run time.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_sized_H
+#define rubics_cube_sized_H
+
+#include "rubics_cube.h"
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// The smallest and the largest size of a cube in blocks per side.
+#define CUBE_SIZED_MIN_SIZE 2
+#define CUBE_SIZED_MAX_SIZE 255
+
+/// The largest size with a turn kernel of its own. The loops of the kernels
+///have constant bounds, so they are unrolled.
+#define CUBE_SIZED_KERNEL_MAX_SIZE 7
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A cube of any size.
+**
+**  Unlike Cube_t, the size is chosen for each cube at run time, so one build
+**  serves all sizes. The stickers of all faces are one block of memory, one
+**  byte per sticker, face by face. A 255x255x255 cube takes 390 kB.
+**
+**  A face turn does not move the stickers of the face, it only adds to the
+**  rotation of the face, so turning a layer costs O(size) also for the
+**  outer layers. The stickers of a face are stored as the blocks of Cube_t
+**  with the face turned back by its rotation, and the blocks are read
+**  through the rotation.
+**
+**  The layers are turned by walking pointers along the stickers with fixed
+**  steps, so no index is computed per sticker. The sizes up to
+**  CUBE_SIZED_KERNEL_MAX_SIZE have kernels of their own.
+*/
+typedef struct
+CubeSized_t{
+        /// Sticker colors (CubeColor_t), CUBE_SIDE_COUNT*size*size bytes.
+        uint8_t *sticker;
+        /// Clockwise quarter turns of each face not applied to its stickers
+        /// (0-3).
+        uint8_t rotation[CUBE_SIDE_COUNT];
+        /// Size in blocks per side.
+        uint8_t size;
+} CubeSized_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Allocates a reset cube.
+**
+**  @param[out] cube A pointer to a cube.
+**  @param[in] size Size in blocks per side (CUBE_SIZED_MIN_SIZE -
+**                  CUBE_SIZED_MAX_SIZE).
+**
+**  @retval true The cube was allocated.
+**  @retval false The size is not valid, or out of memory.
+*/
+bool
+cube_sized_init(
+        CubeSized_t *cube,
+        uint32_t size
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Frees a cube.
+**
+**  @param[in] cube A pointer to a cube.
+*/
+void
+cube_sized_free(
+        CubeSized_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Resets a cube.
+**
+**  @param[in] cube A pointer to a cube.
+*/
+void
+cube_sized_reset(
+        CubeSized_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Copies a cube of the same size.
+**
+**  @param[in] src A pointer to the cube to copy.
+**  @param[out] dest A pointer to a cube of the same size.
+**
+**  @retval true The cube was copied.
+**  @retval false The sizes differ.
+*/
+bool
+cube_sized_copy(
+        CubeSized_t *src,
+        CubeSized_t *dest
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the color of a block.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] side A side.
+**  @param[in] x Column of the block, as the first index of the blocks of
+**               Cube_t.
+**  @param[in] y Row of the block.
+**
+**  @return The color.
+*/
+CubeColor_t
+cube_sized_get_block(
+        CubeSized_t *cube,
+        CubeSide_t side,
+        uint8_t x,
+        uint8_t y
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns one layer.
+**
+**  The same as cube_turn().
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] axis Axis of the layer.
+**  @param[in] layer Index of the layer along the axis (0 - size-1).
+**  @param[in] turns Quarter turns in the positive direction of the axis
+**                   (1-3). 0 leaves the cube as it is.
+*/
+void
+cube_sized_turn(
+        CubeSized_t *cube,
+        CubeAxis_t axis,
+        uint8_t layer,
+        uint8_t turns
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies a sequence of moves.
+**
+**  Layers beyond the cube size are ignored.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] moves Moves to apply.
+**  @param[in] count Number of moves.
+*/
+void
+cube_sized_apply_moves(
+        CubeSized_t *cube,
+        CubeMove_t *moves,
+        uint32_t count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies a sequence of outer layer turns.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] turns Turns to apply.
+**  @param[in] count Number of turns.
+*/
+void
+cube_sized_apply_turns(
+        CubeSized_t *cube,
+        CubeTurn_t *turns,
+        uint32_t count
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Shuffles a cube with random moves.
+**
+**  The moves are drawn like in cube_shuffle(), so a cube of CUBE_SIZE gets
+**  the same moves from the same generator state.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in,out] random A pointer to a random number generator.
+**  @param[in] length Number of moves, for example 10 times the size.
+*/
+void
+cube_sized_shuffle(
+        CubeSized_t *cube,
+        CubeRandom_t *random,
+        uint32_t length
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if a cube is solved.
+**
+**  The stickers are not counted by the turns, so the check reads the faces
+**  until a sticker differs.
+**
+**  @param[in] cube A pointer to a cube.
+**
+**  @retval true Cube is solved.
+**  @retval false Cube is not solved.
+*/
+bool
+cube_sized_is_solved(
+        CubeSized_t *cube
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Copies the blocks of a cube of CUBE_SIZE.
+**
+**  @param[out] cube A pointer to a cube.
+**  @param[in] src A pointer to the cube to copy.
+**
+**  @retval true The blocks were copied.
+**  @retval false The cube is not of CUBE_SIZE.
+*/
+bool
+cube_sized_from_cube(
+        CubeSized_t *cube,
+        Cube_t *src
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Copies the blocks of a cube to a cube of CUBE_SIZE.
+**
+**  The row and column cursors of the destination cube are left untouched.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[out] dest A pointer to the destination cube.
+**
+**  @retval true The blocks were copied.
+**  @retval false The cube is not of CUBE_SIZE.
+*/
+bool
+cube_sized_to_cube(
+        CubeSized_t *cube,
+        Cube_t *dest
+);
+
+#endif // ifndef rubics_cube_sized_H
+
+/* EOF */
\ No newline at end of file
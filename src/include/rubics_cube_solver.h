@@ -0,0 +1,203 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_solver.h
+**  @ingroup    rubicscube
+**  @brief      Two-phase solver for the 3x3x3 cube.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_solver_H
+#define rubics_cube_solver_H
+
+#include "rubics_cube_cubie.h"
+#include "rubics_cube_table.h"
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// The longest solution the solver can search for.
+#define CUBE_SOLVER_MAX_LENGTH 30
+
+/// Solution length that the solver reaches in milliseconds.
+#define CUBE_SOLVER_DEFAULT_LENGTH 22
+
+/// Phase 2 searches made after the first solution to find a shorter one.
+#define CUBE_SOLVER_PROBE_COUNT 100
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Two-phase solver.
+**
+**  Phase 1 brings the cube to the subgroup generated by U, D, R2, L2, F2 and
+**  B2, where the corners and edges are oriented and the middle layer edges
+**  are in the middle layer. Phase 2 solves the cube with the moves of the
+**  subgroup. Both phases are searched with IDA*, using coordinate move tables
+**  and pruning tables.
+**
+**  The tables are generated once and are only read by the searches, so one
+**  solver may be shared by any number of threads.
+*/
+typedef struct
+CubeSolver_t{
+        /// All tables in one block.
+        CubeTable_t table;
+        /// Corner orientation move table.
+        uint16_t *twistMove;
+        /// Edge orientation move table.
+        uint16_t *flipMove;
+        /// Middle layer edge position and order move table.
+        uint16_t *sliceMove;
+        /// Corner permutation move table, phase 2 moves.
+        uint16_t *cornerMove;
+        /// Top and bottom layer edge permutation move table, phase 2 moves.
+        uint16_t *edgeMove;
+        /// Phase 1 distances by middle layer edges and corner orientation.
+        uint8_t *sliceTwistPrune;
+        /// Phase 1 distances by middle layer edges and edge orientation.
+        uint8_t *sliceFlipPrune;
+        /// Phase 2 distances by middle layer edges and corner permutation.
+        uint8_t *sliceCornerPrune;
+        /// Phase 2 distances by middle layer edges and edge permutation.
+        uint8_t *sliceEdgePrune;
+} CubeSolver_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Initializes a solver.
+**
+**  The tables are mapped from a file. If the file does not exist or does not
+**  match, the tables are generated, which takes a few seconds, and written
+**  to the file.
+**
+**  @param[out] solver A pointer to a solver.
+**  @param[in] path A path of the table file, or NULL to generate the tables
+**                  without a file.
+**
+**  @retval true The solver is ready.
+**  @retval false Out of memory.
+*/
+bool
+cube_solver_init(
+        CubeSolver_t *solver,
+        char *path
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Frees the tables of a solver.
+**
+**  @param[in] solver A pointer to a solver.
+*/
+void
+cube_solver_free(
+        CubeSolver_t *solver
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Solves a cubie level cube.
+**
+**  After the first solution that is not longer than the given length, the
+**  search goes on for shorter ones with CUBE_SOLVER_PROBE_COUNT more phase 2
+**  searches, and returns the shortest solution found. The search ends early
+**  when no shorter solution is left within the depth bound, so the
+**  solutions of easy scrambles are short. Solutions of 22 moves or more are
+**  found in milliseconds, while a length below 20 may take a long time.
+**
+**  @param[in] solver A pointer to a solver.
+**  @param[in] cubie A pointer to a cube to solve.
+**  @param[in] maxLength The longest accepted solution
+**                       (CUBE_SOLVER_MAX_LENGTH at most).
+**  @param[out] solution A buffer of maxLength turns for the solution.
+**  @param[out] length Number of turns in the solution.
+**
+**  @retval true A solution was found.
+**  @retval false The cube is not valid, or it has no solution of the given
+**                length.
+*/
+bool
+cube_solver_solve(
+        CubeSolver_t *solver,
+        CubeCubie_t *cubie,
+        uint8_t maxLength,
+        CubeTurn_t *solution,
+        uint8_t *length
+);
+
+#if CUBE_SIZE==3
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Solves a cube.
+**
+**  The faces are identified by the colors of their centers, so the turns of
+**  the solution refer to the sides as the cube is currently positioned.
+**
+**  @param[in] solver A pointer to a solver.
+**  @param[in] cube A pointer to a cube to solve.
+**  @param[in] maxLength The longest accepted solution.
+**  @param[out] solution A buffer of maxLength turns for the solution.
+**  @param[out] length Number of turns in the solution.
+**
+**  @retval true A solution was found.
+**  @retval false The cube is not valid, or it has no solution of the given
+**                length.
+*/
+bool
+cube_solver_solve_cube(
+        CubeSolver_t *solver,
+        Cube_t *cube,
+        uint8_t maxLength,
+        CubeTurn_t *solution,
+        uint8_t *length
+);
+
+#endif // if CUBE_SIZE==3
+
+#endif // ifndef rubics_cube_solver_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,161 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_symmetry.h
+**  @ingroup    rubicscube
+**  @brief      Symmetries and canonical forms of cube states.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_symmetry_H
+#define rubics_cube_symmetry_H
+
+#include "rubics_cube_packed.h"
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Number of symmetries of the cube: 24 rotations and their mirror images.
+#define CUBE_SYMMETRY_COUNT 48
+
+/// Number of rotations. The rotations are the symmetries 0 - 23, and the
+///symmetry 0 is the identity.
+#define CUBE_SYMMETRY_ROTATION_COUNT 24
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Initializes the symmetry tables.
+**
+**  The tables are initialized on the first use, but the function should be
+**  called before starting threads that use them.
+*/
+void
+cube_symmetry_init(
+        void
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Looks at a cube through a symmetry.
+**
+**  The stickers are moved by the rotation or reflection, and the colors are
+**  swapped like the sides of a reset cube are, so a reset cube stays reset.
+**  A state reached with some turns becomes the state reached with the turns
+**  mapped by cube_symmetry_map_turn(), at the same distance from the reset
+**  state.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] sym The symmetry (0 - CUBE_SYMMETRY_COUNT-1).
+**  @param[out] result A pointer to the symmetric cube, not the same as the
+**                     cube.
+*/
+void
+cube_symmetry_apply(
+        CubePacked_t *packed,
+        uint8_t sym,
+        CubePacked_t *result
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the canonical form of a cube.
+**
+**  The canonical form is the symmetric cube with the smallest stickers in
+**  the memcmp() order. All the symmetric states of a cube have the same
+**  canonical form, so a table or a hash of the canonical forms stores each
+**  state once instead of up to 48 times.
+**
+**  With color symmetry, states that differ only in the colors, for example
+**  a cube and the same cube rotated with cube_rotate(), also have the same
+**  canonical form. The colors of the form are then numbered in the order
+**  they first appear, and the form is not a valid cube to solve.
+**
+**  Each symmetric cube is compared while it is built, and it is dropped at
+**  the first sticker that is greater than in the smallest one so far.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] colors Use the color symmetry.
+**  @param[out] result A pointer to the canonical form, not the same as the
+**                     cube.
+**
+**  @return The symmetry that gives the canonical form.
+*/
+uint8_t
+cube_symmetry_canonical(
+        CubePacked_t *packed,
+        bool colors,
+        CubePacked_t *result
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the inverse of a symmetry.
+**
+**  @param[in] sym A symmetry.
+**
+**  @return The symmetry that undoes the symmetry.
+*/
+uint8_t
+cube_symmetry_inverse(
+        uint8_t sym
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Looks at a turn through a symmetry.
+**
+**  A mirror image turns the other way. The turns that solve the canonical
+**  form of a cube solve the cube when they are mapped with the inverse of
+**  the symmetry of the form.
+**
+**  @param[in] sym A symmetry.
+**  @param[in] turn A turn.
+**
+**  @return The turn on the symmetric cube.
+*/
+CubeTurn_t
+cube_symmetry_map_turn(
+        uint8_t sym,
+        CubeTurn_t turn
+);
+
+#endif // ifndef rubics_cube_symmetry_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,183 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_table.h
+**  @ingroup    rubicscube
+**  @brief      Memory mapped table files.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_table_H
+#define rubics_cube_table_H
+
+#include "rubics_cube.h"
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Offset of the table data in a table file. The data starts on a page
+///boundary, so the mapped tables are page aligned.
+#define CUBE_TABLE_DATA_OFFSET 4096
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A block of lookup tables.
+**
+**  The block is either allocated and generated by the process, or mapped
+**  read-only from a table file. A mapped file is paged in lazily as the
+**  tables are read, and all processes that map the same file share the same
+**  physical pages, so starting a process takes milliseconds and adds no
+**  memory for the tables.
+**
+**  A table file has a header page and the table data. The header identifies
+**  the table set, its version and the cube size, and it has the size and a
+**  checksum of the data. The file is written to a temporary file that is
+**  renamed over the old one, so a process never maps a partial file.
+*/
+typedef struct
+CubeTable_t{
+        /// The tables.
+        uint8_t *data;
+        /// Size of the tables in bytes.
+        uint64_t size;
+        /// Checksum of the tables, set when the block is saved or mapped.
+        uint64_t checksum;
+        /// The mapped file, or NULL when the block is allocated.
+        void *map;
+        /// Size of the mapped file in bytes.
+        uint64_t mapSize;
+} CubeTable_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Allocates a table block to generate the tables in.
+**
+**  @param[out] table A pointer to a table block.
+**  @param[in] size Size of the tables in bytes.
+**
+**  @retval true The block was allocated.
+**  @retval false Out of memory.
+*/
+bool
+cube_table_alloc(
+        CubeTable_t *table,
+        uint64_t size
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Maps a table file read-only.
+**
+**  Only the header is read, so the checksum of the data is not checked. See
+**  cube_table_verify().
+**
+**  @param[out] table A pointer to a table block.
+**  @param[in] path A path of the table file.
+**  @param[in] id Identifier of the table set.
+**  @param[in] version Version of the table set.
+**  @param[in] size Size of the tables in bytes.
+**
+**  @retval true The file was mapped.
+**  @retval false The file does not exist or does not match.
+*/
+bool
+cube_table_map(
+        CubeTable_t *table,
+        char *path,
+        uint32_t id,
+        uint32_t version,
+        uint64_t size
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Saves a table block to a file.
+**
+**  @param[in,out] table A pointer to a table block. The checksum is set.
+**  @param[in] path A path of the table file.
+**  @param[in] id Identifier of the table set.
+**  @param[in] version Version of the table set.
+**
+**  @retval true The file was written.
+**  @retval false The file could not be written.
+*/
+bool
+cube_table_save(
+        CubeTable_t *table,
+        char *path,
+        uint32_t id,
+        uint32_t version
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks the tables against the checksum.
+**
+**  Reads all of the tables, so a mapped file is paged in completely.
+**
+**  @param[in] table A pointer to a saved or mapped table block.
+**
+**  @retval true The tables match the checksum.
+**  @retval false The tables are corrupted.
+*/
+bool
+cube_table_verify(
+        CubeTable_t *table
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Frees or unmaps a table block.
+**
+**  @param[in] table A pointer to a table block.
+*/
+void
+cube_table_free(
+        CubeTable_t *table
+);
+
+#endif // ifndef rubics_cube_table_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,331 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_thread.h
+**  @ingroup    rubicscube
+**  @brief      Threads and atomic operations.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_thread_H
+#define rubics_cube_thread_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// The largest number of threads of one task.
+#define CUBE_THREAD_MAX_COUNT 256
+
+/// Storage class of a static variable that each thread has a copy of.
+#if defined(_MSC_VER)
+#define CUBE_THREAD_LOCAL __declspec(thread)
+#else
+#define CUBE_THREAD_LOCAL __thread
+#endif
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Function run by a thread.
+**
+**  @param[in] argument The argument given when the thread was started.
+*/
+typedef void
+(*CubeThreadFunction_t)(
+        void *argument
+);
+
+/**
+**  @brief Thread.
+*/
+typedef struct
+CubeThread_t{
+        /// Thread handle.
+#if defined(_WIN32)
+        void *handle;
+#else
+        pthread_t handle;
+#endif
+        /// Function run by the thread.
+        CubeThreadFunction_t function;
+        /// Argument of the function.
+        void *argument;
+} CubeThread_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Starts a thread.
+**
+**  @param[out] thread A pointer to a thread. It must stay valid until the
+**                     thread is joined.
+**  @param[in] function Function to run.
+**  @param[in] argument Argument of the function.
+**
+**  @retval true The thread was started.
+**  @retval false The thread could not be created.
+*/
+bool
+cube_thread_start(
+        CubeThread_t *thread,
+        CubeThreadFunction_t function,
+        void *argument
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Waits until a thread has finished.
+**
+**  @param[in] thread A pointer to a started thread.
+*/
+void
+cube_thread_join(
+        CubeThread_t *thread
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gives the rest of the time slice of the calling thread to other
+**         threads.
+*/
+void
+cube_thread_yield(
+        void
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the number of processors.
+**
+**  @return Number of processors available to the process, at least 1 and at
+**          most CUBE_THREAD_MAX_COUNT.
+*/
+uint32_t
+cube_thread_cpu_count(
+        void
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the time of a monotonic wall clock.
+**
+**  Unlike clock(), the time does not depend on the number of threads running.
+**
+**  @return Time in nanoseconds from an unspecified starting point.
+*/
+uint64_t
+cube_thread_clock(
+        void
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Reads a value shared by threads.
+**
+**  The read is not locked, so polling a value does not slow down the other
+**  processors.
+**
+**  @param[in] value A pointer to the value.
+**
+**  @return The value.
+*/
+static inline uint32_t
+cube_atomic_load(
+        volatile uint32_t *value
+)
+{
+#if defined(_MSC_VER)
+        uint32_t v;
+
+        v=*value;
+        _ReadWriteBarrier();
+        return v;
+#else
+        return __atomic_load_n(value,__ATOMIC_ACQUIRE);
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Writes a value shared by threads.
+**
+**  @param[out] value A pointer to the value.
+**  @param[in] v The new value.
+*/
+static inline void
+cube_atomic_store(
+        volatile uint32_t *value,
+        uint32_t v
+)
+{
+#if defined(_MSC_VER)
+        _ReadWriteBarrier();
+        *value=v;
+#else
+        __atomic_store_n(value,v,__ATOMIC_RELEASE);
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Adds to a value shared by threads.
+**
+**  @param[in,out] value A pointer to the value.
+**  @param[in] v The amount to add.
+**
+**  @return The value before the addition.
+*/
+static inline uint32_t
+cube_atomic_add(
+        volatile uint32_t *value,
+        uint32_t v
+)
+{
+#if defined(_MSC_VER)
+        return (uint32_t)_InterlockedExchangeAdd((volatile long *)value,(long)v);
+#else
+        return __atomic_fetch_add(value,v,__ATOMIC_ACQ_REL);
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets bits of a value shared by threads.
+**
+**  @param[in,out] value A pointer to the value.
+**  @param[in] v The bits to set.
+**
+**  @return The value before the bits were set.
+*/
+static inline uint32_t
+cube_atomic_or(
+        volatile uint32_t *value,
+        uint32_t v
+)
+{
+#if defined(_MSC_VER)
+        return (uint32_t)_InterlockedOr((volatile long *)value,(long)v);
+#else
+        return __atomic_fetch_or(value,v,__ATOMIC_ACQ_REL);
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Replaces a value shared by threads if it has not changed.
+**
+**  @param[in,out] value A pointer to the value.
+**  @param[in] expected The value that is expected.
+**  @param[in] v The new value.
+**
+**  @retval true The value was replaced.
+**  @retval false The value was not the expected one, and it was not changed.
+*/
+static inline bool
+cube_atomic_compare_swap(
+        volatile uint32_t *value,
+        uint32_t expected,
+        uint32_t v
+)
+{
+#if defined(_MSC_VER)
+        return (uint32_t)_InterlockedCompareExchange((volatile long *)value,(long)v,
+                (long)expected)==expected;
+#else
+        return __atomic_compare_exchange_n(value,&expected,v,false,__ATOMIC_ACQ_REL,
+                __ATOMIC_ACQUIRE);
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Reads a 64-bit value shared by threads, without ordering.
+**
+**  The read is atomic on 64-bit targets. A 32-bit target may read the halves
+**  of two different writes, so the value must be checked by the reader.
+**
+**  @param[in] value A pointer to the value.
+**
+**  @return The value.
+*/
+static inline uint64_t
+cube_atomic_load64(
+        volatile uint64_t *value
+)
+{
+#if defined(_MSC_VER)
+        return *value;
+#else
+        return __atomic_load_n(value,__ATOMIC_RELAXED);
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Writes a 64-bit value shared by threads, without ordering.
+**
+**  See cube_atomic_load64().
+**
+**  @param[out] value A pointer to the value.
+**  @param[in] v The new value.
+*/
+static inline void
+cube_atomic_store64(
+        volatile uint64_t *value,
+        uint64_t v
+)
+{
+#if defined(_MSC_VER)
+        *value=v;
+#else
+        __atomic_store_n(value,v,__ATOMIC_RELAXED);
+#endif
+}
+
+#endif // ifndef rubics_cube_thread_H
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,203 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_transposition.h
+**  @ingroup    rubicscube
+**  @brief      Lock-free transposition table.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#ifndef rubics_cube_transposition_H
+#define rubics_cube_transposition_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/******************************************************************************\
+**
+**  CONSTANTS
+**
+\******************************************************************************/
+
+/// Number of entries in a bucket. A bucket fills one 64-byte cache line, so
+///a lookup reads one line of memory.
+#define CUBE_TRANSPOSITION_BUCKET_SIZE 4
+
+/******************************************************************************\
+**
+**  TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief An entry of a transposition table.
+**
+**  The check word is the hash of the state XOR the data word. An entry that
+**  two threads wrote at the same time has the halves of different writes,
+**  which do not match the hash of either state, so the entry is not found
+**  instead of giving wrong data.
+*/
+typedef struct
+CubeTranspositionEntry_t{
+        /// Hash of the state XOR the data.
+        volatile uint64_t check;
+        /// Depth, best move and generation of the entry, 0 if empty.
+        volatile uint64_t data;
+} CubeTranspositionEntry_t;
+
+/**
+**  @brief A transposition table.
+**
+**  The table maps the hashes of the states a search has visited to the
+**  depth the state was searched to and the best move found. It has a fixed
+**  number of buckets, and a state can be in any entry of the bucket its hash
+**  selects. When the bucket is full, a new state replaces the entry of an
+**  earlier search, or the one with the smallest depth.
+**
+**  Any number of threads can look up and store states at the same time
+**  without locks. A store may be lost to a concurrent store to the same
+**  bucket, which only costs a search the work the entry would have saved.
+*/
+typedef struct
+CubeTranspositionTable_t{
+        /// Buckets of entries, aligned to the cache lines.
+        CubeTranspositionEntry_t *entries;
+        /// The allocated memory.
+        void *memory;
+        /// Number of buckets - 1, the number of buckets is a power of 2.
+        uint64_t bucketMask;
+        /// Generation of the current search.
+        uint8_t generation;
+} CubeTranspositionTable_t;
+
+/******************************************************************************\
+**
+**  API FUNCTION DECLARATIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Allocates an empty transposition table.
+**
+**  @param[out] table A pointer to a table.
+**  @param[in] size Largest size of the table in bytes. The number of buckets
+**                  is the largest power of 2 that fits, at least 1.
+**
+**  @retval true The table was allocated.
+**  @retval false Out of memory.
+*/
+bool
+cube_transposition_init(
+        CubeTranspositionTable_t *table,
+        uint64_t size
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Empties a transposition table.
+**
+**  Must not be called while other threads use the table.
+**
+**  @param[in] table A pointer to a table.
+*/
+void
+cube_transposition_clear(
+        CubeTranspositionTable_t *table
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Starts a new search on a transposition table.
+**
+**  The entries of the earlier searches stay in the table, but they are
+**  replaced first. Must not be called while other threads use the table.
+**
+**  @param[in] table A pointer to a table.
+*/
+void
+cube_transposition_new_search(
+        CubeTranspositionTable_t *table
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Looks up a state in a transposition table.
+**
+**  @param[in] table A pointer to a table.
+**  @param[in] hash Hash of the state, for example from cube_get_hash().
+**  @param[out] depth The depth stored with the state.
+**  @param[out] move The best move stored with the state.
+**
+**  @retval true The state was found.
+**  @retval false The state is not in the table.
+*/
+bool
+cube_transposition_probe(
+        CubeTranspositionTable_t *table,
+        uint64_t hash,
+        uint8_t *depth,
+        uint8_t *move
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Stores a state in a transposition table.
+**
+**  An entry of the same state from the current search is only replaced by
+**  a greater or equal depth.
+**
+**  @param[in] table A pointer to a table.
+**  @param[in] hash Hash of the state.
+**  @param[in] depth Depth the state was searched to.
+**  @param[in] move The best move of the state, for example a CubeTurn_t.
+*/
+void
+cube_transposition_store(
+        CubeTranspositionTable_t *table,
+        uint64_t hash,
+        uint8_t depth,
+        uint8_t move
+);
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Frees a transposition table.
+**
+**  @param[in] table A pointer to a table.
+*/
+void
+cube_transposition_free(
+        CubeTranspositionTable_t *table
+);
+
+#endif // ifndef rubics_cube_transposition_H
+
+/* EOF */
\ No newline at end of file
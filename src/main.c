@@ -1,10 +1,41 @@
+#if defined(_WIN32)
 #include "rubics_cube_win_console.h"
+#else
+#include "rubics_cube_posix_terminal.h"
+#endif
+#include "rubics_cube_log.h"
+
+#include <stdio.h>
 
 static CubeGame_t game;
 
-int main(void)
+static CubeLogWriter_t writer;
+
+int main(int argc, char **argv)
 {
+        bool isRecorded=argc>1;
+
+        // The sessions are appended to the log given as the argument.
+        if(isRecorded){
+                if(!cube_log_writer_open(&writer,argv[1])){
+                        fprintf(stderr,"Cannot open the log %s.\n",argv[1]);
+                        return 1;
+                }
+                cube_log_writer_attach(&writer,&game);
+        }
+#if defined(_WIN32)
         cube_game_win_console_run(&game);
+#else
+        if(!cube_game_posix_terminal_run(&game)){
+                fprintf(stderr,"The game needs a terminal.\n");
+                return 1;
+        }
+#endif
+        if(isRecorded&&!cube_log_writer_close(&writer)){
+                fprintf(stderr,"Cannot write the log %s.\n",argv[1]);
+                return 1;
+        }
+        return 0;
 }
 
 /* EOF */
\ No newline at end of file
@@ -41,10 +41,13 @@
 \******************************************************************************/
 
 #include "rubics_cube.h"
+#include "rubics_cube_thread.h"
+
+#if CUBE_SIZE==3
+#include "rubics_cube_cubie.h"
+#endif
 
 #include <string.h>
-#include <stdlib.h>
-#include <time.h>
 
 /******************************************************************************\
 **
@@ -52,6 +55,114 @@
 **
 \******************************************************************************/
 
+/// Number of color count fields in a word.
+#define COLORS_PER_WORD (64/CUBE_COLOR_COUNT_BITS)
+
+/// Mask of one color count field.
+#define COLOR_FIELD_MASK (((uint64_t)1<<CUBE_COLOR_COUNT_BITS)-1)
+
+/// Word of the count of a color.
+#if CUBE_COLOR_WORD_COUNT==1
+#define COLOR_WORD(color) 0
+#else
+#define COLOR_WORD(color) ((color)/COLORS_PER_WORD)
+#endif
+
+/// Seed of the block hash keys. The keys are the same in every process.
+#define HASH_KEY_SEED 0x2B7E151628AED2A6ULL
+
+/// Multiplier that separates the face hashes of the sides.
+#define HASH_SIDE_PRIME 0x9E3779B97F4A7C15ULL
+
+/// States of the block hash keys.
+#define KEYS_NONE 0
+#define KEYS_BUILDING 1
+#define KEYS_READY 2
+
+/// Number of layers of an axis turned by a shuffle. The middle layer of an
+///odd sized cube is not turned, so the centers stay in place.
+#define SHUFFLE_LAYER_COUNT (CUBE_SIZE-CUBE_SIZE%2)
+
+/// Position of block i of a layer on face k of the ring of the axis, a
+///position being row*CUBE_SIZE+column. An X layer is a row of the top,
+///front, bottom and back faces. A Y layer is a column of the left, front and
+///right faces, and of the back face upside down. A Z layer is column
+///CUBE_SIZE-1-layer of the top face down, row CUBE_SIZE-1-layer of the left
+///face to the left, column layer of the bottom face up and row layer of the
+///right face to the right.
+#define LAYER_POSITION(axis,layer,k,i) \
+        ((axis)==CUBE_AXIS_X?(layer)*CUBE_SIZE+(i):\
+         (axis)==CUBE_AXIS_Y?((k)<3?(i)*CUBE_SIZE+(layer):\
+                (CUBE_SIZE-1-(i))*CUBE_SIZE+CUBE_SIZE-1-(layer)):\
+         (k)==0?(i)*CUBE_SIZE+CUBE_SIZE-1-(layer):\
+         (k)==1?(CUBE_SIZE-1-(layer))*CUBE_SIZE+CUBE_SIZE-1-(i):\
+         (k)==2?(CUBE_SIZE-1-(i))*CUBE_SIZE+(layer):\
+         (layer)*CUBE_SIZE+(i))
+
+/// Position of the four blocks cycled by a face turn, k being 0-3 and the
+///first block being on row i and column j.
+#define FACE_POSITION(i,j,k) \
+        ((k)==0?(i)*CUBE_SIZE+(j):\
+         (k)==1?(j)*CUBE_SIZE+CUBE_SIZE-1-(i):\
+         (k)==2?(CUBE_SIZE-1-(i))*CUBE_SIZE+CUBE_SIZE-1-(j):\
+         (CUBE_SIZE-1-(j))*CUBE_SIZE+(i))
+
+/// The small cubes turn with the positions of the layer blocks in a table
+///computed at compile time, and with the loops over the blocks written out
+///for each number of turns. The larger cubes step the positions in loops.
+#if CUBE_SIZE<=5
+#define TURN_TABLES 1
+#else
+#define TURN_TABLES 0
+#endif
+
+/// Expands m(x,y,i) for each block i of a layer, m(x,y,i,j) for the first
+///of each four blocks cycled by a face turn, and m(x,layer) for each layer.
+#if CUBE_SIZE==2
+#define FOR_EACH_BLOCK(m,x,y) m(x,y,0) m(x,y,1)
+#define FOR_EACH_FACE_CYCLE(m,x,y) m(x,y,0,0)
+#define FOR_EACH_LAYER(m,x) m(x,0) m(x,1)
+#elif CUBE_SIZE==3
+#define FOR_EACH_BLOCK(m,x,y) m(x,y,0) m(x,y,1) m(x,y,2)
+#define FOR_EACH_FACE_CYCLE(m,x,y) m(x,y,0,0) m(x,y,0,1)
+#define FOR_EACH_LAYER(m,x) m(x,0) m(x,1) m(x,2)
+#elif CUBE_SIZE==4
+#define FOR_EACH_BLOCK(m,x,y) m(x,y,0) m(x,y,1) m(x,y,2) m(x,y,3)
+#define FOR_EACH_FACE_CYCLE(m,x,y) m(x,y,0,0) m(x,y,0,1) m(x,y,0,2) m(x,y,1,1)
+#define FOR_EACH_LAYER(m,x) m(x,0) m(x,1) m(x,2) m(x,3)
+#elif CUBE_SIZE==5
+#define FOR_EACH_BLOCK(m,x,y) m(x,y,0) m(x,y,1) m(x,y,2) m(x,y,3) m(x,y,4)
+#define FOR_EACH_FACE_CYCLE(m,x,y) m(x,y,0,0) m(x,y,0,1) m(x,y,0,2) m(x,y,0,3) \
+        m(x,y,1,1) m(x,y,1,2)
+#define FOR_EACH_LAYER(m,x) m(x,0) m(x,1) m(x,2) m(x,3) m(x,4)
+#endif
+
+/// Inlines a function at every call, where the compiler would call a large
+///function written out several times.
+#if defined(_MSC_VER)
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+#if TURN_TABLES
+/// Initializers of the layer block table.
+#define LAYER_CYCLE(axis,layer,i) {\
+        LAYER_POSITION(axis,layer,0,i),LAYER_POSITION(axis,layer,1,i),\
+        LAYER_POSITION(axis,layer,2,i),LAYER_POSITION(axis,layer,3,i)},
+#define LAYER_CYCLES(axis,layer) {FOR_EACH_BLOCK(LAYER_CYCLE,axis,layer)},
+
+/// Cycles the blocks of a layer at block i.
+#define CYCLE_LAYER_BLOCKS(layer,turns,i) \
+        cycle_layer_blocks(layer,layer->cycle[i][0],layer->cycle[i][1],\
+                layer->cycle[i][2],layer->cycle[i][3],turns);
+
+/// Cycles the blocks of a face from row i and column j.
+#define CYCLE_FACE_BLOCKS(b,turns,i,j) \
+        cycle_blocks(&b[FACE_POSITION(i,j,0)],&b[FACE_POSITION(i,j,1)],\
+                &b[FACE_POSITION(i,j,2)],&b[FACE_POSITION(i,j,3)],turns);
+#endif // if TURN_TABLES
+
 /*-------------------------------------------------------------------------*//**
 **  @brief Cube colors on reset, side by side.
 */
@@ -65,12 +176,277 @@ resetColors[CUBE_SIDE_COUNT]={
         CUBE_COLOR_GREEN // Right
 };
 
+/*-------------------------------------------------------------------------*//**
+**  @brief Layer moves of the outer layer turns.
+*/
+static const CubeMove_t
+turnMoves[CUBE_TURN_COUNT]={
+        {CUBE_AXIS_Y,0,0,1}, // U
+        {CUBE_AXIS_Y,0,0,2}, // U2
+        {CUBE_AXIS_Y,0,0,3}, // U'
+        {CUBE_AXIS_X,CUBE_SIZE-1,CUBE_SIZE-1,1}, // R
+        {CUBE_AXIS_X,CUBE_SIZE-1,CUBE_SIZE-1,2}, // R2
+        {CUBE_AXIS_X,CUBE_SIZE-1,CUBE_SIZE-1,3}, // R'
+        {CUBE_AXIS_Z,0,0,1}, // F
+        {CUBE_AXIS_Z,0,0,2}, // F2
+        {CUBE_AXIS_Z,0,0,3}, // F'
+        {CUBE_AXIS_Y,CUBE_SIZE-1,CUBE_SIZE-1,3}, // D
+        {CUBE_AXIS_Y,CUBE_SIZE-1,CUBE_SIZE-1,2}, // D2
+        {CUBE_AXIS_Y,CUBE_SIZE-1,CUBE_SIZE-1,1}, // D'
+        {CUBE_AXIS_X,0,0,3}, // L
+        {CUBE_AXIS_X,0,0,2}, // L2
+        {CUBE_AXIS_X,0,0,1}, // L'
+        {CUBE_AXIS_Z,CUBE_SIZE-1,CUBE_SIZE-1,3}, // B
+        {CUBE_AXIS_Z,CUBE_SIZE-1,CUBE_SIZE-1,2}, // B2
+        {CUBE_AXIS_Z,CUBE_SIZE-1,CUBE_SIZE-1,1} // B'
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief One block of each color in the color counts of a face.
+*/
+static const uint64_t
+colorUnit[CUBE_COLOR_COUNT]={
+        (uint64_t)1<<CUBE_COLOR_BLUE%COLORS_PER_WORD*CUBE_COLOR_COUNT_BITS,
+        (uint64_t)1<<CUBE_COLOR_GREEN%COLORS_PER_WORD*CUBE_COLOR_COUNT_BITS,
+        (uint64_t)1<<CUBE_COLOR_RED%COLORS_PER_WORD*CUBE_COLOR_COUNT_BITS,
+        (uint64_t)1<<CUBE_COLOR_ORANGE%COLORS_PER_WORD*CUBE_COLOR_COUNT_BITS,
+        (uint64_t)1<<CUBE_COLOR_YELLOW%COLORS_PER_WORD*CUBE_COLOR_COUNT_BITS,
+        (uint64_t)1<<CUBE_COLOR_WHITE%COLORS_PER_WORD*CUBE_COLOR_COUNT_BITS
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Faces around the layers of each axis, in the order the blocks of
+**  a layer are cycled.
+*/
+static const CubeSide_t
+layerRing[CUBE_AXIS_COUNT][4]={
+        {CUBE_SIDE_TOP,CUBE_SIDE_FRONT,CUBE_SIDE_BOTTOM,CUBE_SIDE_BACK}, // X
+        {CUBE_SIDE_LEFT,CUBE_SIDE_FRONT,CUBE_SIDE_RIGHT,CUBE_SIDE_BACK}, // Y
+        {CUBE_SIDE_TOP,CUBE_SIDE_LEFT,CUBE_SIDE_BOTTOM,CUBE_SIDE_RIGHT} // Z
+};
+
+#if TURN_TABLES
+/*-------------------------------------------------------------------------*//**
+**  @brief Positions of the layer blocks cycled by the turns, by axis, layer
+**  and block, on each face of the ring.
+*/
+static const uint8_t
+layerCycle[CUBE_AXIS_COUNT][CUBE_SIZE][CUBE_SIZE][4]={
+        {FOR_EACH_LAYER(LAYER_CYCLES,CUBE_AXIS_X)},
+        {FOR_EACH_LAYER(LAYER_CYCLES,CUBE_AXIS_Y)},
+        {FOR_EACH_LAYER(LAYER_CYCLES,CUBE_AXIS_Z)}
+};
+#endif // if TURN_TABLES
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A turn of a layer.
+**
+**  The blocks of a layer are addressed by their positions on each face of
+**  the ring, a position being row*CUBE_SIZE+column.
+*/
+typedef struct
+LayerTurn_t{
+        /// Faces around the layer, in the order the blocks are cycled.
+        CubeFace_t *ring[4];
+#if TURN_TABLES
+        /// Positions of the layer blocks on each face of the ring.
+        const uint8_t (*cycle)[4];
+#else
+        /// Position of the first layer block on each face of the ring.
+        int32_t first[4];
+        /// Step of the position to the next layer block on each face.
+        int32_t step[4];
+#endif
+        /// Color counts of the layer blocks on each face of the ring before
+        /// the turn, in the format of the face color counts.
+        uint64_t strip[4][CUBE_COLOR_WORD_COUNT];
+} LayerTurn_t;
+
+/******************************************************************************\
+**
+**  LOCAL VARIABLES
+**
+\******************************************************************************/
+
+/// Hash keys of the blocks by position on a face and color. Every key is an
+///independent random value.
+static uint64_t blockKey[CUBE_SIZE*CUBE_SIZE][CUBE_COLOR_COUNT];
+
+/// State of the block hash keys (KEYS_NONE, KEYS_BUILDING or KEYS_READY).
+static volatile uint32_t keyState=KEYS_NONE;
+
 /******************************************************************************\
 **
 **  LOCAL FUNCTION DEFINITIONS
 **
 \******************************************************************************/
 
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates the block hash keys.
+*/
+static void
+build_keys(
+        void
+)
+{
+        CubeRandom_t random;
+        uint16_t i;
+        uint8_t c;
+
+        cube_random_seed(&random,HASH_KEY_SEED);
+        for(i=0;i<CUBE_SIZE*CUBE_SIZE;i++){
+                for(c=0;c<CUBE_COLOR_COUNT;c++){
+                        blockKey[i][c]=cube_random_next(&random);
+                }
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates the block hash keys once.
+**
+**  The first thread to get here generates the keys, and any other thread
+**  waits for them.
+*/
+static void
+init_keys(
+        void
+)
+{
+        if(cube_atomic_load(&keyState)==KEYS_READY){
+                return;
+        }
+        if(cube_atomic_compare_swap(&keyState,KEYS_NONE,KEYS_BUILDING)){
+                build_keys();
+                cube_atomic_store(&keyState,KEYS_READY);
+                return;
+        }
+        while(cube_atomic_load(&keyState)!=KEYS_READY){
+                cube_thread_yield();
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Mixes the hash of a face with its side.
+**
+**  @param[in] hash A face hash.
+**  @param[in] side The side of the face.
+**
+**  @return The mixed hash.
+*/
+static inline uint64_t
+mix_face_hash(
+        uint64_t hash,
+        uint8_t side
+)
+{
+        hash^=(side+1)*HASH_SIDE_PRIME;
+        hash=(hash^(hash>>30))*0xBF58476D1CE4E5B9ULL;
+        hash=(hash^(hash>>27))*0x94D049BB133111EBULL;
+        return hash^(hash>>31);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Cycles four blocks.
+**
+**  With one quarter turn each block gets the color of the next one, and the
+**  last block gets the color of the first one. A half turn swaps the opposite
+**  blocks.
+**
+**  @param[in] a The first block.
+**  @param[in] b The second block.
+**  @param[in] c The third block.
+**  @param[in] d The fourth block.
+**  @param[in] turns Quarter turns (1-3).
+*/
+static FORCE_INLINE void
+cycle_blocks(
+        CubeColor_t *a,
+        CubeColor_t *b,
+        CubeColor_t *c,
+        CubeColor_t *d,
+        uint8_t turns
+)
+{
+        CubeColor_t t;
+
+        switch(turns){
+        default:return;
+        case 1:
+                t=*a;
+                *a=*b;
+                *b=*c;
+                *c=*d;
+                *d=t;
+                break;
+        case 2:
+                t=*a;
+                *a=*c;
+                *c=t;
+                t=*b;
+                *b=*d;
+                *d=t;
+                break;
+        case 3:
+                t=*d;
+                *d=*c;
+                *c=*b;
+                *b=*a;
+                *a=t;
+                break;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns a face in place.
+**
+**  @param[in] face A face to turn.
+**  @param[in] turns Clockwise quarter turns (1-3).
+*/
+static void
+turn_face(
+        CubeFace_t *face,
+        uint8_t turns
+)
+{
+#if TURN_TABLES
+        CubeColor_t *b;
+
+        b=&face->blocks[0][0];
+        switch(turns){
+        default:break;
+        case 1:
+                FOR_EACH_FACE_CYCLE(CYCLE_FACE_BLOCKS,b,1)
+                break;
+        case 2:
+                FOR_EACH_FACE_CYCLE(CYCLE_FACE_BLOCKS,b,2)
+                break;
+        case 3:
+                FOR_EACH_FACE_CYCLE(CYCLE_FACE_BLOCKS,b,3)
+                break;
+        }
+#else
+        uint8_t i;
+        uint8_t j;
+
+        for(i=0;i<CUBE_SIZE/2;i++){
+                for(j=i;j<CUBE_SIZE-1-i;j++){
+                        cycle_blocks(
+                                &face->blocks[i][j],
+                                &face->blocks[j][CUBE_SIZE-1-i],
+                                &face->blocks[CUBE_SIZE-1-i][CUBE_SIZE-1-j],
+                                &face->blocks[CUBE_SIZE-1-j][i],
+                                turns);
+                }
+        }
+#endif
+}
+
 /*-------------------------------------------------------------------------*//**
 **  @brief Rotates a face.
 **
@@ -83,28 +459,15 @@ rotate_face(
         CubeDirection_t dir
 )
 {
-        CubeFace_t f;
-        uint8_t i;
-        uint8_t j;
-
         switch(dir){
         default:return;
         case CUBE_DIRECTION_CW:
-                for(i=0;i<CUBE_SIZE;i++){
-                        for(j=0;j<CUBE_SIZE;j++){
-                                f.blocks[i][j]=face->blocks[j][CUBE_SIZE-i-1];
-                        }
-                }
+                turn_face(face,1);
                 break;
         case CUBE_DIRECTION_CCW:
-                for(i=0;i<CUBE_SIZE;i++){
-                        for(j=0;j<CUBE_SIZE;j++){
-                                f.blocks[i][j]=face->blocks[CUBE_SIZE-j-1][i];
-                        }
-                }
+                turn_face(face,3);
                 break;
         }
-        memcpy(face->blocks,f.blocks,sizeof(CubeBlocks_t));
 }
 
 /*-------------------------------------------------------------------------*//**
@@ -121,40 +484,13 @@ rotate_row(
         CubeDirection_t dir
 )
 {
-        uint8_t i;
-        CubeColor_t c;
-
         switch(dir){
         default:return;
         case CUBE_DIRECTION_LEFT:
-                if(!row){
-                        rotate_face(&cube->face[CUBE_SIDE_TOP],CUBE_DIRECTION_CW);
-                }
-                if(row==CUBE_SIZE-1){
-                        rotate_face(&cube->face[CUBE_SIDE_BOTTOM],CUBE_DIRECTION_CCW);
-                }
-                for(i=0;i<CUBE_SIZE;i++){
-                        c=cube->face[CUBE_SIDE_LEFT].blocks[i][row];
-                        cube->face[CUBE_SIDE_LEFT].blocks[i][row]=cube->face[CUBE_SIDE_FRONT].blocks[i][row];
-                        cube->face[CUBE_SIDE_FRONT].blocks[i][row]=cube->face[CUBE_SIDE_RIGHT].blocks[i][row];
-                        cube->face[CUBE_SIDE_RIGHT].blocks[i][row]=cube->face[CUBE_SIDE_BACK].blocks[CUBE_SIZE-1-i][CUBE_SIZE-1-row];
-                        cube->face[CUBE_SIDE_BACK].blocks[CUBE_SIZE-1-i][CUBE_SIZE-1-row]=c;
-                }
+                cube_turn(cube,CUBE_AXIS_Y,row,1);
                 break;
         case CUBE_DIRECTION_RIGHT:
-                if(!row){
-                        rotate_face(&cube->face[CUBE_SIDE_TOP],CUBE_DIRECTION_CCW);
-                }
-                if(row==CUBE_SIZE-1){
-                        rotate_face(&cube->face[CUBE_SIDE_BOTTOM],CUBE_DIRECTION_CW);
-                }
-                for(i=0;i<CUBE_SIZE;i++){
-                        c=cube->face[CUBE_SIDE_RIGHT].blocks[i][row];
-                        cube->face[CUBE_SIDE_RIGHT].blocks[i][row]=cube->face[CUBE_SIDE_FRONT].blocks[i][row];
-                        cube->face[CUBE_SIDE_FRONT].blocks[i][row]=cube->face[CUBE_SIDE_LEFT].blocks[i][row];
-                        cube->face[CUBE_SIDE_LEFT].blocks[i][row]=cube->face[CUBE_SIDE_BACK].blocks[CUBE_SIZE-1-i][CUBE_SIZE-1-row];
-                        cube->face[CUBE_SIDE_BACK].blocks[CUBE_SIZE-1-i][CUBE_SIZE-1-row]=c;
-                }
+                cube_turn(cube,CUBE_AXIS_Y,row,3);
                 break;
         }
 }
@@ -173,40 +509,39 @@ rotate_column(
         CubeDirection_t dir
 )
 {
-        uint8_t i;
-        CubeColor_t c;
-
         switch(dir){
         default:return;
         case CUBE_DIRECTION_UP:
-                if(!col){
-                        rotate_face(&cube->face[CUBE_SIDE_LEFT],CUBE_DIRECTION_CCW);
-                }
-                if(col==CUBE_SIZE-1){
-                        rotate_face(&cube->face[CUBE_SIDE_RIGHT],CUBE_DIRECTION_CW);
-                }
-                for(i=0;i<CUBE_SIZE;i++){
-                        c=cube->face[CUBE_SIDE_TOP].blocks[col][i];
-                        cube->face[CUBE_SIDE_TOP].blocks[col][i]=cube->face[CUBE_SIDE_FRONT].blocks[col][i];
-                        cube->face[CUBE_SIDE_FRONT].blocks[col][i]=cube->face[CUBE_SIDE_BOTTOM].blocks[col][i];
-                        cube->face[CUBE_SIDE_BOTTOM].blocks[col][i]=cube->face[CUBE_SIDE_BACK].blocks[col][i];
-                        cube->face[CUBE_SIDE_BACK].blocks[col][i]=c;
-                }
+                cube_turn(cube,CUBE_AXIS_X,col,1);
                 break;
         case CUBE_DIRECTION_DOWN:
-                if(!col){
-                        rotate_face(&cube->face[CUBE_SIDE_LEFT],CUBE_DIRECTION_CW);
-                }
-                if(col==CUBE_SIZE-1){
-                        rotate_face(&cube->face[CUBE_SIDE_RIGHT],CUBE_DIRECTION_CCW);
-                }
-                for(i=0;i<CUBE_SIZE;i++){
-                        c=cube->face[CUBE_SIDE_BOTTOM].blocks[col][i];
-                        cube->face[CUBE_SIDE_BOTTOM].blocks[col][i]=cube->face[CUBE_SIDE_FRONT].blocks[col][i];
-                        cube->face[CUBE_SIDE_FRONT].blocks[col][i]=cube->face[CUBE_SIDE_TOP].blocks[col][i];
-                        cube->face[CUBE_SIDE_TOP].blocks[col][i]=cube->face[CUBE_SIDE_BACK].blocks[col][i];
-                        cube->face[CUBE_SIDE_BACK].blocks[col][i]=c;
-                }
+                cube_turn(cube,CUBE_AXIS_X,col,3);
+                break;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates a slice parallel to the front face.
+**
+**  @param[in] cube A cube to rotate.
+**  @param[in] slice A slice to rotate, 0 being the front face.
+**  @param[in] dir Rotation direction seen from the front (clockwise or
+**  counter-clockwise).
+*/
+static void
+rotate_slice(
+        Cube_t *cube,
+        uint8_t slice,
+        CubeDirection_t dir
+)
+{
+        switch(dir){
+        default:return;
+        case CUBE_DIRECTION_CW:
+                cube_turn(cube,CUBE_AXIS_Z,slice,1);
+                break;
+        case CUBE_DIRECTION_CCW:
+                cube_turn(cube,CUBE_AXIS_Z,slice,3);
                 break;
         }
 }
@@ -221,24 +556,118 @@ rotate_column(
 **
 **  A face is solved when all of its blocks are of the same color.
 */
-static bool
+static inline bool
 check_face(
         CubeFace_t *face
 )
 {
-        uint8_t i;
-        uint8_t j;
         CubeColor_t c;
 
         c=face->blocks[0][0];
+        return (face->colorCount[COLOR_WORD(c)]&colorUnit[c]*COLOR_FIELD_MASK)==
+               colorUnit[c]*CUBE_SIZE*CUBE_SIZE;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Cycles four blocks of a layer and counts their colors.
+**
+**  @param[in,out] layer A layer turn. The blocks are added to the color
+**                       counts.
+**  @param[in] pa Position of the block on the first face of the ring.
+**  @param[in] pb Position of the block on the second face.
+**  @param[in] pc Position of the block on the third face.
+**  @param[in] pd Position of the block on the fourth face.
+**  @param[in] turns Quarter turns (1-3).
+*/
+static FORCE_INLINE void
+cycle_layer_blocks(
+        LayerTurn_t *layer,
+        int32_t pa,
+        int32_t pb,
+        int32_t pc,
+        int32_t pd,
+        uint8_t turns
+)
+{
+        CubeColor_t *a;
+        CubeColor_t *b;
+        CubeColor_t *c;
+        CubeColor_t *d;
+        CubeColor_t v[4];
+
+        a=&layer->ring[0]->blocks[0][0]+pa;
+        b=&layer->ring[1]->blocks[0][0]+pb;
+        c=&layer->ring[2]->blocks[0][0]+pc;
+        d=&layer->ring[3]->blocks[0][0]+pd;
+        v[0]=*a;
+        v[1]=*b;
+        v[2]=*c;
+        v[3]=*d;
+        *a=v[turns&3];
+        *b=v[(turns+1)&3];
+        *c=v[(turns+2)&3];
+        *d=v[(turns+3)&3];
+        layer->strip[0][COLOR_WORD(v[0])]+=colorUnit[v[0]];
+        layer->strip[1][COLOR_WORD(v[1])]+=colorUnit[v[1]];
+        layer->strip[2][COLOR_WORD(v[2])]+=colorUnit[v[2]];
+        layer->strip[3][COLOR_WORD(v[3])]+=colorUnit[v[3]];
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Cycles the blocks of a layer and counts their colors.
+**
+**  With one quarter turn each block gets the color of the block on the next
+**  face of the ring.
+**
+**  @param[in,out] layer A layer turn with the faces of the ring. The color
+**                       counts are set.
+**  @param[in] axis Axis of the layer.
+**  @param[in] index Index of the layer along the axis.
+**  @param[in] turns Quarter turns (1-3).
+*/
+static void
+cycle_layer(
+        LayerTurn_t *layer,
+        CubeAxis_t axis,
+        uint8_t index,
+        uint8_t turns
+)
+{
+#if !TURN_TABLES
+        uint8_t i;
+        uint8_t k;
+#endif
+
+        memset(layer->strip,0,sizeof(layer->strip));
+#if TURN_TABLES
+        layer->cycle=layerCycle[axis][index];
+        switch(turns){
+        default:break;
+        case 1:
+                FOR_EACH_BLOCK(CYCLE_LAYER_BLOCKS,layer,1)
+                break;
+        case 2:
+                FOR_EACH_BLOCK(CYCLE_LAYER_BLOCKS,layer,2)
+                break;
+        case 3:
+                FOR_EACH_BLOCK(CYCLE_LAYER_BLOCKS,layer,3)
+                break;
+        }
+#else
+        for(k=0;k<4;k++){
+                layer->first[k]=LAYER_POSITION(axis,index,k,0);
+                layer->step[k]=LAYER_POSITION(axis,index,k,1)-layer->first[k];
+        }
         for(i=0;i<CUBE_SIZE;i++){
-                for(j=0;j<CUBE_SIZE;j++){
-                        if(face->blocks[i][j]!=c){
-                                return false;
-                        }
-                }
+                cycle_layer_blocks(
+                        layer,
+                        layer->first[0]+i*layer->step[0],
+                        layer->first[1]+i*layer->step[1],
+                        layer->first[2]+i*layer->step[2],
+                        layer->first[3]+i*layer->step[3],
+                        turns);
         }
-        return true;
+#endif
 }
 
 /*-------------------------------------------------------------------------*//**
@@ -264,29 +693,59 @@ copy_face(
 
 void
 cube_shuffle(
-        Cube_t *cube
+        Cube_t *cube,
+        CubeRandom_t *random,
+        uint32_t length,
+        CubeMove_t *moves
 )
 {
+        CubeMove_t m;
         uint32_t i;
-        uint8_t j;
-        uint8_t row;
-        uint8_t col;
-        CubeDirection_t dir;
-        time_t t;
-
-        srand((unsigned int)time(&t));
-        for(i=0;i<1000;i++){
-                row=rand()%(CUBE_SIZE-1);
-                col=rand()%(CUBE_SIZE-1);
-                dir=rand()%(CUBE_DIRECTION_COUNT-1);
-                for(j=0;j<rand()%(CUBE_SIZE-1);j++){
-                        rotate_row(cube,row,dir);
-                        rotate_column(cube,col,dir);
-                        cube_rotate_front_face(cube,dir);
+        uint8_t axis;
+        uint8_t layer;
+
+        axis=CUBE_AXIS_COUNT;
+        layer=0;
+        for(i=0;i<length;i++){
+                // Moves of the same axis commute, so they are only made in the
+                // order of the layers. This also keeps a move from being
+                // followed by another move of the same layer.
+                do{
+                        m.axis=(uint8_t)cube_random_below(random,CUBE_AXIS_COUNT);
+                        m.first=(uint8_t)cube_random_below(random,SHUFFLE_LAYER_COUNT);
+                }while(m.axis==axis&&m.first<=layer);
+                axis=m.axis;
+                layer=m.first;
+                if(CUBE_SIZE%2&&m.first>=CUBE_SIZE/2){
+                        m.first++;
+                }
+                m.last=m.first;
+                m.turns=(uint8_t)(cube_random_below(random,3)+1);
+                if(cube){
+                        cube_turn(cube,(CubeAxis_t)m.axis,m.first,m.turns);
+                }
+                if(moves){
+                        moves[i]=m;
                 }
         }
 }
 
+#if CUBE_SIZE==3
+
+void
+cube_shuffle_state(
+        Cube_t *cube,
+        CubeRandom_t *random
+)
+{
+        CubeCubie_t cubie;
+
+        cube_cubie_random(&cubie,random);
+        cube_cubie_to_cube(&cubie,cube);
+}
+
+#endif // if CUBE_SIZE==3
+
 void 
 cube_reset(
         Cube_t *cube
@@ -305,6 +764,33 @@ cube_reset(
         }
         cube->row=0;
         cube->col=0;
+        cube_recount(cube);
+}
+
+void
+cube_recount(
+        Cube_t *cube
+)
+{
+        CubeFace_t *face;
+        CubeColor_t c;
+        uint8_t i;
+        uint8_t j;
+        uint8_t k;
+
+        cube->solvedFaces=0;
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                face=&cube->face[i];
+                memset(face->colorCount,0,sizeof(face->colorCount));
+                for(j=0;j<CUBE_SIZE;j++){
+                        for(k=0;k<CUBE_SIZE;k++){
+                                c=face->blocks[j][k];
+                                face->colorCount[COLOR_WORD(c)]+=colorUnit[c];
+                        }
+                }
+                face->isSolved=check_face(face);
+                cube->solvedFaces+=face->isSolved;
+        }
 }
 
 void 
@@ -339,12 +825,10 @@ cube_rotate(
                 copy_face(&cube->face[CUBE_SIDE_LEFT],&f);
                 copy_face(&cube->face[CUBE_SIDE_FRONT],&cube->face[CUBE_SIDE_LEFT]);
                 copy_face(&cube->face[CUBE_SIDE_RIGHT],&cube->face[CUBE_SIDE_FRONT]);
-                rotate_face(&cube->face[CUBE_SIDE_BACK],CUBE_DIRECTION_CW);
-                rotate_face(&cube->face[CUBE_SIDE_BACK],CUBE_DIRECTION_CW);
+                turn_face(&cube->face[CUBE_SIDE_BACK],2);
                 copy_face(&cube->face[CUBE_SIDE_BACK],&cube->face[CUBE_SIDE_RIGHT]);
                 copy_face(&f,&cube->face[CUBE_SIDE_BACK]);
-                rotate_face(&cube->face[CUBE_SIDE_BACK],CUBE_DIRECTION_CW);
-                rotate_face(&cube->face[CUBE_SIDE_BACK],CUBE_DIRECTION_CW);
+                turn_face(&cube->face[CUBE_SIDE_BACK],2);
                 rotate_face(&cube->face[CUBE_SIDE_TOP],CUBE_DIRECTION_CW);
                 rotate_face(&cube->face[CUBE_SIDE_BOTTOM],CUBE_DIRECTION_CCW);
                 break;
@@ -352,12 +836,10 @@ cube_rotate(
                 copy_face(&cube->face[CUBE_SIDE_RIGHT],&f);
                 copy_face(&cube->face[CUBE_SIDE_FRONT],&cube->face[CUBE_SIDE_RIGHT]);
                 copy_face(&cube->face[CUBE_SIDE_LEFT],&cube->face[CUBE_SIDE_FRONT]);
-                rotate_face(&cube->face[CUBE_SIDE_BACK],CUBE_DIRECTION_CW);
-                rotate_face(&cube->face[CUBE_SIDE_BACK],CUBE_DIRECTION_CW);
+                turn_face(&cube->face[CUBE_SIDE_BACK],2);
                 copy_face(&cube->face[CUBE_SIDE_BACK],&cube->face[CUBE_SIDE_LEFT]);
                 copy_face(&f,&cube->face[CUBE_SIDE_BACK]);
-                rotate_face(&cube->face[CUBE_SIDE_BACK],CUBE_DIRECTION_CW);
-                rotate_face(&cube->face[CUBE_SIDE_BACK],CUBE_DIRECTION_CW);
+                turn_face(&cube->face[CUBE_SIDE_BACK],2);
                 rotate_face(&cube->face[CUBE_SIDE_TOP],CUBE_DIRECTION_CCW);
                 rotate_face(&cube->face[CUBE_SIDE_BOTTOM],CUBE_DIRECTION_CW);
                 break;
@@ -388,31 +870,108 @@ cube_rotate_front_face(
         CubeDirection_t dir
 )
 {
-        uint8_t i;
-        CubeColor_t c;
+        rotate_slice(cube,0,dir);
+}
 
-        switch(dir){
+void
+cube_apply_moves(
+        Cube_t *cube,
+        CubeMove_t *moves,
+        uint32_t count
+)
+{
+        uint32_t i;
+        uint16_t layer;
+
+        for(i=0;i<count;i++){
+                for(layer=moves[i].first;layer<=moves[i].last&&layer<CUBE_SIZE;layer++){
+                        cube_turn(cube,(CubeAxis_t)moves[i].axis,(uint8_t)layer,moves[i].turns);
+                }
+        }
+}
+
+void
+cube_turn(
+        Cube_t *cube,
+        CubeAxis_t axis,
+        uint8_t layer,
+        uint8_t turns
+)
+{
+        LayerTurn_t t;
+        CubeFace_t *f;
+        uint8_t solved;
+        uint8_t k;
+        uint8_t w;
+
+        turns&=3;
+        if(!turns||layer>=CUBE_SIZE||axis>=CUBE_AXIS_COUNT){
+                return;
+        }
+        f=cube->face;
+        solved=cube->solvedFaces;
+        for(k=0;k<4;k++){
+                t.ring[k]=&f[layerRing[axis][k]];
+                solved-=t.ring[k]->isSolved;
+        }
+        switch(axis){
         default:return;
-        case CUBE_DIRECTION_CCW:
-                for(i=0;i<CUBE_SIZE;i++){
-                        c=cube->face[CUBE_SIDE_TOP].blocks[i][CUBE_SIZE-1];
-                        cube->face[CUBE_SIDE_TOP].blocks[i][CUBE_SIZE-1]=cube->face[CUBE_SIDE_RIGHT].blocks[0][i];
-                        cube->face[CUBE_SIDE_RIGHT].blocks[0][i]=cube->face[CUBE_SIDE_BOTTOM].blocks[CUBE_SIZE-1-i][0];
-                        cube->face[CUBE_SIDE_BOTTOM].blocks[CUBE_SIZE-1-i][0]=cube->face[CUBE_SIDE_LEFT].blocks[CUBE_SIZE-1][CUBE_SIZE-1-i];
-                        cube->face[CUBE_SIDE_LEFT].blocks[CUBE_SIZE-1][CUBE_SIZE-1-i]=c;
+        case CUBE_AXIS_X:
+                if(!layer){
+                        turn_face(&f[CUBE_SIDE_LEFT],4-turns);
+                }
+                if(layer==CUBE_SIZE-1){
+                        turn_face(&f[CUBE_SIDE_RIGHT],turns);
                 }
                 break;
-        case CUBE_DIRECTION_CW:
-                for(i=0;i<CUBE_SIZE;i++){
-                        c=cube->face[CUBE_SIDE_TOP].blocks[i][CUBE_SIZE-1];
-                        cube->face[CUBE_SIDE_TOP].blocks[i][CUBE_SIZE-1]=cube->face[CUBE_SIDE_LEFT].blocks[CUBE_SIZE-1][CUBE_SIZE-1-i];
-                        cube->face[CUBE_SIDE_LEFT].blocks[CUBE_SIZE-1][CUBE_SIZE-1-i]=cube->face[CUBE_SIDE_BOTTOM].blocks[CUBE_SIZE-1-i][0];
-                        cube->face[CUBE_SIDE_BOTTOM].blocks[CUBE_SIZE-1-i][0]=cube->face[CUBE_SIDE_RIGHT].blocks[0][i];
-                        cube->face[CUBE_SIDE_RIGHT].blocks[0][i]=c;
+        case CUBE_AXIS_Y:
+                if(!layer){
+                        turn_face(&f[CUBE_SIDE_TOP],turns);
+                }
+                if(layer==CUBE_SIZE-1){
+                        turn_face(&f[CUBE_SIDE_BOTTOM],4-turns);
+                }
+                break;
+        case CUBE_AXIS_Z:
+                if(!layer){
+                        turn_face(&f[CUBE_SIDE_FRONT],turns);
+                }
+                if(layer==CUBE_SIZE-1){
+                        turn_face(&f[CUBE_SIDE_BACK],4-turns);
                 }
                 break;
         }
-        rotate_face(&cube->face[CUBE_SIDE_FRONT],dir);
+        cycle_layer(&t,axis,layer,turns);
+
+        // Each face of the ring gets the colors of the layer blocks of the
+        // face the blocks came from. A field may borrow from the next one in
+        // between, but the sums are exact, as no count is ever negative.
+        for(k=0;k<4;k++){
+                for(w=0;w<CUBE_COLOR_WORD_COUNT;w++){
+                        t.ring[k]->colorCount[w]+=t.strip[(k+turns)%4][w]-t.strip[k][w];
+                }
+        }
+        for(k=0;k<4;k++){
+                t.ring[k]->isSolved=check_face(t.ring[k]);
+                solved+=t.ring[k]->isSolved;
+        }
+        cube->solvedFaces=solved;
+}
+
+void
+cube_apply_turns(
+        Cube_t *cube,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                if(turns[i]<CUBE_TURN_COUNT){
+                        cube_turn(cube,(CubeAxis_t)turnMoves[turns[i]].axis,turnMoves[turns[i]].first,turnMoves[turns[i]].turns);
+                }
+        }
 }
 
 bool
@@ -420,14 +979,44 @@ cube_is_solved(
         Cube_t *cube
 )
 {
+        return cube->solvedFaces==CUBE_SIDE_COUNT;
+}
+
+uint64_t
+cube_get_hash(
+        Cube_t *cube
+)
+{
+        CubeFace_t *face;
+        CubeColor_t c;
+        uint64_t faceHash;
+        uint64_t hash;
         uint8_t i;
+        uint8_t j;
+        uint8_t k;
 
+        init_keys();
+        hash=0;
         for(i=0;i<CUBE_SIDE_COUNT;i++){
-                if(!check_face(&cube->face[i])){
-                        return false;
+                face=&cube->face[i];
+                faceHash=0;
+                for(j=0;j<CUBE_SIZE;j++){
+                        for(k=0;k<CUBE_SIZE;k++){
+                                c=face->blocks[j][k];
+                                faceHash^=blockKey[j*CUBE_SIZE+k][c];
+                        }
                 }
+                hash^=mix_face_hash(faceHash,i);
         }
-        return true;
+        return hash;
+}
+
+CubeColor_t
+cube_get_reset_color(
+        CubeSide_t side
+)
+{
+        return resetColors[side];
 }
 
 void 
@@ -0,0 +1,700 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_batch.c
+**  @ingroup    rubicscube
+**  @brief      Batches of cubes in structure-of-arrays layout.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_batch.h"
+#include "rubics_cube_thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Number of stickers of a face.
+#define FACE_STICKERS (CUBE_SIZE*CUBE_SIZE)
+
+/// The most planes an outer layer turn moves: the face and the four strips
+///of the layer.
+#define TURN_PLANE_MAX (FACE_STICKERS+4*CUBE_SIZE)
+
+/// Tells the compiler that the pointers of a function do not overlap, so
+///the loops over them are vectorized without checks.
+#if defined(_MSC_VER)
+#define RESTRICT __restrict
+#else
+#define RESTRICT restrict
+#endif
+
+/// States of the turn tables.
+#define TABLES_NONE 0
+#define TABLES_BUILDING 1
+#define TABLES_READY 2
+
+/// Position of block i of a layer on face k of the ring of the axis, the
+///same as in cube_turn().
+#define LAYER_POSITION(axis,layer,k,i) \
+        ((axis)==CUBE_AXIS_X?(layer)*CUBE_SIZE+(i):\
+         (axis)==CUBE_AXIS_Y?((k)<3?(i)*CUBE_SIZE+(layer):\
+                (CUBE_SIZE-1-(i))*CUBE_SIZE+CUBE_SIZE-1-(layer)):\
+         (k)==0?(i)*CUBE_SIZE+CUBE_SIZE-1-(layer):\
+         (k)==1?(CUBE_SIZE-1-(layer))*CUBE_SIZE+CUBE_SIZE-1-(i):\
+         (k)==2?(CUBE_SIZE-1-(i))*CUBE_SIZE+(layer):\
+         (layer)*CUBE_SIZE+(i))
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Layer moves of the outer layer turns.
+*/
+static const CubeMove_t
+turnMoves[CUBE_TURN_COUNT]={
+        {CUBE_AXIS_Y,0,0,1}, // U
+        {CUBE_AXIS_Y,0,0,2}, // U2
+        {CUBE_AXIS_Y,0,0,3}, // U'
+        {CUBE_AXIS_X,CUBE_SIZE-1,CUBE_SIZE-1,1}, // R
+        {CUBE_AXIS_X,CUBE_SIZE-1,CUBE_SIZE-1,2}, // R2
+        {CUBE_AXIS_X,CUBE_SIZE-1,CUBE_SIZE-1,3}, // R'
+        {CUBE_AXIS_Z,0,0,1}, // F
+        {CUBE_AXIS_Z,0,0,2}, // F2
+        {CUBE_AXIS_Z,0,0,3}, // F'
+        {CUBE_AXIS_Y,CUBE_SIZE-1,CUBE_SIZE-1,3}, // D
+        {CUBE_AXIS_Y,CUBE_SIZE-1,CUBE_SIZE-1,2}, // D2
+        {CUBE_AXIS_Y,CUBE_SIZE-1,CUBE_SIZE-1,1}, // D'
+        {CUBE_AXIS_X,0,0,3}, // L
+        {CUBE_AXIS_X,0,0,2}, // L2
+        {CUBE_AXIS_X,0,0,1}, // L'
+        {CUBE_AXIS_Z,CUBE_SIZE-1,CUBE_SIZE-1,3}, // B
+        {CUBE_AXIS_Z,CUBE_SIZE-1,CUBE_SIZE-1,2}, // B2
+        {CUBE_AXIS_Z,CUBE_SIZE-1,CUBE_SIZE-1,1} // B'
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Faces around the layers of each axis, in the order the planes of
+**  a layer are cycled.
+*/
+static const CubeSide_t
+layerRing[CUBE_AXIS_COUNT][4]={
+        {CUBE_SIDE_TOP,CUBE_SIDE_FRONT,CUBE_SIDE_BOTTOM,CUBE_SIDE_BACK}, // X
+        {CUBE_SIDE_LEFT,CUBE_SIDE_FRONT,CUBE_SIDE_RIGHT,CUBE_SIDE_BACK}, // Y
+        {CUBE_SIDE_TOP,CUBE_SIDE_LEFT,CUBE_SIDE_BOTTOM,CUBE_SIDE_RIGHT} // Z
+};
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Index of a sticker plane.
+*/
+#if CUBE_PACKED_STICKERS<=0x10000
+typedef uint16_t PlaneIndex_t;
+#else
+typedef uint32_t PlaneIndex_t;
+#endif
+
+/******************************************************************************\
+**
+**  LOCAL VARIABLES
+**
+\******************************************************************************/
+
+/// Planes moved by each outer layer turn, and the plane each of them gets
+///its stickers from.
+static PlaneIndex_t turnPlane[CUBE_TURN_COUNT][TURN_PLANE_MAX];
+static PlaneIndex_t turnSource[CUBE_TURN_COUNT][TURN_PLANE_MAX];
+
+/// Number of planes moved by each outer layer turn.
+static uint32_t turnPlaneCount[CUBE_TURN_COUNT];
+
+/// State of the turn tables (TABLES_NONE, TABLES_BUILDING or TABLES_READY).
+static volatile uint32_t tableState=TABLES_NONE;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Cycles four blocks of bytes.
+**
+**  With one quarter turn each block gets the bytes of the next one, and the
+**  last block gets the bytes of the first one. The function is inlined with
+**  a constant length, so the copies are vector moves.
+**
+**  @param[in] a The first block.
+**  @param[in] b The second block.
+**  @param[in] c The third block.
+**  @param[in] d The fourth block.
+**  @param[in] n Length of the blocks (1 - CUBE_BATCH_ALIGN).
+**  @param[in] turns Quarter turns (1-3).
+*/
+static inline void
+cycle_block(
+        uint8_t *a,
+        uint8_t *b,
+        uint8_t *c,
+        uint8_t *d,
+        uint32_t n,
+        uint8_t turns
+)
+{
+        uint8_t t[CUBE_BATCH_ALIGN];
+        uint8_t u[CUBE_BATCH_ALIGN];
+
+        switch(turns){
+        default:return;
+        case 1:
+                memcpy(t,a,n);
+                memcpy(a,b,n);
+                memcpy(b,c,n);
+                memcpy(c,d,n);
+                memcpy(d,t,n);
+                break;
+        case 2:
+                memcpy(t,a,n);
+                memcpy(u,b,n);
+                memcpy(a,c,n);
+                memcpy(b,d,n);
+                memcpy(c,t,n);
+                memcpy(d,u,n);
+                break;
+        case 3:
+                memcpy(t,d,n);
+                memcpy(d,c,n);
+                memcpy(c,b,n);
+                memcpy(b,a,n);
+                memcpy(a,t,n);
+                break;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Cycles four planes.
+**
+**  The planes are moved CUBE_BATCH_ALIGN bytes at a time, and the bytes after
+**  the last whole block one by one. Only the turn tables are built with
+**  planes of less than a block.
+**
+**  @param[in] a The first plane.
+**  @param[in] b The second plane.
+**  @param[in] c The third plane.
+**  @param[in] d The fourth plane.
+**  @param[in] bytes Bytes per plane.
+**  @param[in] turns Quarter turns (1-3).
+*/
+static void
+cycle_planes(
+        uint8_t *a,
+        uint8_t *b,
+        uint8_t *c,
+        uint8_t *d,
+        uint32_t bytes,
+        uint8_t turns
+)
+{
+        uint32_t k;
+
+        for(k=0;k+CUBE_BATCH_ALIGN<=bytes;k+=CUBE_BATCH_ALIGN){
+                cycle_block(a+k,b+k,c+k,d+k,CUBE_BATCH_ALIGN,turns);
+        }
+        for(;k<bytes;k++){
+                cycle_block(a+k,b+k,c+k,d+k,1,turns);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns the planes of a face in place.
+**
+**  @param[in] face The first plane of the face.
+**  @param[in] bytes Bytes per plane.
+**  @param[in] turns Clockwise quarter turns (1-3).
+*/
+static void
+turn_face(
+        uint8_t *face,
+        uint32_t bytes,
+        uint8_t turns
+)
+{
+        uint8_t i;
+        uint8_t j;
+
+        for(i=0;i<CUBE_SIZE/2;i++){
+                for(j=i;j<CUBE_SIZE-1-i;j++){
+                        cycle_planes(
+                                face+(size_t)(i*CUBE_SIZE+j)*bytes,
+                                face+(size_t)(j*CUBE_SIZE+CUBE_SIZE-1-i)*bytes,
+                                face+(size_t)((CUBE_SIZE-1-i)*CUBE_SIZE+CUBE_SIZE-1-j)*bytes,
+                                face+(size_t)((CUBE_SIZE-1-j)*CUBE_SIZE+i)*bytes,
+                                bytes,
+                                turns);
+                }
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns one layer of the planes.
+**
+**  @param[in] sticker The first plane.
+**  @param[in] bytes Bytes per plane.
+**  @param[in] axis Axis of the layer.
+**  @param[in] layer Index of the layer (0 - CUBE_SIZE-1).
+**  @param[in] turns Quarter turns (1-3).
+*/
+static void
+turn_planes(
+        uint8_t *sticker,
+        uint32_t bytes,
+        CubeAxis_t axis,
+        uint8_t layer,
+        uint8_t turns
+)
+{
+        uint8_t *ring[4];
+        int32_t step[4];
+        size_t face;
+        uint8_t i;
+        uint8_t k;
+
+        face=(size_t)FACE_STICKERS*bytes;
+        switch(axis){
+        default:return;
+        case CUBE_AXIS_X:
+                if(!layer){
+                        turn_face(sticker+CUBE_SIDE_LEFT*face,bytes,4-turns);
+                }
+                if(layer==CUBE_SIZE-1){
+                        turn_face(sticker+CUBE_SIDE_RIGHT*face,bytes,turns);
+                }
+                break;
+        case CUBE_AXIS_Y:
+                if(!layer){
+                        turn_face(sticker+CUBE_SIDE_TOP*face,bytes,turns);
+                }
+                if(layer==CUBE_SIZE-1){
+                        turn_face(sticker+CUBE_SIDE_BOTTOM*face,bytes,4-turns);
+                }
+                break;
+        case CUBE_AXIS_Z:
+                if(!layer){
+                        turn_face(sticker+CUBE_SIDE_FRONT*face,bytes,turns);
+                }
+                if(layer==CUBE_SIZE-1){
+                        turn_face(sticker+CUBE_SIDE_BACK*face,bytes,4-turns);
+                }
+                break;
+        }
+        for(k=0;k<4;k++){
+                ring[k]=sticker+layerRing[axis][k]*face+
+                        (size_t)LAYER_POSITION(axis,layer,k,0)*bytes;
+                step[k]=(LAYER_POSITION(axis,layer,k,1)-LAYER_POSITION(axis,layer,k,0))*
+                        (int32_t)bytes;
+        }
+        for(i=0;i<CUBE_SIZE;i++){
+                cycle_planes(ring[0],ring[1],ring[2],ring[3],bytes,turns);
+                for(k=0;k<4;k++){
+                        ring[k]+=step[k];
+                }
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Builds the tables of the planes moved by the outer layer turns.
+**
+**  Each turn is applied to planes of one label each, the label being the
+**  index of the plane, so the result is the source of every plane.
+*/
+static void
+build_tables(
+        void
+)
+{
+        // Too large for the stack of a big cube.
+        static PlaneIndex_t label[CUBE_PACKED_STICKERS];
+        const CubeMove_t *m;
+        uint32_t i;
+        uint32_t n;
+        uint8_t t;
+
+        for(t=0;t<CUBE_TURN_COUNT;t++){
+                for(i=0;i<CUBE_PACKED_STICKERS;i++){
+                        label[i]=(PlaneIndex_t)i;
+                }
+                m=&turnMoves[t];
+                turn_planes((uint8_t *)label,sizeof(PlaneIndex_t),(CubeAxis_t)m->axis,
+                        m->first,m->turns);
+                n=0;
+                for(i=0;i<CUBE_PACKED_STICKERS;i++){
+                        if(label[i]!=i){
+                                turnPlane[t][n]=(PlaneIndex_t)i;
+                                turnSource[t][n]=label[i];
+                                n++;
+                        }
+                }
+                turnPlaneCount[t]=n;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Builds the turn tables once.
+**
+**  The first thread to get here builds the tables, and any other thread
+**  waits for them.
+*/
+static void
+init_tables(
+        void
+)
+{
+        if(cube_atomic_load(&tableState)==TABLES_READY){
+                return;
+        }
+        if(cube_atomic_compare_swap(&tableState,TABLES_NONE,TABLES_BUILDING)){
+                build_tables();
+                cube_atomic_store(&tableState,TABLES_READY);
+                return;
+        }
+        while(cube_atomic_load(&tableState)!=TABLES_READY){
+                cube_thread_yield();
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Copies a block of a plane to the lanes of a turn.
+**
+**  The lanes are selected with a mask instead of a branch, so the loop is
+**  vectorized.
+**
+**  @param[in,out] dest A block of the destination plane.
+**  @param[in] src The block of the source plane.
+**  @param[in] mask 0xFF for each lane of the turn and 0 for the others.
+*/
+static inline void
+blend_block(
+        uint8_t *RESTRICT dest,
+        const uint8_t *RESTRICT src,
+        const uint8_t *RESTRICT mask
+)
+{
+        uint8_t i;
+
+        for(i=0;i<CUBE_BATCH_ALIGN;i++){
+                dest[i]^=(dest[i]^src[i])&mask[i];
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Clears the flags of the lanes where two blocks of planes differ.
+**
+**  @param[in,out] flag A flag for each lane of the block, 1 or 0.
+**  @param[in] a A block of a plane.
+**  @param[in] b The block of another plane.
+*/
+static inline void
+match_block(
+        uint8_t *RESTRICT flag,
+        const uint8_t *RESTRICT a,
+        const uint8_t *RESTRICT b
+)
+{
+        uint8_t i;
+
+        for(i=0;i<CUBE_BATCH_ALIGN;i++){
+                flag[i]&=a[i]==b[i];
+        }
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_batch_init(
+        CubeBatch_t *batch,
+        uint32_t count
+)
+{
+        size_t stride;
+        size_t planes;
+
+        memset(batch,0,sizeof(CubeBatch_t));
+        if(!count||count>UINT32_MAX-CUBE_BATCH_ALIGN){
+                return false;
+        }
+        stride=(count+CUBE_BATCH_ALIGN-1)/CUBE_BATCH_ALIGN*CUBE_BATCH_ALIGN;
+        planes=2*CUBE_PACKED_STICKERS+1;
+        if(stride>(SIZE_MAX-CUBE_BATCH_ALIGN)/planes){
+                return false;
+        }
+        batch->memory=malloc(stride*planes+CUBE_BATCH_ALIGN);
+        if(!batch->memory){
+                return false;
+        }
+        batch->sticker=(uint8_t *)(((uintptr_t)batch->memory+CUBE_BATCH_ALIGN-1)&
+                ~(uintptr_t)(CUBE_BATCH_ALIGN-1));
+        batch->spare=batch->sticker+stride*CUBE_PACKED_STICKERS;
+        batch->lane=batch->spare+stride*CUBE_PACKED_STICKERS;
+        batch->count=count;
+        batch->stride=(uint32_t)stride;
+        init_tables();
+        cube_batch_reset(batch);
+        return true;
+}
+
+void
+cube_batch_free(
+        CubeBatch_t *batch
+)
+{
+        free(batch->memory);
+        memset(batch,0,sizeof(CubeBatch_t));
+}
+
+void
+cube_batch_reset(
+        CubeBatch_t *batch
+)
+{
+        uint8_t i;
+
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                memset(batch->sticker+(size_t)i*FACE_STICKERS*batch->stride,
+                        cube_get_reset_color((CubeSide_t)i),(size_t)FACE_STICKERS*batch->stride);
+        }
+}
+
+void
+cube_batch_set_cube(
+        CubeBatch_t *batch,
+        uint32_t lane,
+        Cube_t *cube
+)
+{
+        uint8_t *s;
+        uint8_t i;
+        uint8_t x;
+        uint8_t y;
+
+        s=batch->sticker+lane;
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                for(x=0;x<CUBE_SIZE;x++){
+                        for(y=0;y<CUBE_SIZE;y++){
+                                s[(size_t)CUBE_PACKED_INDEX(i,x,y)*batch->stride]=
+                                        (uint8_t)cube->face[i].blocks[x][y];
+                        }
+                }
+        }
+}
+
+void
+cube_batch_get_cube(
+        CubeBatch_t *batch,
+        uint32_t lane,
+        Cube_t *cube
+)
+{
+        uint8_t *s;
+        uint8_t i;
+        uint8_t x;
+        uint8_t y;
+
+        s=batch->sticker+lane;
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                for(x=0;x<CUBE_SIZE;x++){
+                        for(y=0;y<CUBE_SIZE;y++){
+                                cube->face[i].blocks[x][y]=
+                                        (CubeColor_t)s[(size_t)CUBE_PACKED_INDEX(i,x,y)*batch->stride];
+                        }
+                }
+        }
+        cube_recount(cube);
+}
+
+void
+cube_batch_turn(
+        CubeBatch_t *batch,
+        CubeAxis_t axis,
+        uint8_t layer,
+        uint8_t turns
+)
+{
+        turns&=3;
+        if(!turns||layer>=CUBE_SIZE||axis>=CUBE_AXIS_COUNT){
+                return;
+        }
+        turn_planes(batch->sticker,batch->stride,axis,layer,turns);
+}
+
+void
+cube_batch_apply_moves(
+        CubeBatch_t *batch,
+        CubeMove_t *moves,
+        uint32_t count
+)
+{
+        uint32_t i;
+        uint16_t layer;
+
+        for(i=0;i<count;i++){
+                for(layer=moves[i].first;layer<=moves[i].last&&layer<CUBE_SIZE;layer++){
+                        cube_batch_turn(batch,(CubeAxis_t)moves[i].axis,(uint8_t)layer,moves[i].turns);
+                }
+        }
+}
+
+void
+cube_batch_apply_turns(
+        CubeBatch_t *batch,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                if(turns[i]<CUBE_TURN_COUNT){
+                        cube_batch_turn(batch,(CubeAxis_t)turnMoves[turns[i]].axis,
+                                turnMoves[turns[i]].first,turnMoves[turns[i]].turns);
+                }
+        }
+}
+
+void
+cube_batch_turn_lanes(
+        CubeBatch_t *batch,
+        CubeTurn_t *turns
+)
+{
+        uint8_t mask[CUBE_BATCH_ALIGN];
+        uint8_t *swap;
+        uint8_t *l;
+        uint32_t used;
+        uint32_t k;
+        uint32_t j;
+        uint8_t t;
+
+        // The turns are gathered to bytes, and the turns in use to a mask.
+        used=0;
+        for(k=0;k<batch->count;k++){
+                t=(uint8_t)(turns[k]<CUBE_TURN_COUNT?turns[k]:CUBE_TURN_COUNT);
+                batch->lane[k]=t;
+                used|=(uint32_t)1<<t;
+        }
+        memset(batch->lane+batch->count,CUBE_TURN_COUNT,batch->stride-batch->count);
+        if(!(used&(used-1))){
+                // Every cube takes the same turn, or none.
+                if(used&(((uint32_t)1<<CUBE_TURN_COUNT)-1)){
+                        cube_batch_apply_turns(batch,turns,1);
+                }
+                return;
+        }
+
+        // Every plane a turn moves is blended from its source plane to the
+        // lanes of the turn, into the spare planes. This is done one block of
+        // lanes at a time, so the planes of the block stay in the cache.
+        for(k=0;k<batch->stride;k+=CUBE_BATCH_ALIGN){
+                l=batch->lane+k;
+                used=0;
+                for(j=0;j<CUBE_BATCH_ALIGN;j++){
+                        used|=(uint32_t)1<<l[j];
+                }
+                for(j=0;j<CUBE_PACKED_STICKERS;j++){
+                        memcpy(batch->spare+(size_t)j*batch->stride+k,
+                                batch->sticker+(size_t)j*batch->stride+k,CUBE_BATCH_ALIGN);
+                }
+                for(t=0;t<CUBE_TURN_COUNT;t++){
+                        if(!(used>>t&1)){
+                                continue;
+                        }
+                        for(j=0;j<CUBE_BATCH_ALIGN;j++){
+                                mask[j]=(uint8_t)-(l[j]==t);
+                        }
+                        for(j=0;j<turnPlaneCount[t];j++){
+                                blend_block(
+                                        batch->spare+(size_t)turnPlane[t][j]*batch->stride+k,
+                                        batch->sticker+(size_t)turnSource[t][j]*batch->stride+k,
+                                        mask);
+                        }
+                }
+        }
+        swap=batch->sticker;
+        batch->sticker=batch->spare;
+        batch->spare=swap;
+}
+
+uint32_t
+cube_batch_count_solved(
+        CubeBatch_t *batch,
+        bool *solved
+)
+{
+        uint8_t flag[CUBE_BATCH_ALIGN];
+        uint8_t *first;
+        uint32_t count;
+        uint32_t j;
+        uint32_t k;
+        uint8_t i;
+
+        count=0;
+        for(k=0;k<batch->stride;k+=CUBE_BATCH_ALIGN){
+                memset(flag,1,CUBE_BATCH_ALIGN);
+                for(i=0;i<CUBE_SIDE_COUNT;i++){
+                        first=batch->sticker+(size_t)i*FACE_STICKERS*batch->stride+k;
+                        for(j=1;j<FACE_STICKERS;j++){
+                                match_block(flag,first+(size_t)j*batch->stride,first);
+                        }
+                }
+                for(j=0;j<CUBE_BATCH_ALIGN&&k+j<batch->count;j++){
+                        count+=flag[j];
+                        if(solved){
+                                solved[k+j]=flag[j]!=0;
+                        }
+                }
+        }
+        return count;
+}
\ No newline at end of file
@@ -0,0 +1,920 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_bench_main.c
+**  @ingroup    rubicscube
+**  @brief      Benchmarks of the cube functions.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube.h"
+#include "rubics_cube_sized.h"
+#include "rubics_cube_thread.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Default number of timed samples of each benchmark.
+#define DEFAULT_REPETITIONS 31
+
+/// The most samples of a benchmark.
+#define MAX_REPETITIONS 10000
+
+/// Default warmup time of each benchmark in milliseconds.
+#define DEFAULT_WARMUP_MS 50
+
+/// Default time of one sample in microseconds.
+#define DEFAULT_SAMPLE_US 2000
+
+/// Default sizes of the cubes of any size.
+#define DEFAULT_SIZES "2,3,4,5,6,7,8,16,32,64,128,255"
+
+/// The most sizes on the command line.
+#define MAX_SIZES 256
+
+/// Seed of the shuffles, so every run turns the same moves.
+#define BENCH_SEED 0x5EED5EED5EED5EEDULL
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief State of the benchmarks.
+*/
+typedef struct
+Bench_t{
+        /// A cube of CUBE_SIZE.
+        Cube_t cube;
+        /// A cube of the size being measured.
+        CubeSized_t sized;
+        /// Generator of the shuffles.
+        CubeRandom_t random;
+        /// Sum of the results, so the calls are not optimized away.
+        volatile uint32_t sink;
+} Bench_t;
+
+/**
+**  @brief A function that makes a number of calls of a benchmark.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+typedef void
+(*BenchRun_t)(
+        Bench_t *bench,
+        uint32_t count
+);
+
+/**
+**  @brief A benchmark.
+*/
+typedef struct
+Benchmark_t{
+        /// Name of the operation, the same for both cube types.
+        const char *operation;
+        /// The function measured.
+        const char *function;
+        /// Makes the calls.
+        BenchRun_t run;
+} Benchmark_t;
+
+/**
+**  @brief Options of the benchmarks.
+*/
+typedef struct
+Options_t{
+        /// Number of timed samples.
+        uint32_t repetitions;
+        /// Warmup time in nanoseconds.
+        uint64_t warmup;
+        /// Time of one sample in nanoseconds.
+        uint64_t sampleTime;
+        /// Sizes of the cubes of any size.
+        uint8_t sizes[MAX_SIZES];
+        /// Number of sizes.
+        uint32_t sizeCount;
+        /// Only the operations that contain this text are run, or NULL.
+        char *filter;
+} Options_t;
+
+/**
+**  @brief Statistics of the samples of a benchmark, in nanoseconds per call.
+*/
+typedef struct
+Stats_t{
+        /// Calls per sample.
+        uint32_t iterations;
+        /// The fastest sample.
+        double min;
+        /// Median.
+        double p50;
+        /// 90th percentile.
+        double p90;
+        /// 99th percentile.
+        double p99;
+        /// The slowest sample.
+        double max;
+        /// Mean.
+        double mean;
+        /// Sample standard deviation.
+        double stddev;
+} Stats_t;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Resets the cube, and puts the cursors back in the middle.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_cube_reset(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_reset(&bench->cube);
+        }
+        bench->cube.row=CUBE_SIZE/2;
+        bench->cube.col=CUBE_SIZE/2;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Shuffles the cube with CUBE_SHUFFLE_LENGTH moves.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_cube_shuffle(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_shuffle(&bench->cube,&bench->random,CUBE_SHUFFLE_LENGTH,NULL);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if the cube is solved.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_cube_is_solved(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t sum;
+        uint32_t i;
+
+        sum=0;
+        for(i=0;i<count;i++){
+                sum+=cube_is_solved(&bench->cube);
+        }
+        bench->sink+=sum;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates the whole cube in each direction in turn.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_cube_rotate(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_rotate(&bench->cube,(CubeDirection_t)(CUBE_DIRECTION_LEFT+(i&3)));
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates the row of the cursor left and right in turn.
+**
+**  The cursors are in the middle of the cube, so the row is an inner layer.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_cube_rotate_row(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_rotate_row(&bench->cube,(CubeDirection_t)(CUBE_DIRECTION_LEFT+(i&1)));
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates the column of the cursor up and down in turn.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_cube_rotate_column(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_rotate_column(&bench->cube,(CubeDirection_t)(CUBE_DIRECTION_UP+(i&1)));
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates the front face clockwise and counter-clockwise in turn.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_cube_rotate_front_face(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_rotate_front_face(&bench->cube,(CubeDirection_t)(CUBE_DIRECTION_CW+(i&1)));
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns the first layer of each axis in turn.
+**
+**  The layers are outer layers, so every call also turns a face.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_cube_turn_face(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_turn(&bench->cube,(CubeAxis_t)(i%CUBE_AXIS_COUNT),0,1);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Resets the cube of any size.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_sized_reset(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_sized_reset(&bench->sized);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Shuffles the cube of any size with 10 moves per block of its size.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_sized_shuffle(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_sized_shuffle(&bench->sized,&bench->random,bench->sized.size*10u);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if the cube of any size is solved.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_sized_is_solved(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t sum;
+        uint32_t i;
+
+        sum=0;
+        for(i=0;i<count;i++){
+                sum+=cube_sized_is_solved(&bench->sized);
+        }
+        bench->sink+=sum;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates the whole cube of any size around each axis in turn.
+**
+**  The cube is rotated by turning every layer of the axis.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_sized_rotate(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        CubeMove_t move;
+        uint32_t i;
+
+        move.first=0;
+        move.last=(uint8_t)(bench->sized.size-1);
+        move.turns=1;
+        for(i=0;i<count;i++){
+                move.axis=(uint8_t)(i%CUBE_AXIS_COUNT);
+                cube_sized_apply_moves(&bench->sized,&move,1);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns the middle layer of the Y axis of the cube of any size, like a
+**  row at the cursor of Cube_t.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_sized_rotate_row(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_sized_turn(&bench->sized,CUBE_AXIS_Y,bench->sized.size/2,(uint8_t)(1+(i&1)*2));
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns the middle layer of the X axis of the cube of any size, like a
+**  column at the cursor of Cube_t.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_sized_rotate_column(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_sized_turn(&bench->sized,CUBE_AXIS_X,bench->sized.size/2,(uint8_t)(1+(i&1)*2));
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns the front layer of the cube of any size.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_sized_rotate_front_face(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_sized_turn(&bench->sized,CUBE_AXIS_Z,0,(uint8_t)(1+(i&1)*2));
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns the first layer of each axis of the cube of any size in turn.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] count Number of calls.
+*/
+static void
+run_sized_turn_face(
+        Bench_t *bench,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cube_sized_turn(&bench->sized,(CubeAxis_t)(i%CUBE_AXIS_COUNT),0,1);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Benchmarks of Cube_t.
+*/
+static const Benchmark_t
+cubeBenchmarks[]={
+        {"reset","cube_reset",run_cube_reset},
+        {"shuffle","cube_shuffle",run_cube_shuffle},
+        {"is_solved","cube_is_solved",run_cube_is_solved},
+        {"rotate","cube_rotate",run_cube_rotate},
+        {"rotate_row","cube_rotate_row",run_cube_rotate_row},
+        {"rotate_column","cube_rotate_column",run_cube_rotate_column},
+        {"rotate_front_face","cube_rotate_front_face",run_cube_rotate_front_face},
+        {"turn_face","cube_turn",run_cube_turn_face}
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Benchmarks of CubeSized_t.
+*/
+static const Benchmark_t
+sizedBenchmarks[]={
+        {"reset","cube_sized_reset",run_sized_reset},
+        {"shuffle","cube_sized_shuffle",run_sized_shuffle},
+        {"is_solved","cube_sized_is_solved",run_sized_is_solved},
+        {"rotate","cube_sized_apply_moves",run_sized_rotate},
+        {"rotate_row","cube_sized_turn",run_sized_rotate_row},
+        {"rotate_column","cube_sized_turn",run_sized_rotate_column},
+        {"rotate_front_face","cube_sized_turn",run_sized_rotate_front_face},
+        {"turn_face","cube_sized_turn",run_sized_turn_face}
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Prints the usage.
+**
+**  @param[in] name Program name.
+*/
+static void
+usage(
+        char *name
+)
+{
+        printf("Usage: %s [-r repetitions] [-w warmup-ms] [-t sample-us] [-s sizes]\n",name);
+        printf("       [-b operation] [-o file]\n");
+        printf("\n");
+        printf("Measures the time per call of the cube functions, on the %dx%dx%d cube\n",
+                CUBE_SIZE,CUBE_SIZE,CUBE_SIZE);
+        printf("(Cube_t) and on cubes of any size (CubeSized_t). Each benchmark is\n");
+        printf("warmed up, its calls per sample are set to last the sample time, and\n");
+        printf("the samples are timed. A table is written to the standard error and\n");
+        printf("the results as JSON to the standard output.\n");
+        printf("\n");
+        printf("  -r  Timed samples of each benchmark (%d).\n",DEFAULT_REPETITIONS);
+        printf("  -w  Warmup time of each benchmark in milliseconds (%d).\n",DEFAULT_WARMUP_MS);
+        printf("  -t  Time of one sample in microseconds (%d).\n",DEFAULT_SAMPLE_US);
+        printf("  -s  Comma separated sizes of the cubes of any size, 2-255, or none\n");
+        printf("      (%s).\n",DEFAULT_SIZES);
+        printf("  -b  Run only the operations that contain the text.\n");
+        printf("  -o  Write the JSON to a file.\n");
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Parses a comma separated list of sizes.
+**
+**  @param[out] options The options where to set the sizes.
+**  @param[in] text The list, or "none".
+**
+**  @retval true The list is valid.
+**  @retval false A size is out of range, or there are too many sizes.
+*/
+static bool
+parse_sizes(
+        Options_t *options,
+        const char *text
+)
+{
+        char *end;
+        long size;
+
+        options->sizeCount=0;
+        if(!strcmp(text,"none")){
+                return true;
+        }
+        for(;;){
+                size=strtol(text,&end,10);
+                if(end==text||size<CUBE_SIZED_MIN_SIZE||size>CUBE_SIZED_MAX_SIZE||
+                   options->sizeCount>=MAX_SIZES){
+                        return false;
+                }
+                options->sizes[options->sizeCount++]=(uint8_t)size;
+                if(!*end){
+                        return true;
+                }
+                if(*end!=','){
+                        return false;
+                }
+                text=end+1;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Times a number of calls.
+**
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] run The function that makes the calls.
+**  @param[in] count Number of calls.
+**
+**  @return Time in nanoseconds.
+*/
+static uint64_t
+time_calls(
+        Bench_t *bench,
+        BenchRun_t run,
+        uint32_t count
+)
+{
+        uint64_t start;
+
+        start=cube_thread_clock();
+        run(bench,count);
+        return cube_thread_clock()-start;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Compares two samples for qsort().
+*/
+static int
+compare_samples(
+        const void *a,
+        const void *b
+)
+{
+        double x;
+        double y;
+
+        x=*(const double *)a;
+        y=*(const double *)b;
+        return (x>y)-(x<y);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets a percentile of sorted samples.
+**
+**  The percentile is interpolated between the two closest samples.
+**
+**  @param[in] samples Sorted samples.
+**  @param[in] count Number of samples.
+**  @param[in] p The percentile (0-1).
+**
+**  @return The percentile.
+*/
+static double
+percentile(
+        double *samples,
+        uint32_t count,
+        double p
+)
+{
+        double position;
+        uint32_t i;
+
+        position=p*(count-1);
+        i=(uint32_t)position;
+        if(i+1>=count){
+                return samples[count-1];
+        }
+        return samples[i]+(samples[i+1]-samples[i])*(position-i);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Runs a benchmark.
+**
+**  The calls per sample are doubled until a sample lasts the sample time.
+**  The calls then go on until the warmup time has passed, and the samples
+**  are timed.
+**
+**  @param[in] options The options.
+**  @param[in] bench The state of the benchmarks.
+**  @param[in] run The function that makes the calls.
+**  @param[in] samples A buffer of options->repetitions samples.
+**  @param[out] stats The statistics of the samples.
+*/
+static void
+run_benchmark(
+        Options_t *options,
+        Bench_t *bench,
+        BenchRun_t run,
+        double *samples,
+        Stats_t *stats
+)
+{
+        uint64_t start;
+        double sum;
+        uint32_t count;
+        uint32_t i;
+
+        start=cube_thread_clock();
+        count=1;
+        while(time_calls(bench,run,count)<options->sampleTime&&count<0x80000000u){
+                count*=2;
+        }
+        while(cube_thread_clock()-start<options->warmup){
+                time_calls(bench,run,count);
+        }
+        for(i=0;i<options->repetitions;i++){
+                samples[i]=(double)time_calls(bench,run,count)/count;
+        }
+        qsort(samples,options->repetitions,sizeof(double),compare_samples);
+        sum=0;
+        for(i=0;i<options->repetitions;i++){
+                sum+=samples[i];
+        }
+        stats->iterations=count;
+        stats->min=samples[0];
+        stats->p50=percentile(samples,options->repetitions,0.5);
+        stats->p90=percentile(samples,options->repetitions,0.9);
+        stats->p99=percentile(samples,options->repetitions,0.99);
+        stats->max=samples[options->repetitions-1];
+        stats->mean=sum/options->repetitions;
+        sum=0;
+        for(i=0;i<options->repetitions;i++){
+                sum+=(samples[i]-stats->mean)*(samples[i]-stats->mean);
+        }
+        stats->stddev=options->repetitions>1?sqrt(sum/(options->repetitions-1)):0;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Writes the result of a benchmark.
+**
+**  A line of the table is written to the standard error, and an object of
+**  the results array to the JSON output.
+**
+**  @param[in] output The JSON output.
+**  @param[in] first This is the first result.
+**  @param[in] benchmark The benchmark.
+**  @param[in] type Name of the cube type.
+**  @param[in] size Size of the cube.
+**  @param[in] stats The statistics of the samples.
+*/
+static void
+write_result(
+        FILE *output,
+        bool first,
+        const Benchmark_t *benchmark,
+        const char *type,
+        uint8_t size,
+        Stats_t *stats
+)
+{
+        fprintf(stderr,"%-18s %-12s %4u %12.1f %12.1f %12.1f %12.1f\n",benchmark->operation,
+                type,size,stats->p50,stats->min,stats->p90,stats->p99);
+        fprintf(output,"%s\n    {\"operation\": \"%s\", \"function\": \"%s\", \"type\": \"%s\", "
+                "\"size\": %u, \"iterations\": %u, \"min\": %.3f, \"p50\": %.3f, "
+                "\"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f, "
+                "\"stddev\": %.3f}",
+                first?"":",",benchmark->operation,benchmark->function,type,size,
+                stats->iterations,stats->min,stats->p50,stats->p90,stats->p99,stats->max,
+                stats->mean,stats->stddev);
+        fflush(output);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if a benchmark is selected.
+**
+**  @param[in] options The options.
+**  @param[in] benchmark The benchmark.
+**
+**  @retval true Run the benchmark.
+**  @retval false Skip the benchmark.
+*/
+static bool
+selected(
+        Options_t *options,
+        const Benchmark_t *benchmark
+)
+{
+        return !options->filter||strstr(benchmark->operation,options->filter);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Runs all benchmarks.
+**
+**  Every benchmark starts from a reset cube and the same generator state.
+**
+**  @param[in] options The options.
+**  @param[in] output The JSON output.
+**
+**  @retval true The benchmarks were run.
+**  @retval false Out of memory.
+*/
+static bool
+run_all(
+        Options_t *options,
+        FILE *output
+)
+{
+        Bench_t *bench;
+        double *samples;
+        Stats_t stats;
+        bool first;
+        uint32_t i;
+        uint32_t j;
+
+        bench=(Bench_t *)malloc(sizeof(Bench_t));
+        samples=(double *)malloc(options->repetitions*sizeof(double));
+        if(!bench||!samples){
+                free(bench);
+                free(samples);
+                return false;
+        }
+        bench->sink=0;
+        fprintf(stderr,"%-18s %-12s %4s %12s %12s %12s %12s\n","operation","type","size",
+                "p50 ns","min ns","p90 ns","p99 ns");
+        fprintf(output,"{\n  \"cubeSize\": %d,\n  \"repetitions\": %u,\n  \"warmupNs\": %llu,\n"
+                "  \"sampleNs\": %llu,\n  \"unit\": \"ns/call\",\n  \"results\": [",
+                CUBE_SIZE,options->repetitions,(unsigned long long)options->warmup,
+                (unsigned long long)options->sampleTime);
+        first=true;
+        for(i=0;i<sizeof(cubeBenchmarks)/sizeof(cubeBenchmarks[0]);i++){
+                if(!selected(options,&cubeBenchmarks[i])){
+                        continue;
+                }
+                cube_reset(&bench->cube);
+                bench->cube.row=CUBE_SIZE/2;
+                bench->cube.col=CUBE_SIZE/2;
+                cube_random_seed(&bench->random,BENCH_SEED);
+                run_benchmark(options,bench,cubeBenchmarks[i].run,samples,&stats);
+                write_result(output,first,&cubeBenchmarks[i],"Cube_t",CUBE_SIZE,&stats);
+                first=false;
+        }
+        for(j=0;j<options->sizeCount;j++){
+                if(!cube_sized_init(&bench->sized,options->sizes[j])){
+                        free(bench);
+                        free(samples);
+                        return false;
+                }
+                for(i=0;i<sizeof(sizedBenchmarks)/sizeof(sizedBenchmarks[0]);i++){
+                        if(!selected(options,&sizedBenchmarks[i])){
+                                continue;
+                        }
+                        cube_sized_reset(&bench->sized);
+                        cube_random_seed(&bench->random,BENCH_SEED);
+                        run_benchmark(options,bench,sizedBenchmarks[i].run,samples,&stats);
+                        write_result(output,first,&sizedBenchmarks[i],"CubeSized_t",
+                                options->sizes[j],&stats);
+                        first=false;
+                }
+                cube_sized_free(&bench->sized);
+        }
+        fprintf(output,"\n  ]\n}\n");
+        free(bench);
+        free(samples);
+        return true;
+}
+
+/******************************************************************************\
+**
+**  MAIN
+**
+\******************************************************************************/
+
+int
+main(
+        int argc,
+        char *argv[]
+)
+{
+        Options_t options;
+        FILE *output;
+        char *outputFile;
+        bool ok;
+        int i;
+
+        options.repetitions=DEFAULT_REPETITIONS;
+        options.warmup=DEFAULT_WARMUP_MS*1000000ull;
+        options.sampleTime=DEFAULT_SAMPLE_US*1000ull;
+        options.filter=NULL;
+        parse_sizes(&options,DEFAULT_SIZES);
+        outputFile=NULL;
+        for(i=1;i<argc;i++){
+                if(!strcmp(argv[i],"-r")&&i+1<argc){
+                        options.repetitions=(uint32_t)atoi(argv[++i]);
+                }
+                else if(!strcmp(argv[i],"-w")&&i+1<argc){
+                        options.warmup=(uint64_t)atoi(argv[++i])*1000000ull;
+                }
+                else if(!strcmp(argv[i],"-t")&&i+1<argc){
+                        options.sampleTime=(uint64_t)atoi(argv[++i])*1000ull;
+                }
+                else if(!strcmp(argv[i],"-s")&&i+1<argc){
+                        if(!parse_sizes(&options,argv[++i])){
+                                usage(argv[0]);
+                                return EXIT_FAILURE;
+                        }
+                }
+                else if(!strcmp(argv[i],"-b")&&i+1<argc){
+                        options.filter=argv[++i];
+                }
+                else if(!strcmp(argv[i],"-o")&&i+1<argc){
+                        outputFile=argv[++i];
+                }
+                else{
+                        usage(argv[0]);
+                        return EXIT_FAILURE;
+                }
+        }
+        if(options.repetitions<1||options.repetitions>MAX_REPETITIONS){
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+        output=outputFile?fopen(outputFile,"w"):stdout;
+        if(!output){
+                fprintf(stderr,"Cannot open %s.\n",outputFile);
+                return EXIT_FAILURE;
+        }
+        ok=run_all(&options,output);
+        if(output!=stdout){
+                fclose(output);
+        }
+        if(!ok){
+                fprintf(stderr,"Out of memory.\n");
+                return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+}
\ No newline at end of file
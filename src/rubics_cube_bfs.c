@@ -0,0 +1,556 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_bfs.c
+**  @ingroup    rubicscube
+**  @brief      Breadth-first enumeration of the 2x2x2 positions.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_bfs.h"
+
+#if CUBE_SIZE==2
+
+#include "rubics_cube_cubie.h"
+#include "rubics_cube_simd.h"
+#include "rubics_cube_thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Number of corner orientations with one corner fixed.
+#define TWIST_COUNT 729
+
+/// Number of 32-bit words in the visited set.
+#define VISITED_WORDS ((CUBE_BFS_STATE_COUNT+31)/32)
+
+/// Size of a position in a frontier file, the stickers of a packed cube.
+#define RECORD_SIZE CUBE_PACKED_STICKERS
+
+/// Number of positions in a block of a frontier file.
+#define BLOCK_RECORDS 16384
+
+/// Size of a frontier file path buffer.
+#define PATH_SIZE 1024
+
+/// Number of moves in the half turn metric.
+#define MOVE_COUNT 9
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A distance of the enumeration.
+**
+**  The frontier files of the distance are split into blocks, which are
+**  numbered through all files in order.
+*/
+typedef struct
+Level_t{
+        /// The enumeration.
+        CubeBfs_t *bfs;
+        /// Visited positions, one bit per position.
+        volatile uint32_t *visited;
+        /// The moves.
+        CubeTurn_t moves[MOVE_COUNT];
+        /// Number of moves.
+        uint8_t moveCount;
+        /// The distance of the frontier.
+        uint8_t depth;
+        /// Number of positions in the frontier file of each thread.
+        uint32_t size[CUBE_THREAD_MAX_COUNT];
+        /// The first block of each frontier file, and the block count.
+        uint32_t firstBlock[CUBE_THREAD_MAX_COUNT+1];
+        /// The next block to expand.
+        volatile uint32_t nextBlock;
+} Level_t;
+
+/**
+**  @brief A thread of the enumeration.
+*/
+typedef struct
+Worker_t{
+        /// The distance being expanded.
+        Level_t *level;
+        /// Index of the thread, and of its frontier file.
+        uint32_t index;
+        /// Number of new positions written.
+        uint32_t found;
+        /// Number of turned cubes that were not valid.
+        uint32_t invalid;
+        /// The frontier files were read and written.
+        bool ok;
+} Worker_t;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the path of a frontier file.
+**
+**  @param[in] bfs A pointer to an enumeration.
+**  @param[in] depth The distance of the positions in the file.
+**  @param[in] index Index of the thread that writes the file.
+**  @param[out] path The path, PATH_SIZE characters.
+**
+**  @retval true The path fits.
+**  @retval false The directory name is too long.
+*/
+static bool
+get_path(
+        CubeBfs_t *bfs,
+        uint8_t depth,
+        uint32_t index,
+        char *path
+)
+{
+        int length;
+
+        length=snprintf(path,PATH_SIZE,"%s%srubics_cube_bfs_%02u_%03u.frontier",
+                bfs->directory?bfs->directory:"",bfs->directory?"/":"",depth,index);
+        return length>=0&&length<PATH_SIZE;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the index of a position.
+**
+**  The index is the permutation of the corners other than the fixed one
+**  times the number of orientations, plus their orientation.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[out] index The index (0 - CUBE_BFS_STATE_COUNT-1).
+**
+**  @retval true The index was set.
+**  @retval false The cube is not valid.
+*/
+static bool
+get_index(
+        CubePacked_t *packed,
+        uint32_t *index
+)
+{
+        CubeCubie_t cubie;
+        uint8_t p[CUBE_CORNER_COUNT-1];
+        uint16_t twist;
+        uint8_t c;
+        uint8_t i;
+
+        if(!cube_cubie_from_packed_corners(&cubie,packed)||
+           cubie.cp[CUBE_CORNER_DBL]!=CUBE_CORNER_DBL){
+                return false;
+        }
+        twist=0;
+        for(i=0;i<CUBE_CORNER_COUNT-1;i++){
+                c=cubie.cp[i<CUBE_CORNER_DBL?i:i+1];
+                p[i]=c<CUBE_CORNER_DBL?c:c-1;
+        }
+        for(i=0;i<CUBE_CORNER_DBL;i++){
+                twist=(uint16_t)(twist*3+cubie.co[i]);
+        }
+        *index=(uint32_t)cube_cubie_get_permutation(p,CUBE_CORNER_COUNT-1)*TWIST_COUNT+twist;
+        return true;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Marks a position visited.
+**
+**  @param[in] visited The visited set.
+**  @param[in] index Index of the position.
+**
+**  @retval true The position is new, and no other thread got it.
+**  @retval false The position was already visited.
+*/
+static inline bool
+visit(
+        volatile uint32_t *visited,
+        uint32_t index
+)
+{
+        uint32_t bit;
+
+        bit=(uint32_t)1<<(index%32);
+        visited+=index/32;
+        // Most positions are old, and reading first keeps the cache line
+        // shared between the processors.
+        if(cube_atomic_load(visited)&bit){
+                return false;
+        }
+        return !(cube_atomic_or(visited,bit)&bit);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Reads a block of the frontier.
+**
+**  @param[in] level The distance being expanded.
+**  @param[in] b Number of the block.
+**  @param[in,out] input The open frontier file, NULL if none.
+**  @param[in,out] inputFile Index of the open frontier file.
+**  @param[out] block The positions of the block.
+**  @param[out] count Number of positions in the block.
+**
+**  @retval true The block was read.
+**  @retval false The frontier file could not be read.
+*/
+static bool
+read_block(
+        Level_t *level,
+        uint32_t b,
+        FILE **input,
+        uint32_t *inputFile,
+        uint8_t *block,
+        uint32_t *count
+)
+{
+        char path[PATH_SIZE];
+        uint32_t first;
+        uint32_t f;
+
+        // The blocks are taken in order, so a thread goes through the files
+        // only once.
+        f=0;
+        while(b>=level->firstBlock[f+1]){
+                f++;
+        }
+        if(f!=*inputFile){
+                if(*input){
+                        fclose(*input);
+                }
+                *inputFile=f;
+                *input=get_path(level->bfs,level->depth,f,path)?fopen(path,"rb"):NULL;
+                if(!*input){
+                        return false;
+                }
+        }
+        first=(b-level->firstBlock[f])*BLOCK_RECORDS;
+        *count=level->size[f]-first<BLOCK_RECORDS?level->size[f]-first:BLOCK_RECORDS;
+        return !fseek(*input,(long)first*RECORD_SIZE,SEEK_SET)&&
+               fread(block,RECORD_SIZE,*count,*input)==*count;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns the positions of a block with all moves.
+**
+**  The new positions are collected to a block, which is written to the
+**  frontier file of the thread for the next distance when it is full.
+**
+**  @param[in] worker A pointer to the worker.
+**  @param[in] block The positions of the block.
+**  @param[in] count Number of positions in the block.
+**  @param[in] output The frontier file of the next distance.
+**  @param[in,out] out The block of new positions.
+**  @param[in,out] outCount Number of new positions in the block.
+**
+**  @retval true The block was expanded.
+**  @retval false The frontier file could not be written.
+*/
+static bool
+expand_block(
+        Worker_t *worker,
+        uint8_t *block,
+        uint32_t count,
+        FILE *output,
+        uint8_t *out,
+        uint32_t *outCount
+)
+{
+        CubePacked_t packed;
+        CubePacked_t turned;
+        Cube_t cube;
+        Cube_t layer;
+        Level_t *level;
+        uint32_t index;
+        uint32_t i;
+        uint8_t m;
+
+        level=worker->level;
+        memset(&packed,0,sizeof(packed));
+        cube_reset(&cube);
+        for(i=0;i<count;i++){
+                memcpy(packed.sticker,block+i*RECORD_SIZE,RECORD_SIZE);
+                if(level->bfs->layerTurns){
+                        cube_packed_to_cube(&packed,&cube);
+                }
+                for(m=0;m<level->moveCount;m++){
+                        if(level->bfs->layerTurns){
+                                layer=cube;
+                                cube_apply_turns(&layer,&level->moves[m],1);
+                                cube_packed_from_cube(&turned,&layer);
+                        }
+                        else{
+                                turned=packed;
+                                cube_packed_turn(&turned,level->moves[m]);
+                        }
+                        if(!get_index(&turned,&index)){
+                                worker->invalid++;
+                                continue;
+                        }
+                        if(!visit(level->visited,index)){
+                                continue;
+                        }
+                        memcpy(out+*outCount*RECORD_SIZE,turned.sticker,RECORD_SIZE);
+                        worker->found++;
+                        if(++*outCount==BLOCK_RECORDS){
+                                if(fwrite(out,RECORD_SIZE,BLOCK_RECORDS,output)!=BLOCK_RECORDS){
+                                        return false;
+                                }
+                                *outCount=0;
+                        }
+                }
+        }
+        return true;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Expands blocks of the frontier until none is left.
+**
+**  @param[in] argument A pointer to the worker.
+*/
+static void
+run_worker(
+        void *argument
+)
+{
+        char path[PATH_SIZE];
+        Worker_t *worker;
+        Level_t *level;
+        FILE *input;
+        FILE *output;
+        uint8_t *block;
+        uint8_t *out;
+        uint32_t inputFile;
+        uint32_t outCount;
+        uint32_t count;
+        uint32_t b;
+        bool ok;
+
+        worker=(Worker_t *)argument;
+        level=worker->level;
+        input=NULL;
+        inputFile=CUBE_THREAD_MAX_COUNT;
+        outCount=0;
+        block=(uint8_t *)malloc(BLOCK_RECORDS*RECORD_SIZE);
+        out=(uint8_t *)malloc(BLOCK_RECORDS*RECORD_SIZE);
+        output=get_path(level->bfs,level->depth+1,worker->index,path)?fopen(path,"wb"):NULL;
+        ok=block&&out&&output;
+        while(ok){
+                b=cube_atomic_add(&level->nextBlock,1);
+                if(b>=level->firstBlock[level->bfs->threadCount]){
+                        break;
+                }
+                ok=read_block(level,b,&input,&inputFile,block,&count)&&
+                   expand_block(worker,block,count,output,out,&outCount);
+        }
+        ok=ok&&fwrite(out,RECORD_SIZE,outCount,output)==outCount;
+        if(output&&fclose(output)){
+                ok=false;
+        }
+        if(input){
+                fclose(input);
+        }
+        free(out);
+        free(block);
+        if(!ok){
+                // Stop the other threads.
+                cube_atomic_store(&level->nextBlock,UINT32_MAX/2);
+        }
+        worker->ok=ok;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Removes the frontier files of a distance.
+**
+**  @param[in] bfs A pointer to an enumeration.
+**  @param[in] depth The distance.
+*/
+static void
+remove_files(
+        CubeBfs_t *bfs,
+        uint8_t depth
+)
+{
+        char path[PATH_SIZE];
+        uint32_t i;
+
+        for(i=0;i<bfs->threadCount;i++){
+                if(get_path(bfs,depth,i,path)){
+                        remove(path);
+                }
+        }
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+void
+cube_bfs_init(
+        CubeBfs_t *bfs
+)
+{
+        memset(bfs,0,sizeof(*bfs));
+        bfs->directory=NULL;
+        bfs->threadCount=cube_thread_cpu_count();
+}
+
+bool
+cube_bfs_run(
+        CubeBfs_t *bfs
+)
+{
+        char path[PATH_SIZE];
+        CubeThread_t *threads;
+        CubePacked_t packed;
+        Worker_t *workers;
+        Level_t *level;
+        FILE *f;
+        uint32_t started;
+        uint32_t index;
+        uint32_t total;
+        uint32_t i;
+        uint8_t depth;
+        bool ok;
+
+        memset(bfs->count,0,sizeof(bfs->count));
+        bfs->depth=0;
+        bfs->total=0;
+        bfs->invalid=0;
+        if(bfs->threadCount<1||bfs->threadCount>CUBE_THREAD_MAX_COUNT){
+                return false;
+        }
+        cube_simd_init();
+        level=(Level_t *)calloc(1,sizeof(Level_t));
+        workers=(Worker_t *)calloc(bfs->threadCount,sizeof(Worker_t));
+        threads=(CubeThread_t *)calloc(bfs->threadCount,sizeof(CubeThread_t));
+        if(level){
+                level->visited=(volatile uint32_t *)calloc(VISITED_WORDS,sizeof(uint32_t));
+        }
+        if(!level||!level->visited||!workers||!threads){
+                if(level){
+                        free((void *)level->visited);
+                }
+                free(level);
+                free(workers);
+                free(threads);
+                return false;
+        }
+        level->bfs=bfs;
+        for(i=0;i<MOVE_COUNT;i++){
+                if(!bfs->quarterTurns||i%3!=1){
+                        level->moves[level->moveCount++]=(CubeTurn_t)i;
+                }
+        }
+
+        // The reset cube is the frontier of the first thread at distance 0.
+        cube_packed_reset(&packed);
+        ok=get_index(&packed,&index)&&get_path(bfs,0,0,path);
+        if(ok){
+                visit(level->visited,index);
+                f=fopen(path,"wb");
+                ok=f&&fwrite(packed.sticker,RECORD_SIZE,1,f)==1;
+                ok=f&&!fclose(f)&&ok;
+                level->size[0]=1;
+        }
+
+        for(depth=0;ok;depth++){
+                total=0;
+                level->firstBlock[0]=0;
+                for(i=0;i<bfs->threadCount;i++){
+                        total+=level->size[i];
+                        level->firstBlock[i+1]=level->firstBlock[i]+
+                                (level->size[i]+BLOCK_RECORDS-1)/BLOCK_RECORDS;
+                }
+                if(!total){
+                        break;
+                }
+                bfs->count[depth]=total;
+                bfs->total+=total;
+                bfs->depth=depth;
+                if(depth+1>=CUBE_BFS_DEPTH_COUNT){
+                        ok=false;
+                        break;
+                }
+
+                level->depth=depth;
+                level->nextBlock=0;
+                for(i=0;i<bfs->threadCount;i++){
+                        workers[i].level=level;
+                        workers[i].index=i;
+                        workers[i].found=0;
+                        workers[i].invalid=0;
+                        workers[i].ok=true;
+                }
+                for(started=0;started<bfs->threadCount;started++){
+                        if(!cube_thread_start(&threads[started],run_worker,&workers[started])){
+                                break;
+                        }
+                }
+                for(i=0;i<started;i++){
+                        cube_thread_join(&threads[i]);
+                }
+                remove_files(bfs,depth);
+                ok=started>0;
+                for(i=0;i<bfs->threadCount;i++){
+                        ok=ok&&workers[i].ok;
+                        level->size[i]=workers[i].found;
+                        bfs->invalid+=workers[i].invalid;
+                }
+        }
+        remove_files(bfs,depth);
+        free((void *)level->visited);
+        free(level);
+        free(workers);
+        free(threads);
+        return ok;
+}
+
+#endif // if CUBE_SIZE==2
+
+/* EOF */
\ No newline at end of file
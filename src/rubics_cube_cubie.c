@@ -0,0 +1,900 @@
+﻿/***************************************************************************//**
+**
+**  @file       rubics_cube_cubie.c
+**  @ingroup    rubicscube
+**  @brief      Cubie level model of a 3x3x3 Rubic's cube.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_cubie.h"
+
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A move on the cubie level.
+**
+**  Position i receives the cubie from position cp[i] (ep[i]), and its
+**  orientation is increased by co[i] (eo[i]).
+*/
+typedef struct
+CubieMove_t{
+        /// Corner source positions.
+        uint8_t cp[CUBE_CORNER_COUNT];
+        /// Corner twists.
+        uint8_t co[CUBE_CORNER_COUNT];
+        /// Edge source positions.
+        uint8_t ep[CUBE_EDGE_COUNT];
+        /// Edge flips.
+        uint8_t eo[CUBE_EDGE_COUNT];
+} CubieMove_t;
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Number of orders of the middle layer edges.
+#define SLICE_ORDER_COUNT 24
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Move tables of the outer layer turns, indexed by CubeTurn_t.
+*/
+static const CubieMove_t
+moveTable[CUBE_TURN_COUNT]={
+        // U
+        {{3,0,1,2,4,5,6,7},{0,0,0,0,0,0,0,0},{3,0,1,2,4,5,6,7,8,9,10,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // U2
+        {{2,3,0,1,4,5,6,7},{0,0,0,0,0,0,0,0},{2,3,0,1,4,5,6,7,8,9,10,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // U'
+        {{1,2,3,0,4,5,6,7},{0,0,0,0,0,0,0,0},{1,2,3,0,4,5,6,7,8,9,10,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // R
+        {{4,1,2,0,7,5,6,3},{2,0,0,1,1,0,0,2},{8,1,2,3,11,5,6,7,4,9,10,0},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // R2
+        {{7,1,2,4,3,5,6,0},{0,0,0,0,0,0,0,0},{4,1,2,3,0,5,6,7,11,9,10,8},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // R'
+        {{3,1,2,7,0,5,6,4},{2,0,0,1,1,0,0,2},{11,1,2,3,8,5,6,7,0,9,10,4},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // F
+        {{1,5,2,3,0,4,6,7},{1,2,0,0,2,1,0,0},{0,9,2,3,4,8,6,7,1,5,10,11},{0,1,0,0,0,1,0,0,1,1,0,0}},
+        // F2
+        {{5,4,2,3,1,0,6,7},{0,0,0,0,0,0,0,0},{0,5,2,3,4,1,6,7,9,8,10,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // F'
+        {{4,0,2,3,5,1,6,7},{1,2,0,0,2,1,0,0},{0,8,2,3,4,9,6,7,5,1,10,11},{0,1,0,0,0,1,0,0,1,1,0,0}},
+        // D
+        {{0,1,2,3,5,6,7,4},{0,0,0,0,0,0,0,0},{0,1,2,3,5,6,7,4,8,9,10,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // D2
+        {{0,1,2,3,6,7,4,5},{0,0,0,0,0,0,0,0},{0,1,2,3,6,7,4,5,8,9,10,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // D'
+        {{0,1,2,3,7,4,5,6},{0,0,0,0,0,0,0,0},{0,1,2,3,7,4,5,6,8,9,10,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // L
+        {{0,2,6,3,4,1,5,7},{0,1,2,0,0,2,1,0},{0,1,10,3,4,5,9,7,8,2,6,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // L2
+        {{0,6,5,3,4,2,1,7},{0,0,0,0,0,0,0,0},{0,1,6,3,4,5,2,7,8,10,9,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // L'
+        {{0,5,1,3,4,6,2,7},{0,1,2,0,0,2,1,0},{0,1,9,3,4,5,10,7,8,6,2,11},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // B
+        {{0,1,3,7,4,5,2,6},{0,0,1,2,0,0,2,1},{0,1,2,11,4,5,6,10,8,9,3,7},{0,0,0,1,0,0,0,1,0,0,1,1}},
+        // B2
+        {{0,1,7,6,4,5,3,2},{0,0,0,0,0,0,0,0},{0,1,2,7,4,5,6,3,8,9,11,10},{0,0,0,0,0,0,0,0,0,0,0,0}},
+        // B'
+        {{0,1,6,2,4,5,7,3},{0,0,1,2,0,0,2,1},{0,1,2,10,4,5,6,11,8,9,7,3},{0,0,0,1,0,0,0,1,0,0,1,1}}
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sum of two corner orientations.
+**
+**  Orientations 3-5 belong to the mirrored corners of a reflection. The sum
+**  of two normal or two mirrored orientations is normal, and the sum of a
+**  normal and a mirrored orientation is mirrored.
+*/
+static const uint8_t
+twistSum[6][6]={
+        {0,1,2,3,4,5},
+        {1,2,0,4,5,3},
+        {2,0,1,5,3,4},
+        {3,5,4,0,2,1},
+        {4,3,5,1,0,2},
+        {5,4,3,2,1,0}
+};
+
+/// Index of the last row and column of a face.
+#define LAST (CUBE_SIZE-1)
+
+/// Index of a sticker in a packed cube, given as row and column of the face
+///seen from the outside with the top side up (or back side up for the top and
+///bottom faces).
+#define FACELET(side,r,c) CUBE_PACKED_INDEX(side,c,r)
+
+/// The back face is stored upside down.
+#define FACELET_B(r,c) CUBE_PACKED_INDEX(CUBE_SIDE_BACK,LAST-(c),LAST-(r))
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Stickers of the corner positions, clockwise starting from the top
+**  or bottom sticker.
+*/
+static const uint32_t
+cornerFacelet[CUBE_CORNER_COUNT][3]={
+        {FACELET(CUBE_SIDE_TOP,LAST,LAST),FACELET(CUBE_SIDE_RIGHT,0,0),FACELET(CUBE_SIDE_FRONT,0,LAST)},
+        {FACELET(CUBE_SIDE_TOP,LAST,0),FACELET(CUBE_SIDE_FRONT,0,0),FACELET(CUBE_SIDE_LEFT,0,LAST)},
+        {FACELET(CUBE_SIDE_TOP,0,0),FACELET(CUBE_SIDE_LEFT,0,0),FACELET_B(0,LAST)},
+        {FACELET(CUBE_SIDE_TOP,0,LAST),FACELET_B(0,0),FACELET(CUBE_SIDE_RIGHT,0,LAST)},
+        {FACELET(CUBE_SIDE_BOTTOM,0,LAST),FACELET(CUBE_SIDE_FRONT,LAST,LAST),FACELET(CUBE_SIDE_RIGHT,LAST,0)},
+        {FACELET(CUBE_SIDE_BOTTOM,0,0),FACELET(CUBE_SIDE_LEFT,LAST,LAST),FACELET(CUBE_SIDE_FRONT,LAST,0)},
+        {FACELET(CUBE_SIDE_BOTTOM,LAST,0),FACELET_B(LAST,LAST),FACELET(CUBE_SIDE_LEFT,LAST,0)},
+        {FACELET(CUBE_SIDE_BOTTOM,LAST,LAST),FACELET(CUBE_SIDE_RIGHT,LAST,LAST),FACELET_B(LAST,0)}
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sides of the corner cubies, in the same order as the stickers.
+*/
+static const uint8_t
+cornerSide[CUBE_CORNER_COUNT][3]={
+        {CUBE_SIDE_TOP,CUBE_SIDE_RIGHT,CUBE_SIDE_FRONT},
+        {CUBE_SIDE_TOP,CUBE_SIDE_FRONT,CUBE_SIDE_LEFT},
+        {CUBE_SIDE_TOP,CUBE_SIDE_LEFT,CUBE_SIDE_BACK},
+        {CUBE_SIDE_TOP,CUBE_SIDE_BACK,CUBE_SIDE_RIGHT},
+        {CUBE_SIDE_BOTTOM,CUBE_SIDE_FRONT,CUBE_SIDE_RIGHT},
+        {CUBE_SIDE_BOTTOM,CUBE_SIDE_LEFT,CUBE_SIDE_FRONT},
+        {CUBE_SIDE_BOTTOM,CUBE_SIDE_BACK,CUBE_SIDE_LEFT},
+        {CUBE_SIDE_BOTTOM,CUBE_SIDE_RIGHT,CUBE_SIDE_BACK}
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Corner cubies by the top or bottom side and the next side
+**  clockwise, CUBE_CORNER_COUNT if there is no such corner.
+*/
+static const uint8_t
+cornerOfSides[2][CUBE_SIDE_COUNT]={
+        {CUBE_CORNER_UFL,CUBE_CORNER_UBR,CUBE_CORNER_COUNT,CUBE_CORNER_COUNT,CUBE_CORNER_ULB,CUBE_CORNER_URF},
+        {CUBE_CORNER_DFR,CUBE_CORNER_DBL,CUBE_CORNER_COUNT,CUBE_CORNER_COUNT,CUBE_CORNER_DLF,CUBE_CORNER_DRB}
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Corner orientations by the stickers on the top or bottom side, one
+**  bit per sticker in the clockwise order, 3 if not exactly one.
+*/
+static const uint8_t
+udOrientation[8]={3,0,1,3,2,3,3,3};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief The next sticker of a corner clockwise.
+*/
+static const uint8_t
+nextOrientation[3]={1,2,0};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief The opposite side of each side.
+*/
+static const uint8_t
+oppositeSide[CUBE_SIDE_COUNT]={
+        CUBE_SIDE_BACK,
+        CUBE_SIDE_FRONT,
+        CUBE_SIDE_BOTTOM,
+        CUBE_SIDE_TOP,
+        CUBE_SIDE_RIGHT,
+        CUBE_SIDE_LEFT
+};
+
+#if CUBE_SIZE==3
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Stickers of the edge positions.
+*/
+static const uint8_t
+edgeFacelet[CUBE_EDGE_COUNT][2]={
+        {FACELET(CUBE_SIDE_TOP,1,2),FACELET(CUBE_SIDE_RIGHT,0,1)},
+        {FACELET(CUBE_SIDE_TOP,2,1),FACELET(CUBE_SIDE_FRONT,0,1)},
+        {FACELET(CUBE_SIDE_TOP,1,0),FACELET(CUBE_SIDE_LEFT,0,1)},
+        {FACELET(CUBE_SIDE_TOP,0,1),FACELET_B(0,1)},
+        {FACELET(CUBE_SIDE_BOTTOM,1,2),FACELET(CUBE_SIDE_RIGHT,2,1)},
+        {FACELET(CUBE_SIDE_BOTTOM,0,1),FACELET(CUBE_SIDE_FRONT,2,1)},
+        {FACELET(CUBE_SIDE_BOTTOM,1,0),FACELET(CUBE_SIDE_LEFT,2,1)},
+        {FACELET(CUBE_SIDE_BOTTOM,2,1),FACELET_B(2,1)},
+        {FACELET(CUBE_SIDE_FRONT,1,2),FACELET(CUBE_SIDE_RIGHT,1,0)},
+        {FACELET(CUBE_SIDE_FRONT,1,0),FACELET(CUBE_SIDE_LEFT,1,2)},
+        {FACELET_B(1,2),FACELET(CUBE_SIDE_LEFT,1,0)},
+        {FACELET_B(1,0),FACELET(CUBE_SIDE_RIGHT,1,2)}
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sides of the edge cubies, in the same order as the stickers.
+*/
+static const uint8_t
+edgeSide[CUBE_EDGE_COUNT][2]={
+        {CUBE_SIDE_TOP,CUBE_SIDE_RIGHT},
+        {CUBE_SIDE_TOP,CUBE_SIDE_FRONT},
+        {CUBE_SIDE_TOP,CUBE_SIDE_LEFT},
+        {CUBE_SIDE_TOP,CUBE_SIDE_BACK},
+        {CUBE_SIDE_BOTTOM,CUBE_SIDE_RIGHT},
+        {CUBE_SIDE_BOTTOM,CUBE_SIDE_FRONT},
+        {CUBE_SIDE_BOTTOM,CUBE_SIDE_LEFT},
+        {CUBE_SIDE_BOTTOM,CUBE_SIDE_BACK},
+        {CUBE_SIDE_FRONT,CUBE_SIDE_RIGHT},
+        {CUBE_SIDE_FRONT,CUBE_SIDE_LEFT},
+        {CUBE_SIDE_BACK,CUBE_SIDE_LEFT},
+        {CUBE_SIDE_BACK,CUBE_SIDE_RIGHT}
+};
+
+#endif // if CUBE_SIZE==3
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Calculates the parity of a permutation.
+**
+**  @param[in] p A permutation.
+**  @param[in] n Length of the permutation.
+**
+**  @return 0 for an even and 1 for an odd permutation.
+*/
+static uint8_t
+permutation_parity(
+        uint8_t *p,
+        uint8_t n
+)
+{
+        uint8_t i;
+        uint8_t j;
+        uint8_t s;
+
+        s=0;
+        for(i=0;i<n;i++){
+                for(j=i+1;j<n;j++){
+                        if(p[i]>p[j]){
+                                s^=1;
+                        }
+                }
+        }
+        return s;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets a uniformly random permutation.
+**
+**  @param[out] p The permutation.
+**  @param[in] n Length of the permutation.
+**  @param[in,out] random A random number generator.
+**
+**  @return 0 for an even and 1 for an odd permutation.
+*/
+static uint8_t
+random_permutation(
+        uint8_t *p,
+        uint8_t n,
+        CubeRandom_t *random
+)
+{
+        uint8_t i;
+        uint8_t j;
+        uint8_t t;
+        uint8_t s;
+
+        for(i=0;i<n;i++){
+                p[i]=i;
+        }
+        // Each swap of two different elements changes the parity.
+        s=0;
+        for(i=n-1;i>0;i--){
+                j=(uint8_t)cube_random_below(random,i+1);
+                if(j!=i){
+                        t=p[i];
+                        p[i]=p[j];
+                        p[j]=t;
+                        s^=1;
+                }
+        }
+        return s;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Calculates a binomial coefficient.
+**
+**  @param[in] n Number of items.
+**  @param[in] k Number of chosen items.
+**
+**  @return The number of ways to choose k items out of n.
+*/
+static uint32_t
+binomial(
+        uint8_t n,
+        uint8_t k
+)
+{
+        uint32_t r;
+        uint8_t i;
+
+        if(k>n){
+                return 0;
+        }
+        r=1;
+        for(i=1;i<=k;i++){
+                r=r*(n-k+i)/i;
+        }
+        return r;
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+void
+cube_cubie_reset(
+        CubeCubie_t *cubie
+)
+{
+        uint8_t i;
+
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                cubie->cp[i]=i;
+                cubie->co[i]=0;
+        }
+        for(i=0;i<CUBE_EDGE_COUNT;i++){
+                cubie->ep[i]=i;
+                cubie->eo[i]=0;
+        }
+}
+
+void
+cube_cubie_turn(
+        CubeCubie_t *cubie,
+        CubeTurn_t turn
+)
+{
+        const CubieMove_t *m;
+        CubeCubie_t c;
+        uint8_t i;
+
+        m=&moveTable[turn];
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                c.cp[i]=cubie->cp[m->cp[i]];
+                c.co[i]=twistSum[cubie->co[m->cp[i]]][m->co[i]];
+        }
+        for(i=0;i<CUBE_EDGE_COUNT;i++){
+                c.ep[i]=cubie->ep[m->ep[i]];
+                c.eo[i]=cubie->eo[m->ep[i]]^m->eo[i];
+        }
+        *cubie=c;
+}
+
+void
+cube_cubie_multiply(
+        CubeCubie_t *a,
+        CubeCubie_t *b,
+        CubeCubie_t *result
+)
+{
+        uint8_t i;
+
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                result->cp[i]=a->cp[b->cp[i]];
+                result->co[i]=twistSum[a->co[b->cp[i]]][b->co[i]];
+        }
+        for(i=0;i<CUBE_EDGE_COUNT;i++){
+                result->ep[i]=a->ep[b->ep[i]];
+                result->eo[i]=a->eo[b->ep[i]]^b->eo[i];
+        }
+}
+
+void
+cube_cubie_inverse(
+        CubeCubie_t *cubie,
+        CubeCubie_t *result
+)
+{
+        uint8_t i;
+
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                result->cp[cubie->cp[i]]=i;
+        }
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                result->co[i]=cubie->co[result->cp[i]];
+                if(result->co[i]<3){
+                        result->co[i]=(uint8_t)((3-result->co[i])%3);
+                }
+        }
+        for(i=0;i<CUBE_EDGE_COUNT;i++){
+                result->ep[cubie->ep[i]]=i;
+        }
+        for(i=0;i<CUBE_EDGE_COUNT;i++){
+                result->eo[i]=cubie->eo[result->ep[i]];
+        }
+}
+
+bool
+cube_cubie_is_solved(
+        CubeCubie_t *cubie
+)
+{
+        CubeCubie_t s;
+
+        cube_cubie_reset(&s);
+        return !memcmp(cubie,&s,sizeof(CubeCubie_t));
+}
+
+bool
+cube_cubie_is_valid(
+        CubeCubie_t *cubie
+)
+{
+        uint16_t seen;
+        uint8_t twist;
+        uint8_t flip;
+        uint8_t i;
+
+        seen=0;
+        twist=0;
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                if(cubie->cp[i]>=CUBE_CORNER_COUNT||cubie->co[i]>2){
+                        return false;
+                }
+                seen|=1<<cubie->cp[i];
+                twist+=cubie->co[i];
+        }
+        if(seen!=(1<<CUBE_CORNER_COUNT)-1||twist%3){
+                return false;
+        }
+        seen=0;
+        flip=0;
+        for(i=0;i<CUBE_EDGE_COUNT;i++){
+                if(cubie->ep[i]>=CUBE_EDGE_COUNT||cubie->eo[i]>1){
+                        return false;
+                }
+                seen|=1<<cubie->ep[i];
+                flip+=cubie->eo[i];
+        }
+        if(seen!=(1<<CUBE_EDGE_COUNT)-1||flip%2){
+                return false;
+        }
+        return permutation_parity(cubie->cp,CUBE_CORNER_COUNT)==
+                permutation_parity(cubie->ep,CUBE_EDGE_COUNT);
+}
+
+void
+cube_cubie_random(
+        CubeCubie_t *cubie,
+        CubeRandom_t *random
+)
+{
+        uint8_t twist;
+        uint8_t flip;
+        uint8_t t;
+        uint8_t i;
+
+        // Swapping two edges pairs the states of unequal parities one to one
+        // with the reachable ones, so the result stays uniform.
+        if(random_permutation(cubie->cp,CUBE_CORNER_COUNT,random)!=
+           random_permutation(cubie->ep,CUBE_EDGE_COUNT,random)){
+                t=cubie->ep[0];
+                cubie->ep[0]=cubie->ep[1];
+                cubie->ep[1]=t;
+        }
+        twist=0;
+        for(i=0;i<CUBE_CORNER_COUNT-1;i++){
+                cubie->co[i]=(uint8_t)cube_random_below(random,3);
+                twist+=cubie->co[i];
+        }
+        cubie->co[i]=(3-twist%3)%3;
+        flip=0;
+        for(i=0;i<CUBE_EDGE_COUNT-1;i++){
+                cubie->eo[i]=(uint8_t)cube_random_below(random,2);
+                flip^=cubie->eo[i];
+        }
+        cubie->eo[i]=flip;
+}
+
+uint16_t
+cube_cubie_get_twist(
+        CubeCubie_t *cubie
+)
+{
+        uint16_t r;
+        uint8_t i;
+
+        r=0;
+        for(i=0;i<CUBE_CORNER_COUNT-1;i++){
+                r=(uint16_t)(r*3+cubie->co[i]);
+        }
+        return r;
+}
+
+void
+cube_cubie_set_twist(
+        CubeCubie_t *cubie,
+        uint16_t twist
+)
+{
+        uint8_t sum;
+        uint8_t i;
+
+        sum=0;
+        for(i=CUBE_CORNER_COUNT-1;i--;){
+                cubie->co[i]=(uint8_t)(twist%3);
+                sum+=cubie->co[i];
+                twist/=3;
+        }
+        cubie->co[CUBE_CORNER_COUNT-1]=(uint8_t)((3-sum%3)%3);
+}
+
+uint16_t
+cube_cubie_get_flip(
+        CubeCubie_t *cubie
+)
+{
+        uint16_t r;
+        uint8_t i;
+
+        r=0;
+        for(i=0;i<CUBE_EDGE_COUNT-1;i++){
+                r=(uint16_t)(r*2+cubie->eo[i]);
+        }
+        return r;
+}
+
+void
+cube_cubie_set_flip(
+        CubeCubie_t *cubie,
+        uint16_t flip
+)
+{
+        uint8_t sum;
+        uint8_t i;
+
+        sum=0;
+        for(i=CUBE_EDGE_COUNT-1;i--;){
+                cubie->eo[i]=(uint8_t)(flip&1);
+                sum+=cubie->eo[i];
+                flip>>=1;
+        }
+        cubie->eo[CUBE_EDGE_COUNT-1]=sum&1;
+}
+
+uint16_t
+cube_cubie_get_permutation(
+        uint8_t *p,
+        uint8_t n
+)
+{
+        uint16_t r;
+        uint8_t i;
+        uint8_t j;
+        uint8_t k;
+
+        r=0;
+        for(i=0;i<n;i++){
+                k=0;
+                for(j=i+1;j<n;j++){
+                        if(p[j]<p[i]){
+                                k++;
+                        }
+                }
+                r=(uint16_t)(r*(n-i)+k);
+        }
+        return r;
+}
+
+void
+cube_cubie_set_permutation(
+        uint8_t *p,
+        uint8_t n,
+        uint16_t rank
+)
+{
+        uint8_t digit[CUBE_CORNER_COUNT];
+        uint8_t left[CUBE_CORNER_COUNT];
+        uint8_t i;
+        uint8_t j;
+
+        for(i=n;i--;){
+                digit[i]=(uint8_t)(rank%(n-i));
+                rank/=(uint16_t)(n-i);
+        }
+        for(i=0;i<n;i++){
+                left[i]=i;
+        }
+        for(i=0;i<n;i++){
+                p[i]=left[digit[i]];
+                for(j=digit[i];j<n-1-i;j++){
+                        left[j]=left[j+1];
+                }
+        }
+}
+
+uint16_t
+cube_cubie_get_slice(
+        CubeCubie_t *cubie
+)
+{
+        uint8_t order[4];
+        uint16_t comb;
+        uint8_t k;
+        uint8_t j;
+
+        comb=0;
+        k=0;
+        for(j=CUBE_EDGE_COUNT;j--;){
+                if(cubie->ep[j]>=CUBE_EDGE_FR){
+                        comb=(uint16_t)(comb+binomial(CUBE_EDGE_COUNT-1-j,k+1));
+                        order[3-k]=cubie->ep[j]-CUBE_EDGE_FR;
+                        k++;
+                }
+        }
+        return (uint16_t)(comb*SLICE_ORDER_COUNT+cube_cubie_get_permutation(order,4));
+}
+
+void
+cube_cubie_set_slice(
+        CubeCubie_t *cubie,
+        uint16_t slice
+)
+{
+        uint8_t order[4];
+        uint16_t comb;
+        uint8_t other;
+        uint8_t q;
+        uint8_t j;
+        uint8_t k;
+
+        cube_cubie_set_permutation(order,4,slice%SLICE_ORDER_COUNT);
+        comb=slice/SLICE_ORDER_COUNT;
+        memset(cubie->ep,0xFF,sizeof(cubie->ep));
+        for(k=4;k--;){
+                q=CUBE_EDGE_COUNT-1;
+                while(binomial(q,k+1)>comb){
+                        q--;
+                }
+                comb=(uint16_t)(comb-binomial(q,k+1));
+                cubie->ep[CUBE_EDGE_COUNT-1-q]=CUBE_EDGE_FR+order[3-k];
+        }
+        other=0;
+        for(j=0;j<CUBE_EDGE_COUNT;j++){
+                if(cubie->ep[j]==0xFF){
+                        cubie->ep[j]=other++;
+                }
+        }
+}
+
+bool
+cube_cubie_from_cube_corners(
+        CubeCubie_t *cubie,
+        Cube_t *cube
+)
+{
+        CubePacked_t p;
+
+        cube_packed_from_cube(&p,cube);
+        return cube_cubie_from_packed_corners(cubie,&p);
+}
+
+bool
+cube_cubie_from_packed_corners(
+        CubeCubie_t *cubie,
+        CubePacked_t *packed
+)
+{
+        uint8_t resetSide[CUBE_COLOR_COUNT];
+        uint8_t side[CUBE_COLOR_COUNT];
+        uint8_t s[3];
+        uint8_t seen;
+        uint8_t twist;
+        uint8_t i;
+        uint8_t j;
+        uint8_t o;
+
+        cube_cubie_reset(cubie);
+
+        // Map the colors to sides by the fixed corner and the colors of the
+        // opposite sides of a reset cube.
+        memset(resetSide,CUBE_SIDE_COUNT,sizeof(resetSide));
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                resetSide[cube_get_reset_color((CubeSide_t)i)]=i;
+        }
+        memset(side,CUBE_SIDE_COUNT,sizeof(side));
+        for(o=0;o<3;o++){
+                j=packed->sticker[cornerFacelet[CUBE_CORNER_DBL][o]];
+                if(j>=CUBE_COLOR_COUNT||side[j]!=CUBE_SIDE_COUNT){
+                        return false;
+                }
+                side[j]=cornerSide[CUBE_CORNER_DBL][o];
+                i=resetSide[j];
+                if(i==CUBE_SIDE_COUNT){
+                        return false;
+                }
+                j=cube_get_reset_color((CubeSide_t)oppositeSide[i]);
+                if(side[j]!=CUBE_SIDE_COUNT){
+                        return false;
+                }
+                side[j]=oppositeSide[cornerSide[CUBE_CORNER_DBL][o]];
+        }
+
+        seen=0;
+        twist=0;
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                for(o=0;o<3;o++){
+                        j=packed->sticker[cornerFacelet[i][o]];
+                        s[o]=j<CUBE_COLOR_COUNT?side[j]:CUBE_SIDE_COUNT;
+                }
+                // The orientation is found without branches, which the
+                // random stickers would mispredict.
+                o=udOrientation[(s[0]==CUBE_SIDE_TOP||s[0]==CUBE_SIDE_BOTTOM)|
+                                (s[1]==CUBE_SIDE_TOP||s[1]==CUBE_SIDE_BOTTOM)<<1|
+                                (s[2]==CUBE_SIDE_TOP||s[2]==CUBE_SIDE_BOTTOM)<<2];
+                if(o==3||s[nextOrientation[o]]>=CUBE_SIDE_COUNT){
+                        return false;
+                }
+                j=cornerOfSides[s[o]-CUBE_SIDE_TOP][s[nextOrientation[o]]];
+                if(j==CUBE_CORNER_COUNT||s[nextOrientation[nextOrientation[o]]]!=cornerSide[j][2]){
+                        return false;
+                }
+                cubie->cp[i]=j;
+                cubie->co[i]=o;
+                seen|=1<<j;
+                twist+=o;
+        }
+        return seen==0xFF&&!(twist%3);
+}
+
+#if CUBE_SIZE==3
+
+bool
+cube_cubie_from_packed(
+        CubeCubie_t *cubie,
+        CubePacked_t *packed
+)
+{
+        uint8_t side[CUBE_COLOR_COUNT];
+        uint8_t s[3];
+        uint8_t i;
+        uint8_t j;
+        uint8_t o;
+
+        // Map the colors to sides by the centers.
+        memset(side,CUBE_SIDE_COUNT,sizeof(side));
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                j=packed->sticker[CUBE_PACKED_INDEX(i,1,1)];
+                if(j>=CUBE_COLOR_COUNT||side[j]!=CUBE_SIDE_COUNT){
+                        return false;
+                }
+                side[j]=i;
+        }
+
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                for(o=0;o<3;o++){
+                        j=packed->sticker[cornerFacelet[i][o]];
+                        s[o]=j<CUBE_COLOR_COUNT?side[j]:CUBE_SIDE_COUNT;
+                }
+                for(o=0;o<3;o++){
+                        if(s[o]==CUBE_SIDE_TOP||s[o]==CUBE_SIDE_BOTTOM){
+                                break;
+                        }
+                }
+                if(o==3||s[(o+1)%3]>=CUBE_SIDE_COUNT){
+                        return false;
+                }
+                j=cornerOfSides[s[o]-CUBE_SIDE_TOP][s[(o+1)%3]];
+                if(j==CUBE_CORNER_COUNT||s[(o+2)%3]!=cornerSide[j][2]){
+                        return false;
+                }
+                cubie->cp[i]=j;
+                cubie->co[i]=o;
+        }
+
+        for(i=0;i<CUBE_EDGE_COUNT;i++){
+                for(o=0;o<2;o++){
+                        j=packed->sticker[edgeFacelet[i][o]];
+                        s[o]=j<CUBE_COLOR_COUNT?side[j]:CUBE_SIDE_COUNT;
+                }
+                for(j=0;j<CUBE_EDGE_COUNT;j++){
+                        if(s[0]==edgeSide[j][0]&&s[1]==edgeSide[j][1]){
+                                cubie->eo[i]=0;
+                                break;
+                        }
+                        if(s[0]==edgeSide[j][1]&&s[1]==edgeSide[j][0]){
+                                cubie->eo[i]=1;
+                                break;
+                        }
+                }
+                if(j==CUBE_EDGE_COUNT){
+                        return false;
+                }
+                cubie->ep[i]=j;
+        }
+        return cube_cubie_is_valid(cubie);
+}
+
+void
+cube_cubie_to_packed(
+        CubeCubie_t *cubie,
+        CubePacked_t *packed
+)
+{
+        uint8_t i;
+        uint8_t o;
+
+        cube_packed_reset(packed);
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                for(o=0;o<3;o++){
+                        packed->sticker[cornerFacelet[i][(o+cubie->co[i])%3]]=
+                                cube_get_reset_color(cornerSide[cubie->cp[i]][o]);
+                }
+        }
+        for(i=0;i<CUBE_EDGE_COUNT;i++){
+                for(o=0;o<2;o++){
+                        packed->sticker[edgeFacelet[i][(o+cubie->eo[i])%2]]=
+                                cube_get_reset_color(edgeSide[cubie->ep[i]][o]);
+                }
+        }
+}
+
+bool
+cube_cubie_from_cube(
+        CubeCubie_t *cubie,
+        Cube_t *cube
+)
+{
+        CubePacked_t p;
+
+        cube_packed_from_cube(&p,cube);
+        return cube_cubie_from_packed(cubie,&p);
+}
+
+void
+cube_cubie_to_cube(
+        CubeCubie_t *cubie,
+        Cube_t *cube
+)
+{
+        CubePacked_t p;
+
+        cube_cubie_to_packed(cubie,&p);
+        cube_packed_to_cube(&p,cube);
+}
+
+#endif // if CUBE_SIZE==3
+
+/* EOF */
\ No newline at end of file
@@ -61,7 +61,7 @@ reset_game(
 )
 {
         cube_reset(&game->cube);
-        cube_shuffle(&game->cube);
+        cube_shuffle(&game->cube,&game->random,CUBE_SHUFFLE_LENGTH,NULL);
         game->turns=0;
         time(&game->time);
         game->isSolved=false;
@@ -99,13 +99,39 @@ cube_game_setup_input_interface(
         game->input.funcGet=funcGet;
 }
 
+void
+cube_game_setup_recorder_interface(
+        CubeGame_t *game,
+        CubeGame_Recorder_Start_t funcStart,
+        CubeGame_Recorder_Record_t funcRecord,
+        void *context
+)
+{
+        game->recorder.funcStart=funcStart;
+        game->recorder.funcRecord=funcRecord;
+        game->recorder.context=context;
+}
+
 void
 cube_game_init(
         CubeGame_t *game
 )
+{
+        cube_game_init_with_seed(game,(uint64_t)time(NULL));
+}
+
+void
+cube_game_init_with_seed(
+        CubeGame_t *game,
+        uint64_t seed
+)
 {
         game->graphics.funcInit();
         game->input.funcInit();
+        cube_random_seed(&game->random,seed);
+        if(game->recorder.funcStart){
+                game->recorder.funcStart(game->recorder.context,seed);
+        }
         reset_game(game);
 }
 
@@ -119,6 +145,9 @@ cube_game_run(
         game->graphics.functDrawCube(&game->cube);
         game->graphics.funcPrintStatistics(game->turns,game->time,"");
         c=game->input.funcGet();
+        if(c!=GAME_CONTROL_UNKNOWN&&game->recorder.funcRecord){
+                game->recorder.funcRecord(game->recorder.context,c);
+        }
 
         switch(c){
         case GAME_CONTROL_NEW:
@@ -0,0 +1,276 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_headless.c
+**  @ingroup    rubicscube
+**  @brief      Headless game driver for replaying controls.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_headless.h"
+#include "rubics_cube_thread.h"
+
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL VARIABLES
+**
+\******************************************************************************/
+
+/// The stream the input driver of the thread reads.
+static CUBE_THREAD_LOCAL CubeGameStream_t *currentStream;
+
+/// Number of controls the input driver of the thread has read.
+static CUBE_THREAD_LOCAL uint64_t controlCount;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Reads the next control from a stream.
+**
+**  @param[in] stream A pointer to a stream.
+**
+**  @return A control, or -1 at the end of the stream.
+*/
+static int
+read_control(
+        CubeGameStream_t *stream
+)
+{
+        CubeGameControl_t control;
+
+        if(stream->log){
+                if(!cube_log_reader_next_control(stream->log,&control,NULL)){
+                        return -1;
+                }
+                return control;
+        }
+        if(stream->position==stream->size){
+                if(!stream->file){
+                        return -1;
+                }
+                stream->size=fread(
+                        stream->buffer,
+                        1,
+                        sizeof(stream->buffer),
+                        stream->file
+                );
+                stream->position=0;
+                if(!stream->size){
+                        return -1;
+                }
+        }
+        return stream->data[stream->position++];
+}
+
+/******************************************************************************\
+**
+**  GRAPHICS DRIVER FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A function to init game graphics.
+*/
+static void
+headless_graphics_init(
+        void
+)
+{
+}
+
+/**
+**  @brief A function to draw a cube.
+**
+**  @param[in] cube A cube to draw.
+*/
+static void
+headless_graphics_draw_cube(
+        Cube_t *cube
+)
+{
+        (void)cube;
+}
+
+/**
+**  @brief Print game statistics.
+**
+**  @param[in] turns Turn count.
+**  @param[in] time Time.
+**  @param[in] player Player name.
+*/
+static void
+headless_graphics_print_statistics(
+        uint32_t turns,
+        time_t time,
+        int8_t *player
+)
+{
+        (void)turns;
+        (void)time;
+        (void)player;
+}
+
+/**
+**  @brief A function to draw a cube solved notification.
+*/
+static void
+headless_graphics_cube_solved(
+        void
+)
+{
+}
+
+/******************************************************************************\
+**
+**  INPUT DRIVER FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Initializes an input interface.
+*/
+static void
+headless_input_init(
+        void
+)
+{
+        controlCount=0;
+}
+
+/**
+**  @brief Gets an input control.
+**
+**  @return The next control of the stream, or GAME_CONTROL_EXIT at the end
+**          of the stream.
+*/
+static CubeGameControl_t
+headless_input_get(
+        void
+)
+{
+        int c;
+
+        c=read_control(currentStream);
+        if(c<0){
+                return GAME_CONTROL_EXIT;
+        }
+        controlCount++;
+        if(c>GAME_CONTROL_UNKNOWN){
+                return GAME_CONTROL_UNKNOWN;
+        }
+        return (CubeGameControl_t)c;
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+void
+cube_game_stream_memory(
+        CubeGameStream_t *stream,
+        const uint8_t *controls,
+        size_t count
+)
+{
+        stream->data=controls;
+        stream->size=count;
+        stream->position=0;
+        stream->file=NULL;
+        stream->log=NULL;
+}
+
+void
+cube_game_stream_file(
+        CubeGameStream_t *stream,
+        FILE *file
+)
+{
+        stream->data=stream->buffer;
+        stream->size=0;
+        stream->position=0;
+        stream->file=file;
+        stream->log=NULL;
+}
+
+void
+cube_game_stream_log(
+        CubeGameStream_t *stream,
+        CubeLogReader_t *log
+)
+{
+        stream->data=NULL;
+        stream->size=0;
+        stream->position=0;
+        stream->file=NULL;
+        stream->log=log;
+}
+
+uint64_t
+cube_game_headless_run(
+        CubeGame_t *game,
+        uint64_t seed,
+        CubeGameStream_t *stream
+)
+{
+        memset(game,0,sizeof(*game));
+        cube_game_setup_graphics_interface(
+                game,
+                headless_graphics_init,
+                headless_graphics_draw_cube,
+                headless_graphics_print_statistics,
+                headless_graphics_cube_solved
+        );
+        cube_game_setup_input_interface(
+                game,
+                headless_input_init,
+                headless_input_get
+        );
+        currentStream=stream;
+        cube_game_init_with_seed(game,seed);
+        while(cube_game_run(game));
+        currentStream=NULL;
+        return controlCount;
+}
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,472 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_log.c
+**  @ingroup    rubicscube
+**  @brief      Compact binary logs of game sessions.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_log.h"
+#include "rubics_cube_thread.h"
+
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANTS
+**
+\******************************************************************************/
+
+/// Mask of the control in the first byte of a record.
+#define CONTROL_MASK 0x0F
+
+/// Bits of the time in the first byte of a record.
+#define FIRST_TIME_BITS 3
+
+/// Flag of a byte of a record that is followed by more bytes.
+#define MORE_FLAG 0x80
+
+/// Nanoseconds per millisecond.
+#define NS_PER_MS 1000000
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Writes the buffer of a writer to its file.
+**
+**  @param[in] writer A pointer to a writer.
+*/
+static void
+flush_buffer(
+        CubeLogWriter_t *writer
+)
+{
+        if(writer->length){
+                fwrite(writer->buffer,1,writer->length,writer->file);
+                writer->length=0;
+        }
+}
+
+/**
+**  @brief Puts a 64-bit value to the buffer of a writer.
+**
+**  @param[in] writer A pointer to a writer.
+**  @param[in] value A value, written least significant byte first.
+*/
+static void
+put_uint64(
+        CubeLogWriter_t *writer,
+        uint64_t value
+)
+{
+        uint8_t i;
+
+        for(i=0;i<8;i++){
+                writer->buffer[writer->length++]=(uint8_t)(value>>(8*i));
+        }
+}
+
+/**
+**  @brief Gets a 64-bit value from a log.
+**
+**  @param[in] data The first byte of the value, least significant first.
+**
+**  @return The value.
+*/
+static uint64_t
+get_uint64(
+        const uint8_t *data
+)
+{
+        uint64_t value=0;
+        uint8_t i;
+
+        for(i=0;i<8;i++){
+                value|=(uint64_t)data[i]<<(8*i);
+        }
+        return value;
+}
+
+/**
+**  @brief Gets the clock time in milliseconds.
+**
+**  @return The time.
+*/
+static uint64_t
+clock_ms(
+        void
+)
+{
+        return cube_thread_clock()/NS_PER_MS;
+}
+
+/**
+**  @brief Starts a session for a game.
+**
+**  @param[in] context A pointer to a writer.
+**  @param[in] seed The seed of the shuffles of the game.
+*/
+static void
+recorder_start(
+        void *context,
+        uint64_t seed
+)
+{
+        cube_log_writer_start((CubeLogWriter_t*)context,seed);
+}
+
+/**
+**  @brief Records a control of a game.
+**
+**  @param[in] context A pointer to a writer.
+**  @param[in] control A control.
+*/
+static void
+recorder_record(
+        void *context,
+        CubeGameControl_t control
+)
+{
+        cube_log_writer_record((CubeLogWriter_t*)context,control);
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_log_writer_open(
+        CubeLogWriter_t *writer,
+        const char *path
+)
+{
+        writer->file=fopen(path,"ab");
+        writer->time=0;
+        writer->isInSession=false;
+        writer->length=0;
+        return writer->file!=NULL;
+}
+
+bool
+cube_log_writer_close(
+        CubeLogWriter_t *writer
+)
+{
+        bool isOk;
+
+        cube_log_writer_record(writer,GAME_CONTROL_EXIT);
+        flush_buffer(writer);
+        isOk=!ferror(writer->file);
+        return !fclose(writer->file)&&isOk;
+}
+
+void
+cube_log_writer_start(
+        CubeLogWriter_t *writer,
+        uint64_t seed
+)
+{
+        cube_log_writer_record(writer,GAME_CONTROL_EXIT);
+        if(writer->length+CUBE_LOG_HEADER_SIZE>sizeof(writer->buffer)){
+                flush_buffer(writer);
+        }
+        memcpy(writer->buffer+writer->length,CUBE_LOG_MAGIC,4);
+        writer->length+=4;
+        writer->buffer[writer->length++]=CUBE_LOG_VERSION;
+        writer->buffer[writer->length++]=CUBE_SIZE;
+        put_uint64(writer,seed);
+        put_uint64(writer,(uint64_t)(int64_t)time(NULL));
+        writer->time=clock_ms();
+        writer->isInSession=true;
+}
+
+void
+cube_log_writer_record(
+        CubeLogWriter_t *writer,
+        CubeGameControl_t control
+)
+{
+        uint64_t now;
+        uint64_t delta;
+        uint8_t *p;
+
+        if(!writer->isInSession||control>=GAME_CONTROL_UNKNOWN){
+                return;
+        }
+        now=clock_ms();
+        delta=now-writer->time;
+        writer->time=now;
+        if(writer->length+CUBE_LOG_RECORD_MAX_SIZE>sizeof(writer->buffer)){
+                flush_buffer(writer);
+        }
+        p=writer->buffer+writer->length;
+        *p=(uint8_t)(control|(delta<<4&0x70));
+        delta>>=FIRST_TIME_BITS;
+        while(delta){
+                *p++|=MORE_FLAG;
+                *p=(uint8_t)(delta&0x7F);
+                delta>>=7;
+        }
+        // Only a header may hold the first byte of the magic.
+        if(*p==(uint8_t)CUBE_LOG_MAGIC[0]){
+                *p++|=MORE_FLAG;
+                *p=0;
+        }
+        writer->length=(size_t)(p+1-writer->buffer);
+        if(control==GAME_CONTROL_EXIT){
+                writer->isInSession=false;
+                flush_buffer(writer);
+        }
+}
+
+void
+cube_log_writer_attach(
+        CubeLogWriter_t *writer,
+        CubeGame_t *game
+)
+{
+        cube_game_setup_recorder_interface(
+                game,
+                recorder_start,
+                recorder_record,
+                writer
+        );
+}
+
+bool
+cube_log_reader_open(
+        CubeLogReader_t *reader,
+        const char *path
+)
+{
+#if defined(_WIN32)
+        HANDLE file;
+        LARGE_INTEGER size;
+
+        cube_log_reader_memory(reader,NULL,0);
+        file=CreateFileA(
+                path,
+                GENERIC_READ,
+                FILE_SHARE_READ|FILE_SHARE_WRITE,
+                NULL,
+                OPEN_EXISTING,
+                FILE_FLAG_SEQUENTIAL_SCAN,
+                NULL
+        );
+        if(file==INVALID_HANDLE_VALUE){
+                return false;
+        }
+        if(!GetFileSizeEx(file,&size)){
+                CloseHandle(file);
+                return false;
+        }
+        if(!size.QuadPart){
+                CloseHandle(file);
+                return true;
+        }
+        reader->mapping=CreateFileMappingA(file,NULL,PAGE_READONLY,0,0,NULL);
+        CloseHandle(file);
+        if(!reader->mapping){
+                return false;
+        }
+        reader->data=MapViewOfFile(reader->mapping,FILE_MAP_READ,0,0,0);
+        if(!reader->data){
+                CloseHandle(reader->mapping);
+                return false;
+        }
+        reader->size=(size_t)size.QuadPart;
+        reader->isMapped=true;
+        return true;
+#else
+        int file;
+        struct stat st;
+        void *data;
+
+        cube_log_reader_memory(reader,NULL,0);
+        file=open(path,O_RDONLY);
+        if(file<0){
+                return false;
+        }
+        if(fstat(file,&st)){
+                close(file);
+                return false;
+        }
+        if(!st.st_size){
+                close(file);
+                return true;
+        }
+        data=mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,file,0);
+        close(file);
+        if(data==MAP_FAILED){
+                return false;
+        }
+        reader->data=data;
+        reader->size=(size_t)st.st_size;
+        reader->isMapped=true;
+        return true;
+#endif
+}
+
+void
+cube_log_reader_memory(
+        CubeLogReader_t *reader,
+        const uint8_t *data,
+        size_t size
+)
+{
+        reader->data=data;
+        reader->size=size;
+        reader->position=0;
+        reader->time=0;
+        reader->isInSession=false;
+        reader->isMapped=false;
+}
+
+void
+cube_log_reader_close(
+        CubeLogReader_t *reader
+)
+{
+        if(reader->isMapped){
+#if defined(_WIN32)
+                UnmapViewOfFile(reader->data);
+                CloseHandle(reader->mapping);
+#else
+                munmap((void*)reader->data,reader->size);
+#endif
+        }
+        cube_log_reader_memory(reader,NULL,0);
+}
+
+bool
+cube_log_reader_next_session(
+        CubeLogReader_t *reader,
+        CubeLogSession_t *session
+)
+{
+        const uint8_t *p;
+        CubeGameControl_t control;
+
+        while(cube_log_reader_next_control(reader,&control,NULL));
+        for(;;){
+                if(reader->size-reader->position<CUBE_LOG_HEADER_SIZE){
+                        reader->position=reader->size;
+                        return false;
+                }
+                p=reader->data+reader->position;
+                if(!memcmp(p,CUBE_LOG_MAGIC,4)&&p[4]==CUBE_LOG_VERSION){
+                        break;
+                }
+                // Not a header, skip to the next possible one.
+                p=memchr(
+                        p+1,
+                        CUBE_LOG_MAGIC[0],
+                        reader->size-reader->position-1
+                );
+                reader->position=p?(size_t)(p-reader->data):reader->size;
+        }
+        session->size=p[5];
+        session->seed=get_uint64(p+6);
+        session->startTime=(int64_t)get_uint64(p+14);
+        reader->position+=CUBE_LOG_HEADER_SIZE;
+        reader->time=0;
+        reader->isInSession=true;
+        return true;
+}
+
+bool
+cube_log_reader_next_control(
+        CubeLogReader_t *reader,
+        CubeGameControl_t *control,
+        uint64_t *time
+)
+{
+        const uint8_t *p=reader->data+reader->position;
+        const uint8_t *end=reader->data+reader->size;
+        uint64_t delta;
+        uint8_t shift;
+        uint8_t c;
+
+        // The first byte of the magic starts the next session.
+        if(!reader->isInSession||p==end||*p==(uint8_t)CUBE_LOG_MAGIC[0]){
+                reader->isInSession=false;
+                return false;
+        }
+        c=*p&CONTROL_MASK;
+        delta=*p>>4&0x07;
+        shift=FIRST_TIME_BITS;
+        while(*p++&MORE_FLAG){
+                if(p==end||*p==(uint8_t)CUBE_LOG_MAGIC[0]){
+                        // A truncated record ends the session.
+                        reader->position=(size_t)(p-reader->data);
+                        reader->isInSession=false;
+                        return false;
+                }
+                if(shift<64){
+                        delta|=(uint64_t)(*p&0x7F)<<shift;
+                }
+                shift+=7;
+        }
+        reader->position=(size_t)(p-reader->data);
+        reader->time+=delta;
+        *control=(CubeGameControl_t)c;
+        if(time){
+                *time=reader->time;
+        }
+        if(c==GAME_CONTROL_EXIT){
+                reader->isInSession=false;
+        }
+        return true;
+}
+
+/* EOF */
\ No newline at end of file
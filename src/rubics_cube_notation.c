@@ -0,0 +1,626 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_notation.c
+**  @ingroup    rubicscube
+**  @brief      Move notation parser and formatter.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_notation.h"
+
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Kinds of move letters.
+*/
+typedef enum
+LetterKind_t{
+        /// An outer layer of a side.
+        LETTER_KIND_FACE=0,
+        /// All inner layers.
+        LETTER_KIND_SLICE,
+        /// The whole cube.
+        LETTER_KIND_ROTATION
+} LetterKind_t;
+
+/**
+**  @brief A move letter.
+*/
+typedef struct
+Letter_t{
+        /// The letter.
+        char name;
+        /// Kind of the letter (LetterKind_t).
+        uint8_t kind;
+        /// Axis of the turned layers (CubeAxis_t).
+        uint8_t axis;
+        /// The layers are counted from the last layer of the axis.
+        bool far;
+        /// The letter turns against the positive direction of the axis.
+        bool inverse;
+} Letter_t;
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Number of move letters.
+#define LETTER_COUNT 12
+
+/// Move letters.
+static const Letter_t letters[LETTER_COUNT]={
+        {'U',LETTER_KIND_FACE,CUBE_AXIS_Y,false,false},
+        {'D',LETTER_KIND_FACE,CUBE_AXIS_Y,true,true},
+        {'F',LETTER_KIND_FACE,CUBE_AXIS_Z,false,false},
+        {'B',LETTER_KIND_FACE,CUBE_AXIS_Z,true,true},
+        {'L',LETTER_KIND_FACE,CUBE_AXIS_X,false,true},
+        {'R',LETTER_KIND_FACE,CUBE_AXIS_X,true,false},
+        {'M',LETTER_KIND_SLICE,CUBE_AXIS_X,false,true},
+        {'E',LETTER_KIND_SLICE,CUBE_AXIS_Y,false,true},
+        {'S',LETTER_KIND_SLICE,CUBE_AXIS_Z,false,false},
+        {'x',LETTER_KIND_ROTATION,CUBE_AXIS_X,false,false},
+        {'y',LETTER_KIND_ROTATION,CUBE_AXIS_Y,false,false},
+        {'z',LETTER_KIND_ROTATION,CUBE_AXIS_Z,false,false}
+};
+
+/// The largest number accepted in a move.
+#define NUMBER_MAX 999
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Finds a move letter by name.
+**
+**  A lower case face letter is found as the upper case one, and it is
+**  reported as a wide move.
+**
+**  @param[in] name A letter.
+**  @param[out] wide Set when the letter is a wide move.
+**
+**  @return A pointer to the letter, or NULL if the letter is not a move.
+*/
+static const Letter_t *
+find_letter(
+        char name,
+        bool *wide
+)
+{
+        uint8_t i;
+
+        *wide=false;
+        for(i=0;i<LETTER_COUNT;i++){
+                if(letters[i].name==name){
+                        return &letters[i];
+                }
+        }
+        for(i=0;i<LETTER_COUNT;i++){
+                if(letters[i].kind==LETTER_KIND_FACE&&letters[i].name-'A'+'a'==name){
+                        *wide=true;
+                        return &letters[i];
+                }
+        }
+        return NULL;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Finds the move letter of an axis.
+**
+**  @param[in] kind Kind of the letter.
+**  @param[in] axis Axis of the letter.
+**  @param[in] far Set for the face on the last layer of the axis.
+**
+**  @return A pointer to the letter.
+*/
+static const Letter_t *
+find_axis_letter(
+        LetterKind_t kind,
+        uint8_t axis,
+        bool far
+)
+{
+        uint8_t i;
+
+        for(i=0;i<LETTER_COUNT;i++){
+                if(letters[i].kind==kind&&letters[i].axis==axis&&
+                   (kind!=LETTER_KIND_FACE||letters[i].far==far)){
+                        break;
+                }
+        }
+        return &letters[i];
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Reads a decimal number.
+**
+**  @param[in] text A pointer to the text.
+**  @param[out] number The number read, or 0 if there are no digits.
+**
+**  @return A pointer to the character after the number.
+*/
+static char *
+read_number(
+        char *text,
+        uint32_t *number
+)
+{
+        *number=0;
+        while(*text>='0'&&*text<='9'){
+                if(*number<=NUMBER_MAX){
+                        *number=*number*10+(uint32_t)(*text-'0');
+                }
+                text++;
+        }
+        return text;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Adds a move to the accumulated layer turns.
+**
+**  @param[in,out] acc Quarter turns of each layer.
+**  @param[in] move A move to add.
+*/
+static void
+accumulate(
+        uint8_t *acc,
+        CubeMove_t *move
+)
+{
+        uint16_t layer;
+
+        for(layer=move->first;layer<=move->last&&layer<CUBE_SIZE;layer++){
+                acc[layer]=(acc[layer]+move->turns)&3;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Counts the moves needed for the accumulated layer turns.
+**
+**  @param[in] acc Quarter turns of each layer.
+**
+**  @return Number of runs of adjacent layers with equal turns.
+*/
+static uint32_t
+count_runs(
+        uint8_t *acc
+)
+{
+        uint16_t layer;
+        uint32_t runs;
+
+        runs=0;
+        for(layer=0;layer<CUBE_SIZE;layer++){
+                if(acc[layer]&&(!layer||acc[layer]!=acc[layer-1])){
+                        runs++;
+                }
+        }
+        return runs;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Writes the accumulated layer turns as moves.
+**
+**  @param[in] acc Quarter turns of each layer.
+**  @param[in] axis Axis of the layers.
+**  @param[out] moves A buffer for the moves.
+*/
+static void
+emit_runs(
+        uint8_t *acc,
+        uint8_t axis,
+        CubeMove_t *moves
+)
+{
+        uint16_t layer;
+
+        for(layer=0;layer<CUBE_SIZE;layer++){
+                if(!acc[layer]){
+                        continue;
+                }
+                if(layer&&acc[layer]==acc[layer-1]){
+                        moves[-1].last=(uint8_t)layer;
+                        continue;
+                }
+                moves->axis=axis;
+                moves->first=(uint8_t)layer;
+                moves->last=(uint8_t)layer;
+                moves->turns=acc[layer];
+                moves++;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Appends a character to a text buffer.
+**
+**  @param[out] text A text buffer.
+**  @param[in] size Size of the buffer.
+**  @param[in,out] length Length of the text.
+**  @param[in] c A character to append.
+**
+**  @retval true The character was appended.
+**  @retval false The buffer is full.
+*/
+static bool
+put_char(
+        char *text,
+        uint32_t size,
+        uint32_t *length,
+        char c
+)
+{
+        if(*length+1>=size){
+                return false;
+        }
+        text[(*length)++]=c;
+        text[*length]='\0';
+        return true;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Appends a move letter with its layer count and turns.
+**
+**  @param[out] text A text buffer.
+**  @param[in] size Size of the buffer.
+**  @param[in,out] length Length of the text.
+**  @param[in] letter A move letter.
+**  @param[in] depth Number of the layer counted from the side (1-), or 0 for
+**                   no number.
+**  @param[in] wide Set to turn all layers up to the depth.
+**  @param[in] turns Quarter turns in the direction of the letter (1-3).
+**
+**  @retval true The move was appended.
+**  @retval false The buffer is full.
+*/
+static bool
+put_letter(
+        char *text,
+        uint32_t size,
+        uint32_t *length,
+        const Letter_t *letter,
+        uint8_t depth,
+        bool wide,
+        uint8_t turns
+)
+{
+        char digits[3];
+        uint8_t n;
+
+        if(*length&&!put_char(text,size,length,' ')){
+                return false;
+        }
+        if(depth){
+                n=0;
+                do{
+                        digits[n++]=(char)('0'+depth%10);
+                        depth/=10;
+                }while(depth);
+                while(n){
+                        if(!put_char(text,size,length,digits[--n])){
+                                return false;
+                        }
+                }
+        }
+        if(!put_char(text,size,length,letter->name)){
+                return false;
+        }
+        if(wide&&!put_char(text,size,length,'w')){
+                return false;
+        }
+        switch(turns){
+        default:
+                return true;
+        case 2:
+                return put_char(text,size,length,'2');
+        case 3:
+                return put_char(text,size,length,'\'');
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Appends a move of layers counted from a side.
+**
+**  @param[out] text A text buffer.
+**  @param[in] size Size of the buffer.
+**  @param[in,out] length Length of the text.
+**  @param[in] letter A face letter.
+**  @param[in] from The first layer counted from the side (1-).
+**  @param[in] to The last layer counted from the side.
+**  @param[in] turns Quarter turns in the direction of the letter (1-3).
+**
+**  @retval true The move was appended.
+**  @retval false The buffer is full.
+*/
+static bool
+put_face(
+        char *text,
+        uint32_t size,
+        uint32_t *length,
+        const Letter_t *letter,
+        uint8_t from,
+        uint8_t to,
+        uint8_t turns
+)
+{
+        if(from==to){
+                return put_letter(text,size,length,letter,from>1?from:0,false,turns);
+        }
+        if(from==1){
+                return put_letter(text,size,length,letter,to>2?to:0,true,turns);
+        }
+        // Inner layers are the difference of two wide moves.
+        return put_face(text,size,length,letter,1,to,turns)&&
+               put_face(text,size,length,letter,1,from-1,(4-turns)&3);
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_notation_parse(
+        char *text,
+        CubeMove_t *moves,
+        uint32_t capacity,
+        uint32_t *count
+)
+{
+        const Letter_t *letter;
+        char *next;
+        bool wide;
+        uint32_t depth;
+        uint32_t turns;
+        uint32_t from;
+        uint32_t to;
+
+        *count=0;
+        for(;;){
+                while(*text==' '||*text=='\t'||*text=='\r'||*text=='\n'){
+                        text++;
+                }
+                if(!*text){
+                        return true;
+                }
+                next=read_number(text,&depth);
+                letter=find_letter(*next,&wide);
+                if(!letter||(next!=text&&!depth)){
+                        return false;
+                }
+                if(next!=text&&letter->kind!=LETTER_KIND_FACE){
+                        return false;
+                }
+                text=next+1;
+                if(!wide&&letter->kind==LETTER_KIND_FACE&&*text=='w'){
+                        wide=true;
+                        text++;
+                }
+                next=read_number(text,&turns);
+                if(next==text){
+                        turns=1;
+                }
+                text=next;
+                if(*text=='\''){
+                        turns=4-(turns&3);
+                        text++;
+                }
+                switch(letter->kind){
+                default:
+                        from=1;
+                        to=CUBE_SIZE;
+                        break;
+                case LETTER_KIND_FACE:
+                        if(wide){
+                                from=1;
+                                to=depth?depth:2;
+                        }
+                        else{
+                                from=depth?depth:1;
+                                to=from;
+                        }
+                        break;
+                case LETTER_KIND_SLICE:
+                        from=2;
+                        to=CUBE_SIZE-1;
+                        break;
+                }
+                if(from>to||to>CUBE_SIZE){
+                        return false;
+                }
+                turns&=3;
+                if(!turns){
+                        continue;
+                }
+                if(*count>=capacity){
+                        return false;
+                }
+                moves[*count].axis=letter->axis;
+                moves[*count].first=(uint8_t)(letter->far?CUBE_SIZE-to:from-1);
+                moves[*count].last=(uint8_t)(letter->far?CUBE_SIZE-from:to-1);
+                moves[*count].turns=(uint8_t)(letter->inverse?4-turns:turns);
+                (*count)++;
+        }
+}
+
+uint32_t
+cube_notation_simplify(
+        CubeMove_t *moves,
+        uint32_t count
+)
+{
+        uint8_t acc[CUBE_SIZE];
+        uint8_t axis;
+        uint32_t read;
+        uint32_t write;
+        uint32_t start;
+        uint32_t group;
+        uint32_t runs;
+        uint32_t i;
+
+        read=0;
+        write=0;
+        while(read<count){
+                axis=moves[read].axis;
+                memset(acc,0,sizeof(acc));
+                // A group may continue the one written before it, when the
+                // moves between them have cancelled out.
+                start=write;
+                while(start&&moves[start-1].axis==axis){
+                        start--;
+                        accumulate(acc,&moves[start]);
+                }
+                group=read;
+                while(read<count&&moves[read].axis==axis){
+                        accumulate(acc,&moves[read]);
+                        read++;
+                }
+                runs=count_runs(acc);
+                if(runs<=write-start+read-group){
+                        emit_runs(acc,axis,&moves[start]);
+                        write=start+runs;
+                }
+                else{
+                        for(i=group;i<read;i++){
+                                moves[write++]=moves[i];
+                        }
+                }
+        }
+        return write;
+}
+
+bool
+cube_notation_format(
+        CubeMove_t *moves,
+        uint32_t count,
+        char *text,
+        uint32_t size
+)
+{
+        const Letter_t *letter;
+        uint32_t length;
+        uint32_t i;
+        uint8_t first;
+        uint8_t last;
+        uint8_t from;
+        uint8_t turns;
+
+        if(!size){
+                return false;
+        }
+        length=0;
+        text[0]='\0';
+        for(i=0;i<count;i++){
+                first=moves[i].first;
+                last=moves[i].last<CUBE_SIZE?moves[i].last:CUBE_SIZE-1;
+                turns=moves[i].turns&3;
+                if(!turns||first>last||moves[i].axis>=CUBE_AXIS_COUNT){
+                        continue;
+                }
+                if(!first&&last==CUBE_SIZE-1){
+                        letter=find_axis_letter(LETTER_KIND_ROTATION,moves[i].axis,false);
+                        if(!put_letter(text,size,&length,letter,0,false,turns)){
+                                return false;
+                        }
+                        continue;
+                }
+                if(first==1&&last==CUBE_SIZE-2){
+                        letter=find_axis_letter(LETTER_KIND_SLICE,moves[i].axis,false);
+                        if(!put_letter(text,size,&length,letter,0,false,letter->inverse?4-turns:turns)){
+                                return false;
+                        }
+                        continue;
+                }
+                // Count the layers from the nearer side.
+                if(first<=CUBE_SIZE-1-last){
+                        letter=find_axis_letter(LETTER_KIND_FACE,moves[i].axis,false);
+                        first++;
+                        last++;
+                }
+                else{
+                        letter=find_axis_letter(LETTER_KIND_FACE,moves[i].axis,true);
+                        from=CUBE_SIZE-last;
+                        last=CUBE_SIZE-first;
+                        first=from;
+                }
+                if(!put_face(text,size,&length,letter,first,last,letter->inverse?4-turns:turns)){
+                        return false;
+                }
+        }
+        return true;
+}
+
+bool
+cube_notation_format_turns(
+        CubeTurn_t *turns,
+        uint32_t count,
+        char *text,
+        uint32_t size
+)
+{
+        static const char faces[]="URFDLB";
+        uint32_t length;
+        uint32_t i;
+        bool wide;
+
+        if(!size){
+                return false;
+        }
+        length=0;
+        text[0]='\0';
+        for(i=0;i<count;i++){
+                if(turns[i]>=CUBE_TURN_COUNT){
+                        continue;
+                }
+                if(!put_letter(text,size,&length,find_letter(faces[turns[i]/3],&wide),0,false,turns[i]%3+1)){
+                        return false;
+                }
+        }
+        return true;
+}
+
+/* EOF */
\ No newline at end of file
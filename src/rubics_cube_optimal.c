@@ -0,0 +1,1625 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_optimal.c
+**  @ingroup    rubicscube
+**  @brief      Optimal solver for the 2x2x2 and 3x3x3 cubes.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_optimal.h"
+#include "rubics_cube_thread.h"
+
+#if CUBE_SIZE==2||CUBE_SIZE==3
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_M_X64)||defined(_M_IX86)||defined(__x86_64__)||defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+#if CUBE_SIZE==2
+
+/// Number of moves, the turns of the top, right and front sides.
+#define MOVE_COUNT 9
+
+/// Number of corner orientations with one corner fixed.
+#define TWIST_COUNT 729
+
+/// Number of corner permutations with one corner fixed.
+#define PERM_COUNT 5040
+
+/// Number of positions.
+#define POSITION_COUNT (PERM_COUNT*TWIST_COUNT)
+
+/// Size of the distance table in bytes.
+#define DISTANCE_BYTES ((POSITION_COUNT+1)/2)
+
+/// Size of the distance tables in bytes.
+#define PRUNE_BYTES DISTANCE_BYTES
+
+#else
+
+/// Number of moves.
+#define MOVE_COUNT CUBE_TURN_COUNT
+
+/// Number of corner orientations.
+#define TWIST_COUNT 2187
+
+/// Number of corner permutations.
+#define PERM_COUNT 40320
+
+/// Number of corner positions and orientations.
+#define CORNER_COUNT (PERM_COUNT*TWIST_COUNT)
+
+/// Number of edge orientations.
+#define FLIP_COUNT 2048
+
+/// Number of position sets of the middle layer edges.
+#define SLICE_COUNT 495
+
+/// Number of orders of the middle layer edges.
+#define SLICE_ORDER_COUNT 24
+
+/// Number of edge orientations and middle layer edge positions.
+#define FLIPSLICE_COUNT (SLICE_COUNT*FLIP_COUNT)
+
+/// Number of symmetry classes of the edge orientations and middle layer
+/// edge positions.
+#define FLIPSLICE_CLASS_COUNT 64430
+
+/// Number of symmetries that keep the vertical axis.
+#define SYM_COUNT 16
+
+/// Number of entries in the phase 1 distance table.
+#define PHASE1_COUNT (FLIPSLICE_CLASS_COUNT*TWIST_COUNT)
+
+/// Marks an edge orientation and position without a class.
+#define NO_CLASS 0xFFFFFFFF
+
+/// Size of the corner pattern database in bytes.
+#define CORNER_PRUNE_BYTES ((CORNER_COUNT+1)/2)
+
+/// Size of the phase 1 distance table in bytes, in whole 32-bit words.
+#define PHASE1_PRUNE_BYTES ((PHASE1_COUNT+7)/8*4)
+
+/// Size of the symmetry class table in bytes.
+#define CLASS_BYTES (FLIPSLICE_COUNT*4)
+
+/// Size of the class representative table in bytes.
+#define REP_BYTES (FLIPSLICE_CLASS_COUNT*4)
+
+/// Size of the class symmetry table in bytes.
+#define STAB_BYTES (FLIPSLICE_CLASS_COUNT*2)
+
+/// Size of the conjugated corner orientation table in bytes.
+#define TWIST_CONJ_BYTES (TWIST_COUNT*SYM_COUNT*2)
+
+/// Size of the edge orientation move table in bytes.
+#define FLIP_MOVE_BYTES (FLIP_COUNT*MOVE_COUNT*2)
+
+/// Size of the middle layer edge move table in bytes.
+#define SLICE_MOVE_BYTES (SLICE_COUNT*MOVE_COUNT*2)
+
+/// Size of the distance tables in bytes.
+#define PRUNE_BYTES (CORNER_PRUNE_BYTES+PHASE1_PRUNE_BYTES)
+
+#endif // if CUBE_SIZE==2
+
+/// Size of the corner orientation move table in bytes.
+#define TWIST_MOVE_BYTES (TWIST_COUNT*MOVE_COUNT*2)
+
+/// Size of the corner permutation move table in bytes.
+#define PERM_MOVE_BYTES (PERM_COUNT*MOVE_COUNT*2)
+
+/// Size of all tables in bytes.
+#if CUBE_SIZE==2
+#define TABLE_BYTES (PRUNE_BYTES+PERM_MOVE_BYTES+TWIST_MOVE_BYTES)
+#else
+#define TABLE_BYTES (PRUNE_BYTES+CLASS_BYTES+REP_BYTES+TWIST_CONJ_BYTES+\
+        PERM_MOVE_BYTES+TWIST_MOVE_BYTES+FLIP_MOVE_BYTES+SLICE_MOVE_BYTES+\
+        STAB_BYTES)
+#endif
+
+/// Distance table value of an unvisited entry, and the largest distance.
+#define PRUNE_EMPTY 15
+
+/// Identifier of the table set.
+#define TABLE_ID 0x4F534352
+
+/// Version of the table set. Version 1 had only the distance tables.
+#define TABLE_VERSION 2
+
+#if CUBE_SIZE==3
+
+/// Length of the move sequences that split a search into tasks.
+#define TASK_LENGTH 3
+
+/// The largest number of tasks, sequences of allowed moves.
+#define TASK_MAX_COUNT (MOVE_COUNT*15*15)
+
+/// The shortest search depth that is split to several threads.
+#define PARALLEL_MIN_DEPTH 12
+
+/// Search bound before a solution is found.
+#define NO_SOLUTION 0xFF
+
+#endif // if CUBE_SIZE==3
+
+/// Starts to read a table entry to the cache.
+#if defined(_M_X64)||defined(_M_IX86)||defined(__x86_64__)||defined(__i386__)
+#define PREFETCH(p) _mm_prefetch((const char *)(p),_MM_HINT_T0)
+#elif defined(__GNUC__)
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p) ((void)(p))
+#endif
+
+#if CUBE_SIZE==3
+
+/**
+**  @brief Symmetries that generate the symmetries of the cube.
+**
+**  A rotation of 120 degrees around the URF-DBL diagonal, a rotation of 180
+**  degrees around the F-B axis, a rotation of 90 degrees around the U-D axis
+**  and a reflection of the left and right sides.
+*/
+static const CubeCubie_t
+symUrf3={
+        {0,4,5,1,3,7,6,2},
+        {1,2,1,2,2,1,2,1},
+        {1,8,5,9,3,11,7,10,0,4,6,2},
+        {1,0,1,0,1,0,1,0,1,1,1,1}
+},
+symF2={
+        {5,4,7,6,1,0,3,2},
+        {0,0,0,0,0,0,0,0},
+        {6,5,4,7,2,1,0,3,9,8,11,10},
+        {0,0,0,0,0,0,0,0,0,0,0,0}
+},
+symU4={
+        {3,0,1,2,7,4,5,6},
+        {0,0,0,0,0,0,0,0},
+        {3,0,1,2,7,4,5,6,11,8,9,10},
+        {0,0,0,0,0,0,0,0,1,1,1,1}
+},
+symLr2={
+        {1,0,3,2,5,4,7,6},
+        {3,3,3,3,3,3,3,3},
+        {2,1,0,3,6,5,4,7,9,8,11,10},
+        {0,0,0,0,0,0,0,0,0,0,0,0}
+};
+
+#endif // if CUBE_SIZE==3
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A step of a distance table search.
+**
+**  @param[in] optimal The solver.
+**  @param[in] index A distance table index.
+**  @param[in] move A move.
+**
+**  @return The index reached with the move.
+*/
+typedef uint32_t
+(*DistanceStep_t)(
+        CubeOptimal_t *optimal,
+        uint32_t index,
+        uint8_t move
+);
+
+/**
+**  @brief Fills the entries equal to a distance table entry.
+**
+**  @param[in] optimal The solver.
+**  @param[in] table The distance table.
+**  @param[in] index A distance table index.
+**  @param[in] value The distance of the index.
+**
+**  @return Number of entries filled.
+*/
+typedef uint32_t
+(*DistanceFill_t)(
+        CubeOptimal_t *optimal,
+        uint8_t *table,
+        uint32_t index,
+        uint8_t value
+);
+
+#if CUBE_SIZE==3
+
+/**
+**  @brief State of one search.
+*/
+typedef struct
+Search_t{
+        /// The solver.
+        CubeOptimal_t *optimal;
+        /// The cube to solve.
+        CubeCubie_t cubie;
+        /// Length of the shortest solution found by any thread, or
+        /// NO_SOLUTION. The search stops when it is not longer than the
+        /// current depth.
+        volatile uint32_t *best;
+        /// Moves of the current path.
+        uint8_t moves[CUBE_OPTIMAL_MAX_LENGTH];
+} Search_t;
+
+/**
+**  @brief Children of a search node that are not pruned.
+*/
+typedef struct
+Children_t{
+        /// Number of children.
+        uint8_t count;
+        /// Move to each child.
+        uint8_t move[MOVE_COUNT];
+        /// Corner pattern database index of each child.
+        uint32_t corners[MOVE_COUNT];
+        /// Phase 1 coordinates of each child from each axis.
+        CubeOptimalAxis_t axis[MOVE_COUNT][CUBE_OPTIMAL_AXIS_COUNT];
+} Children_t;
+
+/**
+**  @brief A subtree of a search, reached by a few moves from the root.
+*/
+typedef struct
+Task_t{
+        /// Corner pattern database index.
+        uint32_t corners;
+        /// Phase 1 coordinates from each axis.
+        CubeOptimalAxis_t axis[CUBE_OPTIMAL_AXIS_COUNT];
+        /// Moves from the root.
+        uint8_t moves[TASK_LENGTH];
+} Task_t;
+
+/**
+**  @brief A thread of a parallel search.
+*/
+typedef struct
+Worker_t{
+        /// Search state of the thread.
+        Search_t search;
+        /// The tasks of the thread that are not started, first<<16|end.
+        /// The thread takes tasks from the front and the other threads
+        /// steal them from the back.
+        volatile uint32_t queue;
+        /// The thread.
+        CubeThread_t thread;
+        /// Index of the worker.
+        uint32_t index;
+        /// The parallel search.
+        struct Parallel_t *parallel;
+} Worker_t;
+
+/**
+**  @brief A search split to several threads.
+*/
+typedef struct
+Parallel_t{
+        /// Search depth.
+        uint8_t depth;
+        /// Shortest solution found by any thread, or NO_SOLUTION.
+        volatile uint32_t best;
+        /// The solution.
+        uint8_t moves[CUBE_OPTIMAL_MAX_LENGTH];
+        /// Tasks.
+        Task_t *tasks;
+        /// Number of tasks.
+        uint32_t taskCount;
+        /// Threads, the first one is the calling thread.
+        Worker_t *workers;
+        /// Number of threads.
+        uint32_t workerCount;
+} Parallel_t;
+
+#endif // if CUBE_SIZE==3
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets a distance from a distance table.
+**
+**  @param[in] table A distance table of 4-bit entries.
+**  @param[in] index An entry.
+**
+**  @return The distance.
+*/
+static inline uint8_t
+get_distance(
+        uint8_t *table,
+        uint32_t index
+)
+{
+        return (table[index>>1]>>((index&1)<<2))&0x0F;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets a distance to a distance table.
+**
+**  @param[in] table A distance table of 4-bit entries.
+**  @param[in] index An entry.
+**  @param[in] value The distance.
+*/
+static inline void
+set_distance(
+        uint8_t *table,
+        uint32_t index,
+        uint8_t value
+)
+{
+        uint8_t shift;
+
+        shift=(uint8_t)((index&1)<<2);
+        table[index>>1]=(uint8_t)((table[index>>1]&~(0x0F<<shift))|(value<<shift));
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Pruning step for the corners.
+*/
+static uint32_t
+step_corners(
+        CubeOptimal_t *optimal,
+        uint32_t index,
+        uint8_t move
+)
+{
+        uint32_t perm;
+        uint32_t twist;
+
+        perm=optimal->cornerMove[index/TWIST_COUNT*MOVE_COUNT+move];
+        twist=optimal->twistMove[index%TWIST_COUNT*MOVE_COUNT+move];
+        return perm*TWIST_COUNT+twist;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Fills a distance table with a breadth-first search.
+**
+**  The solved state has the entry 0. When more than half of the table is
+**  filled, the search continues backwards from the unvisited entries, which
+**  then are fewer than the visited ones. The moves must include the inverse
+**  of each move.
+**
+**  @param[in] optimal The solver with the move tables ready.
+**  @param[out] table A distance table.
+**  @param[in] count Number of entries.
+**  @param[in] step A step function.
+**  @param[in] fill A function to fill the equal entries, or NULL if each
+**                  state has one entry.
+*/
+static void
+build_distance(
+        CubeOptimal_t *optimal,
+        uint8_t *table,
+        uint32_t count,
+        DistanceStep_t step,
+        DistanceFill_t fill
+)
+{
+        uint32_t index;
+        uint32_t next;
+        uint32_t filled;
+        uint32_t total;
+        uint8_t depth;
+        uint8_t move;
+
+        memset(table,0xFF,(count+1)/2);
+        set_distance(table,0,0);
+        total=fill?1+fill(optimal,table,0,0):1;
+        for(depth=0;depth<PRUNE_EMPTY-1;depth++){
+                filled=0;
+                if(total<count/2){
+                        for(index=0;index<count;index++){
+                                if(get_distance(table,index)!=depth){
+                                        continue;
+                                }
+                                for(move=0;move<MOVE_COUNT;move++){
+                                        next=step(optimal,index,move);
+                                        if(get_distance(table,next)!=PRUNE_EMPTY){
+                                                continue;
+                                        }
+                                        set_distance(table,next,depth+1);
+                                        filled++;
+                                        if(fill){
+                                                filled+=fill(optimal,table,next,depth+1);
+                                        }
+                                }
+                        }
+                }
+                else{
+                        for(index=0;index<count;index++){
+                                if(get_distance(table,index)!=PRUNE_EMPTY){
+                                        continue;
+                                }
+                                for(move=0;move<MOVE_COUNT;move++){
+                                        next=step(optimal,index,move);
+                                        if(get_distance(table,next)==depth){
+                                                set_distance(table,index,depth+1);
+                                                filled++;
+                                                break;
+                                        }
+                                }
+                        }
+                }
+                if(!filled){
+                        break;
+                }
+                total+=filled;
+        }
+}
+
+#if CUBE_SIZE==2
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the permutation of the corners other than the fixed one.
+**
+**  @param[in] cubie A cubie level cube.
+**
+**  @return The permutation coordinate (0-5039).
+*/
+static uint16_t
+get_corners(
+        CubeCubie_t *cubie
+)
+{
+        uint8_t p[CUBE_CORNER_COUNT-1];
+        uint8_t c;
+        uint8_t i;
+
+        for(i=0;i<CUBE_CORNER_COUNT-1;i++){
+                c=cubie->cp[i<CUBE_CORNER_DBL?i:i+1];
+                p[i]=c<CUBE_CORNER_DBL?c:c-1;
+        }
+        return cube_cubie_get_permutation(p,CUBE_CORNER_COUNT-1);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets the permutation of the corners other than the fixed one.
+**
+**  @param[out] cubie A cubie level cube.
+**  @param[in] perm The permutation coordinate.
+*/
+static void
+set_corners(
+        CubeCubie_t *cubie,
+        uint16_t perm
+)
+{
+        uint8_t p[CUBE_CORNER_COUNT-1];
+        uint8_t i;
+
+        cube_cubie_set_permutation(p,CUBE_CORNER_COUNT-1,perm);
+        for(i=0;i<CUBE_CORNER_COUNT-1;i++){
+                cubie->cp[i<CUBE_CORNER_DBL?i:i+1]=p[i]<CUBE_CORNER_DBL?p[i]:p[i]+1;
+        }
+        cubie->cp[CUBE_CORNER_DBL]=CUBE_CORNER_DBL;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the orientation of the corners other than the fixed one.
+**
+**  The orientations of the top side and the front, right corners are a base
+**  3 number. The last one follows from the others.
+**
+**  @param[in] cubie A cubie level cube.
+**
+**  @return The orientation coordinate (0-728).
+*/
+static uint16_t
+get_twist(
+        CubeCubie_t *cubie
+)
+{
+        uint16_t r;
+        uint8_t i;
+
+        r=0;
+        for(i=0;i<CUBE_CORNER_DBL;i++){
+                r=(uint16_t)(r*3+cubie->co[i]);
+        }
+        return r;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets the orientation of the corners other than the fixed one.
+**
+**  @param[out] cubie A cubie level cube.
+**  @param[in] twist The orientation coordinate.
+*/
+static void
+set_twist(
+        CubeCubie_t *cubie,
+        uint16_t twist
+)
+{
+        uint8_t sum;
+        uint8_t i;
+
+        sum=0;
+        for(i=CUBE_CORNER_DBL;i--;){
+                cubie->co[i]=(uint8_t)(twist%3);
+                sum+=cubie->co[i];
+                twist/=3;
+        }
+        cubie->co[CUBE_CORNER_DBL]=0;
+        cubie->co[CUBE_CORNER_DRB]=(uint8_t)((3-sum%3)%3);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if the corners form a valid 2x2x2 cube.
+**
+**  @param[in] cubie A cubie level cube.
+**
+**  @retval true The corners are valid and the fixed corner is in place.
+**  @retval false The corners are not valid.
+*/
+static bool
+corners_valid(
+        CubeCubie_t *cubie
+)
+{
+        uint8_t seen;
+        uint8_t twist;
+        uint8_t i;
+
+        seen=0;
+        twist=0;
+        for(i=0;i<CUBE_CORNER_COUNT;i++){
+                if(cubie->cp[i]>=CUBE_CORNER_COUNT||cubie->co[i]>2){
+                        return false;
+                }
+                seen|=1<<cubie->cp[i];
+                twist+=cubie->co[i];
+        }
+        return seen==0xFF&&!(twist%3)&&
+               cubie->cp[CUBE_CORNER_DBL]==CUBE_CORNER_DBL&&
+               !cubie->co[CUBE_CORNER_DBL];
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates the move tables.
+**
+**  @param[in] optimal A solver with the table memory allocated.
+*/
+static void
+build_moves(
+        CubeOptimal_t *optimal
+)
+{
+        CubeCubie_t c;
+        CubeCubie_t d;
+        uint32_t i;
+        uint8_t t;
+
+        cube_cubie_reset(&c);
+        for(i=0;i<TWIST_COUNT;i++){
+                set_twist(&c,(uint16_t)i);
+                for(t=0;t<MOVE_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        optimal->twistMove[i*MOVE_COUNT+t]=get_twist(&d);
+                }
+        }
+        cube_cubie_reset(&c);
+        for(i=0;i<PERM_COUNT;i++){
+                set_corners(&c,(uint16_t)i);
+                for(t=0;t<MOVE_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        optimal->cornerMove[i*MOVE_COUNT+t]=get_corners(&d);
+                }
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates the distance tables.
+**
+**  @param[in] optimal A solver with the move tables ready.
+*/
+static void
+build_distances(
+        CubeOptimal_t *optimal
+)
+{
+        build_distance(optimal,optimal->distance,POSITION_COUNT,step_corners,NULL);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Lays out the tables in the table block.
+**
+**  @param[in] optimal A solver with the table block allocated.
+*/
+static void
+layout_tables(
+        CubeOptimal_t *optimal
+)
+{
+        uint8_t *p;
+
+        p=optimal->table.data;
+        optimal->distance=p;
+        p+=DISTANCE_BYTES;
+        optimal->cornerMove=(uint16_t *)p;
+        p+=PERM_MOVE_BYTES;
+        optimal->twistMove=(uint16_t *)p;
+}
+
+#else
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Conjugates a cube with a symmetry.
+**
+**  @param[in] cubie A cubie level cube.
+**  @param[in] sym The symmetry.
+**  @param[in] inverse The inverse of the symmetry.
+**  @param[out] result The cube looked at through the symmetry.
+*/
+static void
+conjugate(
+        CubeCubie_t *cubie,
+        CubeCubie_t *sym,
+        CubeCubie_t *inverse,
+        CubeCubie_t *result
+)
+{
+        CubeCubie_t c;
+
+        cube_cubie_multiply(sym,cubie,&c);
+        cube_cubie_multiply(&c,inverse,result);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the edge orientation and middle layer edge position
+**  coordinate.
+**
+**  @param[in] cubie A cubie level cube.
+**
+**  @return The coordinate (0 - FLIPSLICE_COUNT-1).
+*/
+static uint32_t
+get_flipslice(
+        CubeCubie_t *cubie
+)
+{
+        return (uint32_t)(cube_cubie_get_slice(cubie)/SLICE_ORDER_COUNT)*FLIP_COUNT+
+                cube_cubie_get_flip(cubie);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the phase 1 coordinates of a cube.
+**
+**  @param[in] cubie A cubie level cube.
+**  @param[out] axis The coordinates.
+*/
+static void
+get_axis(
+        CubeCubie_t *cubie,
+        CubeOptimalAxis_t *axis
+)
+{
+        axis->twist=cube_cubie_get_twist(cubie);
+        axis->flip=cube_cubie_get_flip(cubie);
+        axis->slice=cube_cubie_get_slice(cubie)/SLICE_ORDER_COUNT;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the phase 1 distance table index of the coordinates.
+**
+**  The edge coordinates are replaced with their class, and the corner
+**  orientation is looked at through the symmetry that turns the edges to
+**  the class representative.
+**
+**  @param[in] optimal The solver.
+**  @param[in] twist Corner orientation.
+**  @param[in] flip Edge orientation.
+**  @param[in] slice Middle layer edge positions.
+**
+**  @return The index.
+*/
+static inline uint32_t
+get_phase1(
+        CubeOptimal_t *optimal,
+        uint16_t twist,
+        uint16_t flip,
+        uint16_t slice
+)
+{
+        uint32_t c;
+
+        c=optimal->flipsliceClass[(uint32_t)slice*FLIP_COUNT+flip];
+        return c/SYM_COUNT*TWIST_COUNT+optimal->twistConj[twist*SYM_COUNT+c%SYM_COUNT];
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Pruning step for the phase 1 coordinates.
+*/
+static uint32_t
+step_phase1(
+        CubeOptimal_t *optimal,
+        uint32_t index,
+        uint8_t move
+)
+{
+        uint32_t rep;
+        uint16_t twist;
+        uint16_t flip;
+        uint16_t slice;
+
+        rep=optimal->flipsliceRep[index/TWIST_COUNT];
+        twist=optimal->twistMove[index%TWIST_COUNT*MOVE_COUNT+move];
+        flip=optimal->flipMove[rep%FLIP_COUNT*MOVE_COUNT+move];
+        slice=optimal->sliceMove[rep/FLIP_COUNT*MOVE_COUNT+move];
+        return get_phase1(optimal,twist,flip,slice);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Fills the phase 1 entries of the symmetric states.
+**
+**  When the class representative is symmetric, a state and the state looked
+**  at through the symmetry have different entries.
+*/
+static uint32_t
+fill_phase1(
+        CubeOptimal_t *optimal,
+        uint8_t *table,
+        uint32_t index,
+        uint8_t value
+)
+{
+        uint32_t base;
+        uint32_t next;
+        uint32_t filled;
+        uint16_t stab;
+        uint16_t twist;
+        uint8_t s;
+
+        stab=optimal->flipsliceStab[index/TWIST_COUNT];
+        twist=(uint16_t)(index%TWIST_COUNT);
+        base=index-twist;
+        filled=0;
+        for(s=1;s<SYM_COUNT;s++){
+                if(!(stab&(1<<s))){
+                        continue;
+                }
+                next=base+optimal->twistConj[twist*SYM_COUNT+s];
+                if(get_distance(table,next)==PRUNE_EMPTY){
+                        set_distance(table,next,value);
+                        filled++;
+                }
+        }
+        return filled;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates the symmetry tables.
+**
+**  @param[in] optimal A solver with the table memory allocated.
+*/
+static void
+build_symmetries(
+        CubeOptimal_t *optimal
+)
+{
+        CubeCubie_t sym[SYM_COUNT];
+        CubeCubie_t inv[SYM_COUNT];
+        CubeCubie_t lr2;
+        CubeCubie_t u4;
+        CubeCubie_t f2;
+        CubeCubie_t c;
+        CubeCubie_t d;
+        uint32_t fs;
+        uint32_t f;
+        uint32_t n;
+        uint16_t stab;
+        uint16_t i;
+        uint8_t s;
+
+        // The symmetries are products of the reflection, rotations around
+        // the vertical axis and the upside down rotation.
+        lr2=symLr2;
+        u4=symU4;
+        f2=symF2;
+        cube_cubie_reset(&c);
+        for(s=0;s<SYM_COUNT;s++){
+                sym[s]=c;
+                cube_cubie_inverse(&sym[s],&inv[s]);
+                cube_cubie_multiply(&sym[s],&lr2,&c);
+                if(s%2){
+                        d=c;
+                        cube_cubie_multiply(&d,&u4,&c);
+                }
+                if(s%8==7){
+                        d=c;
+                        cube_cubie_multiply(&d,&f2,&c);
+                }
+        }
+
+        cube_cubie_reset(&c);
+        for(i=0;i<TWIST_COUNT;i++){
+                cube_cubie_set_twist(&c,i);
+                for(s=0;s<SYM_COUNT;s++){
+                        conjugate(&c,&sym[s],&inv[s],&d);
+                        optimal->twistConj[i*SYM_COUNT+s]=cube_cubie_get_twist(&d);
+                }
+        }
+
+        // A class has the edge states that are the same when looked at
+        // through a symmetry. Its first state is the representative, and
+        // each state is stored with the symmetry that turns it to the
+        // representative.
+        memset(optimal->flipsliceClass,0xFF,CLASS_BYTES);
+        n=0;
+        for(fs=0;fs<FLIPSLICE_COUNT;fs++){
+                if(optimal->flipsliceClass[fs]!=NO_CLASS){
+                        continue;
+                }
+                cube_cubie_reset(&c);
+                cube_cubie_set_slice(&c,(uint16_t)(fs/FLIP_COUNT*SLICE_ORDER_COUNT));
+                cube_cubie_set_flip(&c,(uint16_t)(fs%FLIP_COUNT));
+                stab=0;
+                for(s=0;s<SYM_COUNT;s++){
+                        conjugate(&c,&inv[s],&sym[s],&d);
+                        f=get_flipslice(&d);
+                        if(f==fs){
+                                stab|=1<<s;
+                        }
+                        if(optimal->flipsliceClass[f]==NO_CLASS){
+                                optimal->flipsliceClass[f]=n*SYM_COUNT+s;
+                        }
+                }
+                optimal->flipsliceRep[n]=fs;
+                optimal->flipsliceStab[n]=stab;
+                n++;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets up the symmetries of the axes.
+**
+**  These are not in the table block, so they are set up also when the tables
+**  are mapped from a file.
+**
+**  @param[in] optimal A solver.
+*/
+static void
+build_axes(
+        CubeOptimal_t *optimal
+)
+{
+        CubeCubie_t urf3;
+        CubeCubie_t c;
+        CubeCubie_t d;
+        CubeCubie_t m;
+        uint8_t i;
+        uint8_t s;
+        uint8_t t;
+
+        // The cube is also looked at from the other two axes through the
+        // diagonal rotation, where a turn is seen as a turn of another side.
+        urf3=symUrf3;
+        cube_cubie_reset(&optimal->axisSym[0]);
+        optimal->axisSym[1]=urf3;
+        cube_cubie_multiply(&urf3,&urf3,&optimal->axisSym[2]);
+        for(s=0;s<CUBE_OPTIMAL_AXIS_COUNT;s++){
+                cube_cubie_inverse(&optimal->axisSym[s],&optimal->axisInv[s]);
+                for(t=0;t<MOVE_COUNT;t++){
+                        cube_cubie_reset(&m);
+                        cube_cubie_turn(&m,(CubeTurn_t)t);
+                        conjugate(&m,&optimal->axisInv[s],&optimal->axisSym[s],&d);
+                        for(i=0;i<MOVE_COUNT;i++){
+                                cube_cubie_reset(&c);
+                                cube_cubie_turn(&c,(CubeTurn_t)i);
+                                if(!memcmp(&c,&d,sizeof(c))){
+                                        break;
+                                }
+                        }
+                        optimal->axisMove[s][t]=(uint8_t)i;
+                }
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates the move tables.
+**
+**  @param[in] optimal A solver with the table memory allocated.
+*/
+static void
+build_moves(
+        CubeOptimal_t *optimal
+)
+{
+        CubeCubie_t c;
+        CubeCubie_t d;
+        uint32_t i;
+        uint8_t t;
+
+        cube_cubie_reset(&c);
+        for(i=0;i<TWIST_COUNT;i++){
+                cube_cubie_set_twist(&c,(uint16_t)i);
+                for(t=0;t<MOVE_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        optimal->twistMove[i*MOVE_COUNT+t]=cube_cubie_get_twist(&d);
+                }
+        }
+        cube_cubie_reset(&c);
+        for(i=0;i<FLIP_COUNT;i++){
+                cube_cubie_set_flip(&c,(uint16_t)i);
+                for(t=0;t<MOVE_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        optimal->flipMove[i*MOVE_COUNT+t]=cube_cubie_get_flip(&d);
+                }
+        }
+        cube_cubie_reset(&c);
+        for(i=0;i<SLICE_COUNT;i++){
+                cube_cubie_set_slice(&c,(uint16_t)(i*SLICE_ORDER_COUNT));
+                for(t=0;t<MOVE_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        optimal->sliceMove[i*MOVE_COUNT+t]=cube_cubie_get_slice(&d)/SLICE_ORDER_COUNT;
+                }
+        }
+        cube_cubie_reset(&c);
+        for(i=0;i<PERM_COUNT;i++){
+                cube_cubie_set_permutation(c.cp,CUBE_CORNER_COUNT,(uint16_t)i);
+                for(t=0;t<MOVE_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        optimal->cornerMove[i*MOVE_COUNT+t]=cube_cubie_get_permutation(d.cp,CUBE_CORNER_COUNT);
+                }
+        }
+        build_symmetries(optimal);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates the distance tables.
+**
+**  @param[in] optimal A solver with the move tables ready.
+*/
+static void
+build_distances(
+        CubeOptimal_t *optimal
+)
+{
+        build_distance(optimal,optimal->cornerPrune,CORNER_COUNT,step_corners,NULL);
+        build_distance(optimal,optimal->phase1Prune,PHASE1_COUNT,step_phase1,fill_phase1);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Lays out the tables in the table block.
+**
+**  @param[in] optimal A solver with the table block allocated.
+*/
+static void
+layout_tables(
+        CubeOptimal_t *optimal
+)
+{
+        uint8_t *p;
+
+        p=optimal->table.data;
+        optimal->cornerPrune=p;
+        p+=CORNER_PRUNE_BYTES;
+        optimal->phase1Prune=p;
+        p+=PHASE1_PRUNE_BYTES;
+        optimal->flipsliceClass=(uint32_t *)p;
+        p+=CLASS_BYTES;
+        optimal->flipsliceRep=(uint32_t *)p;
+        p+=REP_BYTES;
+        optimal->twistConj=(uint16_t *)p;
+        p+=TWIST_CONJ_BYTES;
+        optimal->cornerMove=(uint16_t *)p;
+        p+=PERM_MOVE_BYTES;
+        optimal->twistMove=(uint16_t *)p;
+        p+=TWIST_MOVE_BYTES;
+        optimal->flipMove=(uint16_t *)p;
+        p+=FLIP_MOVE_BYTES;
+        optimal->sliceMove=(uint16_t *)p;
+        p+=SLICE_MOVE_BYTES;
+        optimal->flipsliceStab=(uint16_t *)p;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if a turn may follow another turn.
+**
+**  A face is not turned twice in a row, and of the opposite faces only the
+**  order U D, R L and F B is used.
+**
+**  @param[in] prev The previous turn.
+**  @param[in] turn The next turn.
+**
+**  @retval true The turn may follow.
+**  @retval false The turn is redundant.
+*/
+static inline bool
+allowed(
+        uint8_t prev,
+        uint8_t turn
+)
+{
+        uint8_t a;
+        uint8_t b;
+
+        a=prev/3;
+        b=turn/3;
+        return a!=b&&!(a%3==b%3&&b<a);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the lower bound of the distance by the phase 1 coordinates.
+**
+**  The last move of a solution is in the phase 1 subgroup of its own axis, so
+**  one move before the end the distance on that axis is 0. If the distances
+**  on all axes are equal and not 0, none of them can reach 0 one move before
+**  the end, and the bound is one more.
+**
+**  @param[in] optimal The solver.
+**  @param[in] phase1 Phase 1 distance table index on each axis.
+**
+**  @return The lower bound.
+*/
+static inline uint8_t
+phase1_bound(
+        CubeOptimal_t *optimal,
+        uint32_t *phase1
+)
+{
+        uint8_t d[CUBE_OPTIMAL_AXIS_COUNT];
+        uint8_t bound;
+        uint8_t a;
+
+        bound=0;
+        for(a=0;a<CUBE_OPTIMAL_AXIS_COUNT;a++){
+                d[a]=get_distance(optimal->phase1Prune,phase1[a]);
+                if(d[a]>bound){
+                        bound=d[a];
+                }
+        }
+        if(bound&&d[0]==d[1]&&d[1]==d[2]){
+                bound++;
+        }
+        return bound;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the children of a search node that are within a depth.
+**
+**  The lower bound of the distance is the largest of the corner distance and
+**  the phase 1 distances from the three axes. The tables are read in stages
+**  for all moves at once, and the entries of the next stage are prefetched,
+**  so that the reads from the large tables overlap.
+**
+**  @param[in] optimal The solver.
+**  @param[in] corners Corner pattern database index.
+**  @param[in] axis Phase 1 coordinates from each axis.
+**  @param[in] prev The previous move, or MOVE_COUNT at the root.
+**  @param[in] togo Moves to go.
+**  @param[out] children The children with a lower bound below togo.
+*/
+static void
+expand(
+        CubeOptimal_t *optimal,
+        uint32_t corners,
+        CubeOptimalAxis_t *axis,
+        uint8_t prev,
+        uint8_t togo,
+        Children_t *children
+)
+{
+        uint32_t phase1[MOVE_COUNT][CUBE_OPTIMAL_AXIS_COUNT];
+        CubeOptimalAxis_t *next;
+        uint8_t count;
+        uint8_t a;
+        uint8_t i;
+        uint8_t m;
+        uint8_t t;
+
+        count=0;
+        for(t=0;t<MOVE_COUNT;t++){
+                if(prev<MOVE_COUNT&&!allowed(prev,t)){
+                        continue;
+                }
+                next=children->axis[count];
+                for(a=0;a<CUBE_OPTIMAL_AXIS_COUNT;a++){
+                        m=optimal->axisMove[a][t];
+                        next[a].twist=optimal->twistMove[axis[a].twist*MOVE_COUNT+m];
+                        next[a].flip=optimal->flipMove[axis[a].flip*MOVE_COUNT+m];
+                        next[a].slice=optimal->sliceMove[axis[a].slice*MOVE_COUNT+m];
+                        PREFETCH(&optimal->flipsliceClass[
+                                (uint32_t)next[a].slice*FLIP_COUNT+next[a].flip]);
+                }
+                children->corners[count]=(uint32_t)optimal->cornerMove[
+                        corners/TWIST_COUNT*MOVE_COUNT+t]*TWIST_COUNT+next[0].twist;
+                PREFETCH(&optimal->cornerPrune[children->corners[count]>>1]);
+                children->move[count++]=t;
+        }
+        for(i=0;i<count;i++){
+                next=children->axis[i];
+                for(a=0;a<CUBE_OPTIMAL_AXIS_COUNT;a++){
+                        phase1[i][a]=get_phase1(optimal,next[a].twist,next[a].flip,next[a].slice);
+                        PREFETCH(&optimal->phase1Prune[phase1[i][a]>>1]);
+                }
+        }
+        children->count=0;
+        for(i=0;i<count;i++){
+                if(get_distance(optimal->cornerPrune,children->corners[i])>=togo||
+                   phase1_bound(optimal,phase1[i])>=togo){
+                        continue;
+                }
+                if(children->count<i){
+                        children->move[children->count]=children->move[i];
+                        children->corners[children->count]=children->corners[i];
+                        memcpy(children->axis[children->count],children->axis[i],
+                                sizeof(children->axis[i]));
+                }
+                children->count++;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Searches with a fixed depth.
+**
+**  @param[in] s A search.
+**  @param[in] corners Corner pattern database index.
+**  @param[in] axis Phase 1 coordinates from each axis.
+**  @param[in] n Moves so far.
+**  @param[in] togo Moves to go.
+**
+**  @retval true A solution was found.
+**  @retval false No solution of the depth, or another thread found one.
+*/
+static bool
+search(
+        Search_t *s,
+        uint32_t corners,
+        CubeOptimalAxis_t *axis,
+        uint8_t n,
+        uint8_t togo
+)
+{
+        Children_t children;
+        CubeCubie_t cubie;
+        uint8_t i;
+
+        // At the end the corners are solved and the edges are oriented and
+        // in their layers on all axes, but the edges of a layer may still be
+        // in the wrong order, so the path is checked on the cube.
+        if(!togo){
+                cubie=s->cubie;
+                for(i=0;i<n;i++){
+                        cube_cubie_turn(&cubie,(CubeTurn_t)s->moves[i]);
+                }
+                return cube_cubie_is_solved(&cubie);
+        }
+        if(cube_atomic_load(s->best)<=(uint32_t)n+togo){
+                return false;
+        }
+        expand(s->optimal,corners,axis,n?s->moves[n-1]:MOVE_COUNT,togo,&children);
+        for(i=0;i<children.count;i++){
+                s->moves[n]=children.move[i];
+                if(search(s,children.corners[i],children.axis[i],n+1,togo-1)){
+                        return true;
+                }
+        }
+        return false;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Splits a search to tasks.
+**
+**  @param[in] p A parallel search.
+**  @param[in] s The search of the calling thread.
+**  @param[in] corners Corner pattern database index.
+**  @param[in] axis Phase 1 coordinates from each axis.
+**  @param[in] n Moves so far.
+*/
+static void
+split(
+        Parallel_t *p,
+        Search_t *s,
+        uint32_t corners,
+        CubeOptimalAxis_t *axis,
+        uint8_t n
+)
+{
+        Children_t children;
+        Task_t *task;
+        uint8_t i;
+
+        if(n==TASK_LENGTH){
+                task=&p->tasks[p->taskCount++];
+                task->corners=corners;
+                memcpy(task->axis,axis,sizeof(task->axis));
+                memcpy(task->moves,s->moves,TASK_LENGTH);
+                return;
+        }
+        expand(s->optimal,corners,axis,n?s->moves[n-1]:MOVE_COUNT,p->depth-n,&children);
+        for(i=0;i<children.count;i++){
+                s->moves[n]=children.move[i];
+                split(p,s,children.corners[i],children.axis[i],n+1);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Takes a task for a thread.
+**
+**  The thread takes the first task of its own queue. When the queue is
+**  empty, it steals the last task of the queue of another thread.
+**
+**  @param[in] p A parallel search.
+**  @param[in] worker The thread.
+**  @param[out] task Index of the task.
+**
+**  @retval true A task was taken.
+**  @retval false All tasks are taken.
+*/
+static bool
+take_task(
+        Parallel_t *p,
+        Worker_t *worker,
+        uint32_t *task
+)
+{
+        volatile uint32_t *queue;
+        uint32_t first;
+        uint32_t end;
+        uint32_t q;
+        uint32_t i;
+
+        for(i=0;i<p->workerCount;i++){
+                queue=&p->workers[(worker->index+i)%p->workerCount].queue;
+                for(;;){
+                        q=cube_atomic_load(queue);
+                        first=q>>16;
+                        end=q&0xFFFF;
+                        if(first>=end){
+                                break;
+                        }
+                        if(!i){
+                                if(cube_atomic_compare_swap(queue,q,q+0x10000)){
+                                        *task=first;
+                                        return true;
+                                }
+                        }
+                        else if(cube_atomic_compare_swap(queue,q,q-1)){
+                                *task=end-1;
+                                return true;
+                        }
+                }
+        }
+        return false;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Runs the tasks of a parallel search until they are all done or a
+**         solution is found.
+**
+**  @param[in] argument A pointer to a worker.
+*/
+static void
+run_tasks(
+        void *argument
+)
+{
+        Parallel_t *p;
+        Worker_t *worker;
+        Search_t state;
+        Task_t *task;
+        uint32_t best;
+        uint32_t t;
+
+        worker=(Worker_t *)argument;
+        p=worker->parallel;
+        // The path is written at every node, so it is kept on the stack of
+        // the thread, away from the cache lines of the other threads.
+        state=worker->search;
+        while(cube_atomic_load(&p->best)==NO_SOLUTION&&take_task(p,worker,&t)){
+                task=&p->tasks[t];
+                memcpy(state.moves,task->moves,TASK_LENGTH);
+                if(!search(&state,task->corners,task->axis,TASK_LENGTH,
+                        p->depth-TASK_LENGTH)){
+                        continue;
+                }
+                // The thread that lowers the bound owns the solution.
+                best=cube_atomic_load(&p->best);
+                while(best>p->depth){
+                        if(cube_atomic_compare_swap(&p->best,best,p->depth)){
+                                memcpy(p->moves,state.moves,p->depth);
+                                break;
+                        }
+                        best=cube_atomic_load(&p->best);
+                }
+                break;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Searches with a fixed depth in several threads.
+**
+**  The search is split to the subtrees of the first moves, which are shared
+**  evenly between the threads. A thread that runs out of subtrees steals
+**  them from the others. The tables are only read, and the only shared
+**  variables are the task queues and the bound of the solution length.
+**
+**  @param[in] s The search of the calling thread.
+**  @param[in] corners Corner pattern database index.
+**  @param[in] axis Phase 1 coordinates from each axis.
+**  @param[in] depth Search depth.
+**
+**  @retval true A solution was found.
+**  @retval false No solution of the depth.
+*/
+static bool
+search_parallel(
+        Search_t *s,
+        uint32_t corners,
+        CubeOptimalAxis_t *axis,
+        uint8_t depth
+)
+{
+        Parallel_t p;
+        Worker_t *worker;
+        uint32_t started;
+        uint32_t i;
+
+        p.depth=depth;
+        p.best=NO_SOLUTION;
+        p.taskCount=0;
+        p.workerCount=s->optimal->threadCount;
+        p.tasks=(Task_t *)malloc(TASK_MAX_COUNT*sizeof(Task_t));
+        p.workers=(Worker_t *)malloc(p.workerCount*sizeof(Worker_t));
+        if(!p.tasks||!p.workers){
+                free(p.tasks);
+                free(p.workers);
+                return search(s,corners,axis,0,depth);
+        }
+        split(&p,s,corners,axis,0);
+        for(i=0;i<p.workerCount;i++){
+                worker=&p.workers[i];
+                worker->search=*s;
+                worker->search.best=&p.best;
+                worker->queue=(p.taskCount*i/p.workerCount)<<16|
+                        p.taskCount*(i+1)/p.workerCount;
+                worker->index=i;
+                worker->parallel=&p;
+        }
+        // If a thread cannot be created, its tasks are stolen by the others.
+        for(started=1;started<p.workerCount;started++){
+                worker=&p.workers[started];
+                if(!cube_thread_start(&worker->thread,run_tasks,worker)){
+                        break;
+                }
+        }
+        run_tasks(&p.workers[0]);
+        for(i=1;i<started;i++){
+                cube_thread_join(&p.workers[i].thread);
+        }
+        if(p.best!=NO_SOLUTION){
+                memcpy(s->moves,p.moves,depth);
+        }
+        free(p.tasks);
+        free(p.workers);
+        return p.best!=NO_SOLUTION;
+}
+
+#endif // if CUBE_SIZE==2
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_optimal_init(
+        CubeOptimal_t *optimal,
+        char *path
+)
+{
+        CubeTable_t mapped;
+
+        optimal->threadCount=1;
+#if CUBE_SIZE==3
+        build_axes(optimal);
+#endif
+        if(path&&cube_table_map(&optimal->table,path,TABLE_ID,TABLE_VERSION,TABLE_BYTES)){
+                layout_tables(optimal);
+                return true;
+        }
+        if(!cube_table_alloc(&optimal->table,TABLE_BYTES)){
+                return false;
+        }
+        layout_tables(optimal);
+        build_moves(optimal);
+        build_distances(optimal);
+        // The saved file is mapped instead of the generated tables, so that
+        // the pages are shared with the other processes. A failure is
+        // ignored, as the tables are then generated again on the next run.
+        if(path&&cube_table_save(&optimal->table,path,TABLE_ID,TABLE_VERSION)&&
+           cube_table_map(&mapped,path,TABLE_ID,TABLE_VERSION,TABLE_BYTES)){
+                cube_table_free(&optimal->table);
+                optimal->table=mapped;
+                layout_tables(optimal);
+        }
+        return true;
+}
+
+void
+cube_optimal_free(
+        CubeOptimal_t *optimal
+)
+{
+        cube_table_free(&optimal->table);
+}
+
+bool
+cube_optimal_solve(
+        CubeOptimal_t *optimal,
+        CubeCubie_t *cubie,
+        uint8_t maxLength,
+        CubeTurn_t *solution,
+        uint8_t *length
+)
+{
+#if CUBE_SIZE==2
+        uint32_t index;
+        uint32_t next;
+        uint8_t depth;
+        uint8_t t;
+
+        *length=0;
+        if(!corners_valid(cubie)){
+                return false;
+        }
+        index=(uint32_t)get_corners(cubie)*TWIST_COUNT+get_twist(cubie);
+        depth=get_distance(optimal->distance,index);
+        if(depth>maxLength){
+                return false;
+        }
+        // Each position has a move to a position one move closer.
+        next=index;
+        while(depth){
+                for(t=0;t<MOVE_COUNT;t++){
+                        next=step_corners(optimal,index,t);
+                        if(get_distance(optimal->distance,next)<depth){
+                                break;
+                        }
+                }
+                solution[(*length)++]=(CubeTurn_t)t;
+                index=next;
+                depth--;
+        }
+        return true;
+#else
+        CubeOptimalAxis_t axis[CUBE_OPTIMAL_AXIS_COUNT];
+        uint32_t phase1[CUBE_OPTIMAL_AXIS_COUNT];
+        volatile uint32_t best;
+        CubeCubie_t c;
+        Search_t s;
+        uint32_t corners;
+        uint8_t depth;
+        uint8_t d;
+        uint8_t i;
+
+        *length=0;
+        if(!cube_cubie_is_valid(cubie)){
+                return false;
+        }
+        if(maxLength>CUBE_OPTIMAL_MAX_LENGTH){
+                maxLength=CUBE_OPTIMAL_MAX_LENGTH;
+        }
+        best=NO_SOLUTION;
+        s.optimal=optimal;
+        s.cubie=*cubie;
+        s.best=&best;
+        corners=(uint32_t)cube_cubie_get_permutation(cubie->cp,CUBE_CORNER_COUNT)*TWIST_COUNT+
+                cube_cubie_get_twist(cubie);
+        for(i=0;i<CUBE_OPTIMAL_AXIS_COUNT;i++){
+                conjugate(cubie,&optimal->axisInv[i],&optimal->axisSym[i],&c);
+                get_axis(&c,&axis[i]);
+                phase1[i]=get_phase1(optimal,axis[i].twist,axis[i].flip,axis[i].slice);
+        }
+        depth=get_distance(optimal->cornerPrune,corners);
+        d=phase1_bound(optimal,phase1);
+        if(d>depth){
+                depth=d;
+        }
+        for(;depth<=maxLength;depth++){
+                if(optimal->threadCount>1&&depth>=PARALLEL_MIN_DEPTH?
+                   search_parallel(&s,corners,axis,depth):
+                   search(&s,corners,axis,0,depth)){
+                        for(i=0;i<depth;i++){
+                                solution[i]=(CubeTurn_t)s.moves[i];
+                        }
+                        *length=depth;
+                        return true;
+                }
+        }
+        return false;
+#endif
+}
+
+bool
+cube_optimal_solve_cube(
+        CubeOptimal_t *optimal,
+        Cube_t *cube,
+        uint8_t maxLength,
+        CubeTurn_t *solution,
+        uint8_t *length
+)
+{
+        CubeCubie_t cubie;
+        Cube_t check;
+
+        *length=0;
+#if CUBE_SIZE==2
+        if(!cube_cubie_from_cube_corners(&cubie,cube)){
+                return false;
+        }
+#else
+        if(!cube_cubie_from_cube(&cubie,cube)){
+                return false;
+        }
+#endif
+        if(!cube_optimal_solve(optimal,&cubie,maxLength,solution,length)){
+                return false;
+        }
+        check=*cube;
+        cube_apply_turns(&check,solution,*length);
+        return cube_is_solved(&check);
+}
+
+#endif // if CUBE_SIZE==2||CUBE_SIZE==3
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,427 @@
+﻿/***************************************************************************//**
+**
+**  @file       rubics_cube_packed.c
+**  @ingroup    rubicscube
+**  @brief      Packed Rubic's cube representation.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_packed.h"
+
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Face size in stickers.
+#define FACE_STICKERS (CUBE_SIZE*CUBE_SIZE)
+
+/// Access to a sticker of a packed cube.
+#define STICKER(p,side,x,y) ((p)->sticker[CUBE_PACKED_INDEX(side,x,y)])
+
+/// A pointer to the first sticker of a face.
+#define FACE(p,side) (&(p)->sticker[(side)*FACE_STICKERS])
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates a face in place.
+**
+**  The blocks are moved in four-cycles, so no temporary face is needed.
+**
+**  @param[in] p A packed cube.
+**  @param[in] side A face to rotate.
+**  @param[in] dir Rotation direction (clockwise or counter-clockwise).
+*/
+static void
+rotate_face(
+        CubePacked_t *p,
+        CubeSide_t side,
+        CubeDirection_t dir
+)
+{
+        uint8_t *f;
+        uint8_t a;
+        uint8_t b;
+        uint8_t c;
+        uint16_t p0;
+        uint16_t p1;
+        uint16_t p2;
+        uint16_t p3;
+
+        f=FACE(p,side);
+        for(a=0;a<CUBE_SIZE/2;a++){
+                for(b=a;b<CUBE_SIZE-1-a;b++){
+                        p0=b*CUBE_SIZE+a;
+                        p1=(CUBE_SIZE-1-a)*CUBE_SIZE+b;
+                        p2=(CUBE_SIZE-1-b)*CUBE_SIZE+(CUBE_SIZE-1-a);
+                        p3=a*CUBE_SIZE+(CUBE_SIZE-1-b);
+                        switch(dir){
+                        default:return;
+                        case CUBE_DIRECTION_CW:
+                                c=f[p3];
+                                f[p3]=f[p2];
+                                f[p2]=f[p1];
+                                f[p1]=f[p0];
+                                f[p0]=c;
+                                break;
+                        case CUBE_DIRECTION_CCW:
+                                c=f[p0];
+                                f[p0]=f[p1];
+                                f[p1]=f[p2];
+                                f[p2]=f[p3];
+                                f[p3]=c;
+                                break;
+                        }
+                }
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Rotates a face half a turn in place.
+**
+**  @param[in] p A packed cube.
+**  @param[in] side A face to rotate.
+*/
+static void
+rotate_face_half(
+        CubePacked_t *p,
+        CubeSide_t side
+)
+{
+        uint8_t *f;
+        uint16_t i;
+        uint8_t c;
+
+        f=FACE(p,side);
+        for(i=0;i<FACE_STICKERS/2;i++){
+                c=f[i];
+                f[i]=f[FACE_STICKERS-1-i];
+                f[FACE_STICKERS-1-i]=c;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Copies a face to another face.
+**
+**  @param[in] p A packed cube.
+**  @param[in] src Source face.
+**  @param[in] dest Destination face.
+*/
+static inline void
+copy_face(
+        CubePacked_t *p,
+        CubeSide_t src,
+        CubeSide_t dest
+)
+{
+        memcpy(FACE(p,dest),FACE(p,src),FACE_STICKERS);
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+void
+cube_packed_from_cube(
+        CubePacked_t *packed,
+        Cube_t *cube
+)
+{
+        uint8_t i;
+        uint8_t j;
+        uint8_t k;
+
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                for(j=0;j<CUBE_SIZE;j++){
+                        for(k=0;k<CUBE_SIZE;k++){
+                                STICKER(packed,i,j,k)=(uint8_t)cube->face[i].blocks[j][k];
+                        }
+                }
+        }
+        memset(
+                &packed->sticker[CUBE_PACKED_STICKERS],
+                0,
+                CUBE_PACKED_BYTES-CUBE_PACKED_STICKERS
+        );
+}
+
+void
+cube_packed_to_cube(
+        CubePacked_t *packed,
+        Cube_t *cube
+)
+{
+        uint8_t i;
+        uint8_t j;
+        uint8_t k;
+
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                for(j=0;j<CUBE_SIZE;j++){
+                        for(k=0;k<CUBE_SIZE;k++){
+                                cube->face[i].blocks[j][k]=(CubeColor_t)STICKER(packed,i,j,k);
+                        }
+                }
+        }
+        cube_recount(cube);
+}
+
+void
+cube_packed_reset(
+        CubePacked_t *packed
+)
+{
+        uint8_t i;
+
+        memset(packed,0,sizeof(CubePacked_t));
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                memset(FACE(packed,i),cube_get_reset_color(i),FACE_STICKERS);
+        }
+}
+
+void
+cube_packed_rotate(
+        CubePacked_t *packed,
+        CubeDirection_t dir
+)
+{
+        uint8_t f[FACE_STICKERS];
+
+        switch(dir){
+        default:return;
+        case CUBE_DIRECTION_UP:
+                memcpy(f,FACE(packed,CUBE_SIDE_TOP),FACE_STICKERS);
+                copy_face(packed,CUBE_SIDE_FRONT,CUBE_SIDE_TOP);
+                copy_face(packed,CUBE_SIDE_BOTTOM,CUBE_SIDE_FRONT);
+                copy_face(packed,CUBE_SIDE_BACK,CUBE_SIDE_BOTTOM);
+                memcpy(FACE(packed,CUBE_SIDE_BACK),f,FACE_STICKERS);
+                rotate_face(packed,CUBE_SIDE_RIGHT,CUBE_DIRECTION_CW);
+                rotate_face(packed,CUBE_SIDE_LEFT,CUBE_DIRECTION_CCW);
+                break;
+        case CUBE_DIRECTION_DOWN:
+                memcpy(f,FACE(packed,CUBE_SIDE_BOTTOM),FACE_STICKERS);
+                copy_face(packed,CUBE_SIDE_FRONT,CUBE_SIDE_BOTTOM);
+                copy_face(packed,CUBE_SIDE_TOP,CUBE_SIDE_FRONT);
+                copy_face(packed,CUBE_SIDE_BACK,CUBE_SIDE_TOP);
+                memcpy(FACE(packed,CUBE_SIDE_BACK),f,FACE_STICKERS);
+                rotate_face(packed,CUBE_SIDE_RIGHT,CUBE_DIRECTION_CCW);
+                rotate_face(packed,CUBE_SIDE_LEFT,CUBE_DIRECTION_CW);
+                break;
+        case CUBE_DIRECTION_LEFT:
+                memcpy(f,FACE(packed,CUBE_SIDE_LEFT),FACE_STICKERS);
+                copy_face(packed,CUBE_SIDE_FRONT,CUBE_SIDE_LEFT);
+                copy_face(packed,CUBE_SIDE_RIGHT,CUBE_SIDE_FRONT);
+                rotate_face_half(packed,CUBE_SIDE_BACK);
+                copy_face(packed,CUBE_SIDE_BACK,CUBE_SIDE_RIGHT);
+                memcpy(FACE(packed,CUBE_SIDE_BACK),f,FACE_STICKERS);
+                rotate_face_half(packed,CUBE_SIDE_BACK);
+                rotate_face(packed,CUBE_SIDE_TOP,CUBE_DIRECTION_CW);
+                rotate_face(packed,CUBE_SIDE_BOTTOM,CUBE_DIRECTION_CCW);
+                break;
+        case CUBE_DIRECTION_RIGHT:
+                memcpy(f,FACE(packed,CUBE_SIDE_RIGHT),FACE_STICKERS);
+                copy_face(packed,CUBE_SIDE_FRONT,CUBE_SIDE_RIGHT);
+                copy_face(packed,CUBE_SIDE_LEFT,CUBE_SIDE_FRONT);
+                rotate_face_half(packed,CUBE_SIDE_BACK);
+                copy_face(packed,CUBE_SIDE_BACK,CUBE_SIDE_LEFT);
+                memcpy(FACE(packed,CUBE_SIDE_BACK),f,FACE_STICKERS);
+                rotate_face_half(packed,CUBE_SIDE_BACK);
+                rotate_face(packed,CUBE_SIDE_TOP,CUBE_DIRECTION_CCW);
+                rotate_face(packed,CUBE_SIDE_BOTTOM,CUBE_DIRECTION_CW);
+                break;
+        }
+}
+
+void
+cube_packed_rotate_row(
+        CubePacked_t *packed,
+        uint8_t row,
+        CubeDirection_t dir
+)
+{
+        uint8_t i;
+        uint8_t c;
+
+        switch(dir){
+        default:return;
+        case CUBE_DIRECTION_LEFT:
+                if(!row){
+                        rotate_face(packed,CUBE_SIDE_TOP,CUBE_DIRECTION_CW);
+                }
+                if(row==CUBE_SIZE-1){
+                        rotate_face(packed,CUBE_SIDE_BOTTOM,CUBE_DIRECTION_CCW);
+                }
+                for(i=0;i<CUBE_SIZE;i++){
+                        c=STICKER(packed,CUBE_SIDE_LEFT,i,row);
+                        STICKER(packed,CUBE_SIDE_LEFT,i,row)=STICKER(packed,CUBE_SIDE_FRONT,i,row);
+                        STICKER(packed,CUBE_SIDE_FRONT,i,row)=STICKER(packed,CUBE_SIDE_RIGHT,i,row);
+                        STICKER(packed,CUBE_SIDE_RIGHT,i,row)=STICKER(packed,CUBE_SIDE_BACK,CUBE_SIZE-1-i,CUBE_SIZE-1-row);
+                        STICKER(packed,CUBE_SIDE_BACK,CUBE_SIZE-1-i,CUBE_SIZE-1-row)=c;
+                }
+                break;
+        case CUBE_DIRECTION_RIGHT:
+                if(!row){
+                        rotate_face(packed,CUBE_SIDE_TOP,CUBE_DIRECTION_CCW);
+                }
+                if(row==CUBE_SIZE-1){
+                        rotate_face(packed,CUBE_SIDE_BOTTOM,CUBE_DIRECTION_CW);
+                }
+                for(i=0;i<CUBE_SIZE;i++){
+                        c=STICKER(packed,CUBE_SIDE_RIGHT,i,row);
+                        STICKER(packed,CUBE_SIDE_RIGHT,i,row)=STICKER(packed,CUBE_SIDE_FRONT,i,row);
+                        STICKER(packed,CUBE_SIDE_FRONT,i,row)=STICKER(packed,CUBE_SIDE_LEFT,i,row);
+                        STICKER(packed,CUBE_SIDE_LEFT,i,row)=STICKER(packed,CUBE_SIDE_BACK,CUBE_SIZE-1-i,CUBE_SIZE-1-row);
+                        STICKER(packed,CUBE_SIDE_BACK,CUBE_SIZE-1-i,CUBE_SIZE-1-row)=c;
+                }
+                break;
+        }
+}
+
+void
+cube_packed_rotate_column(
+        CubePacked_t *packed,
+        uint8_t col,
+        CubeDirection_t dir
+)
+{
+        uint8_t *top;
+        uint8_t *front;
+        uint8_t *bottom;
+        uint8_t *back;
+        uint8_t c[CUBE_SIZE];
+
+        // A column is contiguous in every face of the vertical ring, so it is
+        // moved as a whole.
+        top=&STICKER(packed,CUBE_SIDE_TOP,col,0);
+        front=&STICKER(packed,CUBE_SIDE_FRONT,col,0);
+        bottom=&STICKER(packed,CUBE_SIDE_BOTTOM,col,0);
+        back=&STICKER(packed,CUBE_SIDE_BACK,col,0);
+
+        switch(dir){
+        default:return;
+        case CUBE_DIRECTION_UP:
+                if(!col){
+                        rotate_face(packed,CUBE_SIDE_LEFT,CUBE_DIRECTION_CCW);
+                }
+                if(col==CUBE_SIZE-1){
+                        rotate_face(packed,CUBE_SIDE_RIGHT,CUBE_DIRECTION_CW);
+                }
+                memcpy(c,top,CUBE_SIZE);
+                memcpy(top,front,CUBE_SIZE);
+                memcpy(front,bottom,CUBE_SIZE);
+                memcpy(bottom,back,CUBE_SIZE);
+                memcpy(back,c,CUBE_SIZE);
+                break;
+        case CUBE_DIRECTION_DOWN:
+                if(!col){
+                        rotate_face(packed,CUBE_SIDE_LEFT,CUBE_DIRECTION_CW);
+                }
+                if(col==CUBE_SIZE-1){
+                        rotate_face(packed,CUBE_SIDE_RIGHT,CUBE_DIRECTION_CCW);
+                }
+                memcpy(c,bottom,CUBE_SIZE);
+                memcpy(bottom,front,CUBE_SIZE);
+                memcpy(front,top,CUBE_SIZE);
+                memcpy(top,back,CUBE_SIZE);
+                memcpy(back,c,CUBE_SIZE);
+                break;
+        }
+}
+
+void
+cube_packed_rotate_front_face(
+        CubePacked_t *packed,
+        CubeDirection_t dir
+)
+{
+        uint8_t i;
+        uint8_t c;
+
+        switch(dir){
+        default:return;
+        case CUBE_DIRECTION_CCW:
+                for(i=0;i<CUBE_SIZE;i++){
+                        c=STICKER(packed,CUBE_SIDE_TOP,i,CUBE_SIZE-1);
+                        STICKER(packed,CUBE_SIDE_TOP,i,CUBE_SIZE-1)=STICKER(packed,CUBE_SIDE_RIGHT,0,i);
+                        STICKER(packed,CUBE_SIDE_RIGHT,0,i)=STICKER(packed,CUBE_SIDE_BOTTOM,CUBE_SIZE-1-i,0);
+                        STICKER(packed,CUBE_SIDE_BOTTOM,CUBE_SIZE-1-i,0)=STICKER(packed,CUBE_SIDE_LEFT,CUBE_SIZE-1,CUBE_SIZE-1-i);
+                        STICKER(packed,CUBE_SIDE_LEFT,CUBE_SIZE-1,CUBE_SIZE-1-i)=c;
+                }
+                break;
+        case CUBE_DIRECTION_CW:
+                for(i=0;i<CUBE_SIZE;i++){
+                        c=STICKER(packed,CUBE_SIDE_TOP,i,CUBE_SIZE-1);
+                        STICKER(packed,CUBE_SIDE_TOP,i,CUBE_SIZE-1)=STICKER(packed,CUBE_SIDE_LEFT,CUBE_SIZE-1,CUBE_SIZE-1-i);
+                        STICKER(packed,CUBE_SIDE_LEFT,CUBE_SIZE-1,CUBE_SIZE-1-i)=STICKER(packed,CUBE_SIDE_BOTTOM,CUBE_SIZE-1-i,0);
+                        STICKER(packed,CUBE_SIDE_BOTTOM,CUBE_SIZE-1-i,0)=STICKER(packed,CUBE_SIDE_RIGHT,0,i);
+                        STICKER(packed,CUBE_SIDE_RIGHT,0,i)=c;
+                }
+                break;
+        }
+        rotate_face(packed,CUBE_SIDE_FRONT,dir);
+}
+
+bool
+cube_packed_is_solved(
+        CubePacked_t *packed
+)
+{
+        uint8_t i;
+        uint16_t j;
+        uint8_t *f;
+
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                f=FACE(packed,i);
+                for(j=1;j<FACE_STICKERS;j++){
+                        if(f[j]!=f[0]){
+                                return false;
+                        }
+                }
+        }
+        return true;
+}
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,682 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_posix_terminal.c
+**  @ingroup    rubicscube
+**  @brief      Rubic's cube graphics and input drivers for POSIX terminals.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_posix_terminal.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANTS
+**
+\******************************************************************************/
+
+/// Face size in characters.
+#define FACE_SIZE (CUBE_SIZE*BLOCK_SIZE)
+
+/// A character for cube drawing. The block is drawn by its background color.
+#define CUBE_CHAR " "
+
+/// A character for row cursor.
+#define ROW_CURSOR_CHAR ">"
+
+/// A character for column cursor.
+#define COL_CURSOR_CHAR "v"
+
+/// Cursor color.
+#define CURSOR_COLOR "\x1b[0m" // Default colors.
+
+/// Normal text color.
+#define TEXT_COLOR "\x1b[0m" // Default colors.
+
+/// Text color for congrats.
+#define SOLVED_COLOR "\x1b[0;32m" // Green on default background.
+
+/// Cube horizontal position.
+#define CUBE_POS_X 5
+
+/// Cube vertical position.
+#define CUBE_POS_Y 5
+
+/// Size of the input buffer in bytes.
+#define INPUT_BUFFER_SIZE 64
+
+/// Time to wait for the rest of an escape sequence after ESC in milliseconds.
+/// A lone ESC exits the game.
+#define ESCAPE_TIMEOUT 50
+
+/// Escape sequences to enter the game screen: the alternate screen, hidden
+/// cursor, default colors and a cleared screen.
+#define SCREEN_ENTER "\x1b[?1049h\x1b[?25l\x1b[0m\x1b[2J"
+
+/// Escape sequences to leave the game screen.
+#define SCREEN_LEAVE "\x1b[0m\x1b[?25h\x1b[?1049l"
+
+/// A position on the screen, zero based.
+typedef struct
+TerminalCoord_t{
+        /// Column.
+        uint16_t x;
+        /// Row.
+        uint16_t y;
+} TerminalCoord_t;
+
+/// Face offsets for drawing.
+static const TerminalCoord_t faceOffset[CUBE_SIDE_COUNT]={
+        {FACE_SIZE+FACE_SPACING,FACE_SIZE+FACE_SPACING},
+        {FACE_SIZE+FACE_SPACING,3*(FACE_SIZE+FACE_SPACING)},
+        {FACE_SIZE+FACE_SPACING,0},
+        {FACE_SIZE+FACE_SPACING,2*(FACE_SIZE+FACE_SPACING)},
+        {0,FACE_SIZE+FACE_SPACING},
+        {2*(FACE_SIZE+FACE_SPACING),FACE_SIZE+FACE_SPACING}
+};
+
+/// Background colors of the blocks.
+static const char *txtColor[CUBE_COLOR_COUNT]={
+        "\x1b[44m", // CUBE_COLOR_BLUE
+        "\x1b[42m", // CUBE_COLOR_GREEN
+        "\x1b[41m", // CUBE_COLOR_RED
+        "\x1b[48;5;208m", // CUBE_COLOR_ORANGE
+        "\x1b[103m", // CUBE_COLOR_YELLOW
+        "\x1b[107m" // CUBE_COLOR_WHITE
+};
+
+/******************************************************************************\
+**
+**  LOCAL VARIABLES
+**
+\******************************************************************************/
+
+/// Terminal settings before the game.
+static struct termios savedTermios;
+
+/// The terminal is in raw mode.
+static bool isRaw;
+
+/// Output buffer, where a frame is composed.
+static char output[TERMINAL_BUFFER_SIZE];
+
+/// Number of bytes in the output buffer.
+static size_t outputLength;
+
+/// The color sequence last written, or NULL if not known.
+static const char *currentColor;
+
+/// Input buffer. Keys typed ahead are read at once and kept here.
+static uint8_t input[INPUT_BUFFER_SIZE];
+
+/// Index of the next key in the input buffer.
+static size_t inputHead;
+
+/// Number of keys in the input buffer.
+static size_t inputCount;
+
+/// The cube as it was last drawn. Only the blocks and cursors that differ
+/// from it are drawn again.
+static Cube_t drawnCube;
+
+/// The drawn cube is on the screen.
+static bool isCubeDrawn;
+
+/// The turn count as it was last drawn.
+static uint32_t drawnTurns;
+
+/// The drawn turn count is on the screen.
+static bool isTurnsDrawn;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Writes the output buffer to the terminal.
+*/
+static void
+flush_output(
+        void
+)
+{
+        size_t done=0;
+        ssize_t n;
+
+        while(done<outputLength){
+                n=write(STDOUT_FILENO,output+done,outputLength-done);
+                if(n<0){
+                        if(errno==EINTR){
+                                continue;
+                        }
+                        break;
+                }
+                done+=(size_t)n;
+        }
+        outputLength=0;
+}
+
+/**
+**  @brief Appends bytes to the output buffer.
+**
+**  @param[in] data Bytes to append.
+**  @param[in] length Number of bytes.
+*/
+static void
+put(
+        const char *data,
+        size_t length
+)
+{
+        if(outputLength+length>sizeof(output)){
+                flush_output();
+        }
+        memcpy(output+outputLength,data,length);
+        outputLength+=length;
+}
+
+/**
+**  @brief Appends a string to the output buffer.
+**
+**  @param[in] s A string to append.
+*/
+static void
+put_string(
+        const char *s
+)
+{
+        put(s,strlen(s));
+}
+
+/**
+**  @brief A function to position the text cursor.
+**
+**  @param[in] x Cursor horizontal position.
+**  @param[in] y Cursor vertical position.
+*/
+static void
+gotoxy(
+        uint16_t x,
+        uint16_t y
+)
+{
+        char s[16];
+
+        put(s,(size_t)snprintf(s,sizeof(s),"\x1b[%u;%uH",y+1u,x+1u));
+}
+
+/**
+**  @brief A function to set text color.
+**
+**  Nothing is written if the color is already set.
+**
+**  @param[in] color Escape sequence of the color to set.
+*/
+static void
+textcolor(
+        const char *color
+)
+{
+        if(color!=currentColor){
+                put_string(color);
+                currentColor=color;
+        }
+}
+
+/**
+**  @brief Draws the blocks of a cube face that have changed.
+**
+**  The face is drawn a line of characters at a time. The cursor is
+**  positioned only where a run of changed blocks starts.
+**
+**  @param[in] face Face to draw.
+**  @param[in] drawn The face as it is on the screen, or NULL to draw all
+**                   blocks.
+**  @param[in] x Horizontal position of the top left corner.
+**  @param[in] y Vertical position of the top left corner.
+*/
+static void
+draw_face(
+        CubeFace_t *face,
+        CubeFace_t *drawn,
+        uint16_t x,
+        uint16_t y
+)
+{
+        uint8_t i;
+        uint8_t j;
+        uint8_t k;
+        uint8_t l;
+        bool isChanged[CUBE_SIZE];
+        bool isAnyChanged;
+
+        for(j=0;j<CUBE_SIZE;j++){
+                isAnyChanged=false;
+                for(i=0;i<CUBE_SIZE;i++){
+                        isChanged[i]=!drawn||
+                                face->blocks[i][j]!=drawn->blocks[i][j];
+                        isAnyChanged|=isChanged[i];
+                }
+                if(!isAnyChanged){
+                        continue;
+                }
+                for(k=0;k<BLOCK_SIZE;k++){
+                        for(i=0;i<CUBE_SIZE;i++){
+                                if(!isChanged[i]){
+                                        continue;
+                                }
+                                if(!i||!isChanged[i-1]){
+                                        gotoxy(
+                                                x+i*BLOCK_SIZE,
+                                                y+j*BLOCK_SIZE+k
+                                        );
+                                }
+                                textcolor(txtColor[face->blocks[i][j]]);
+                                for(l=0;l<BLOCK_SIZE;l++){
+                                        put_string(CUBE_CHAR);
+                                }
+                        }
+                }
+        }
+}
+
+/**
+**  @brief Draws the row cursor at one row.
+**
+**  @param[in] row Row of the cursor.
+**  @param[in] cursor Cursor character, or a space to clear the cursor.
+**  @param[in] x Overall horizontal position of the cube.
+**  @param[in] y Overall vertical position of the cube.
+*/
+static void
+draw_row_cursor(
+        uint8_t row,
+        const char *cursor,
+        uint16_t x,
+        uint16_t y
+)
+{
+        uint8_t i;
+
+        textcolor(CURSOR_COLOR);
+
+        for(i=0;i<BLOCK_SIZE;i++){
+                gotoxy(
+                        faceOffset[CUBE_SIDE_FRONT].x+x-1,
+                        faceOffset[CUBE_SIDE_FRONT].y+y+row*BLOCK_SIZE+i
+                );
+                put_string(cursor);
+        }
+}
+
+/**
+**  @brief Draws the column cursor at one column.
+**
+**  @param[in] col Column of the cursor.
+**  @param[in] cursor Cursor character, or a space to clear the cursor.
+**  @param[in] x Overall horizontal position of the cube.
+**  @param[in] y Overall vertical position of the cube.
+*/
+static void
+draw_col_cursor(
+        uint8_t col,
+        const char *cursor,
+        uint16_t x,
+        uint16_t y
+)
+{
+        uint8_t i;
+
+        textcolor(CURSOR_COLOR);
+
+        gotoxy(
+                faceOffset[CUBE_SIDE_FRONT].x+x+col*BLOCK_SIZE,
+                faceOffset[CUBE_SIDE_FRONT].y+y-1
+        );
+        for(i=0;i<BLOCK_SIZE;i++){
+                put_string(cursor);
+        }
+}
+
+/**
+**  @brief Restores the terminal settings and screen.
+*/
+static void
+restore_terminal(
+        void
+)
+{
+        put_string(SCREEN_LEAVE);
+        flush_output();
+        if(isRaw){
+                tcsetattr(STDIN_FILENO,TCSAFLUSH,&savedTermios);
+                isRaw=false;
+        }
+}
+
+/**
+**  @brief Reads a key from the terminal.
+**
+**  @param[in] timeout Time to wait in milliseconds, or -1 to wait forever.
+**
+**  @return A key, or -1 at timeout, end of input or error.
+*/
+static int
+read_key(
+        int timeout
+)
+{
+        struct pollfd p;
+        ssize_t n;
+
+        while(!inputCount){
+                if(timeout>=0){
+                        p.fd=STDIN_FILENO;
+                        p.events=POLLIN;
+                        if(poll(&p,1,timeout)<=0){
+                                return -1;
+                        }
+                }
+                n=read(STDIN_FILENO,input,sizeof(input));
+                if(n<0&&errno==EINTR){
+                        continue;
+                }
+                if(n<=0){
+                        return -1;
+                }
+                inputHead=0;
+                inputCount=(size_t)n;
+        }
+        inputCount--;
+        return input[inputHead++];
+}
+
+/**
+**  @brief Reads the rest of an escape sequence.
+**
+**  The arrow keys move the cursor. Other sequences are unknown controls.
+**
+**  @return An input control value.
+*/
+static CubeGameControl_t
+read_escape(
+        void
+)
+{
+        int c;
+
+        c=read_key(ESCAPE_TIMEOUT);
+        if(c!='['&&c!='O'){
+                if(c>=0){
+                        // Not a sequence, keep the key for the next control.
+                        inputHead--;
+                        inputCount++;
+                }
+                return GAME_CONTROL_EXIT;
+        }
+        switch(read_key(ESCAPE_TIMEOUT)){
+        default:return GAME_CONTROL_UNKNOWN;
+        case 'A':return GAME_CONTROL_MOVE_CURSOR_UP;
+        case 'B':return GAME_CONTROL_MOVE_CURSOR_DOWN;
+        case 'C':return GAME_CONTROL_MOVE_CURSOR_RIGHT;
+        case 'D':return GAME_CONTROL_MOVE_CURSOR_LEFT;
+        }
+}
+
+/******************************************************************************\
+**
+**  GRAPHICS DRIVER FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A function to init game graphics.
+*/
+static void
+terminal_graphics_init(
+        void
+)
+{
+        outputLength=0;
+        put_string(SCREEN_ENTER);
+        currentColor=TEXT_COLOR;
+        isCubeDrawn=false;
+        isTurnsDrawn=false;
+}
+
+/**
+**  @brief A function to draw a cube.
+**
+**  Only the blocks and cursors that have changed since the previous frame
+**  are drawn. The frame is composed in the output buffer and written to the
+**  terminal when the next control is read.
+**
+**  @param[in] cube A cube to draw.
+*/
+static void
+terminal_graphics_draw_cube(
+        Cube_t *cube
+)
+{
+        uint8_t i;
+        uint16_t x=CUBE_POS_X;
+        uint16_t y=CUBE_POS_Y;
+
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                draw_face(
+                        &cube->face[i],
+                        isCubeDrawn?&drawnCube.face[i]:NULL,
+                        faceOffset[i].x+x,
+                        faceOffset[i].y+y
+                );
+        }
+        if(!isCubeDrawn||cube->row!=drawnCube.row){
+                if(isCubeDrawn){
+                        draw_row_cursor(drawnCube.row," ",x,y);
+                }
+                draw_row_cursor(cube->row,ROW_CURSOR_CHAR,x,y);
+        }
+        if(!isCubeDrawn||cube->col!=drawnCube.col){
+                if(isCubeDrawn){
+                        draw_col_cursor(drawnCube.col," ",x,y);
+                }
+                draw_col_cursor(cube->col,COL_CURSOR_CHAR,x,y);
+        }
+        drawnCube=*cube;
+        isCubeDrawn=true;
+}
+
+/**
+**  @brief Print game statistics.
+**
+**  @param[in] turns Turn count.
+**  @param[in] time Time.
+**  @param[in] player Player name.
+*/
+static void
+terminal_graphics_print_statistics(
+        uint32_t turns,
+        time_t time,
+        int8_t *player
+)
+{
+        char s[32];
+
+        (void)time;
+        (void)player;
+        if(isTurnsDrawn&&turns==drawnTurns){
+                return;
+        }
+        textcolor(TEXT_COLOR);
+        gotoxy(0,0);
+        // Erases the rest of the line.
+        put(s,(size_t)snprintf(s,sizeof(s),"Turns: %u\x1b[K",turns));
+        drawnTurns=turns;
+        isTurnsDrawn=true;
+}
+
+/**
+**  @brief A function to draw a cube solved notification.
+*/
+static void
+terminal_graphics_cube_solved(
+        void
+)
+{
+        gotoxy(0,1);
+        textcolor(SOLVED_COLOR);
+        put_string("Congratulations! You solved the cube!");
+}
+
+/******************************************************************************\
+**
+**  INPUT DRIVER FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Initializes an input interface.
+**
+**  Switches the terminal to raw mode: the keys are read one by one without
+**  echo, and the control keys do not raise signals.
+*/
+static void
+terminal_input_init(
+        void
+)
+{
+        struct termios t;
+
+        inputCount=0;
+        if(isRaw||tcgetattr(STDIN_FILENO,&savedTermios)){
+                return;
+        }
+        t=savedTermios;
+        t.c_iflag&=~(tcflag_t)(BRKINT|ICRNL|INPCK|ISTRIP|IXON);
+        t.c_oflag&=~(tcflag_t)OPOST;
+        t.c_cflag|=CS8;
+        t.c_lflag&=~(tcflag_t)(ECHO|ICANON|IEXTEN|ISIG);
+        t.c_cc[VMIN]=1;
+        t.c_cc[VTIME]=0;
+        isRaw=!tcsetattr(STDIN_FILENO,TCSAFLUSH,&t);
+}
+
+/**
+**  @brief Gets an input control.
+**
+**  The frame composed since the previous control is written to the terminal
+**  first, with a single write.
+**
+**  @return An input control value.
+*/
+static CubeGameControl_t
+terminal_input_get(
+        void
+)
+{
+        flush_output();
+
+        switch(read_key(-1)){
+        default:return GAME_CONTROL_UNKNOWN;
+        case 'w':return GAME_CONTROL_MOVE_CURSOR_UP;
+        case 's':return GAME_CONTROL_MOVE_CURSOR_DOWN;
+        case 'a':return GAME_CONTROL_MOVE_CURSOR_LEFT;
+        case 'd':return GAME_CONTROL_MOVE_CURSOR_RIGHT;
+        case 'W':return GAME_CONTROL_ROTATE_CUBE_UP;
+        case 'S':return GAME_CONTROL_ROTATE_CUBE_DOWN;
+        case 'A':return GAME_CONTROL_ROTATE_CUBE_LEFT;
+        case 'D':return GAME_CONTROL_ROTATE_CUBE_RIGHT;
+        case 'i':
+        case 'I':return GAME_CONTROL_ROTATE_COL_UP;
+        case 'k':
+        case 'K':return GAME_CONTROL_ROTATE_COL_DOWN;
+        case 'j':
+        case 'J':return GAME_CONTROL_ROTATE_ROW_LEFT;
+        case 'l':
+        case 'L':return GAME_CONTROL_ROTATE_ROW_RIGHT;
+        case 'u':
+        case 'U':return GAME_CONTROL_ROTATE_FRONT_FACE_CCW;
+        case 'o':
+        case 'O':return GAME_CONTROL_ROTATE_FRONT_FACE_CW;
+        case 'n':return GAME_CONTROL_NEW;
+        case 27:return read_escape();
+        case 3: // Ctrl-C
+        case -1:return GAME_CONTROL_EXIT; // End of input, e.g. a hangup.
+        }
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_game_posix_terminal_run(
+        CubeGame_t *game
+)
+{
+        if(!isatty(STDIN_FILENO)||!isatty(STDOUT_FILENO)){
+                return false;
+        }
+        cube_game_setup_graphics_interface(
+                game,
+                terminal_graphics_init,
+                terminal_graphics_draw_cube,
+                terminal_graphics_print_statistics,
+                terminal_graphics_cube_solved
+        );
+        cube_game_setup_input_interface(
+                game,
+                terminal_input_init,
+                terminal_input_get
+        );
+        cube_game_init(game);
+        while(cube_game_run(game));
+        restore_terminal();
+        return true;
+}
+
+/* EOF */
\ No newline at end of file
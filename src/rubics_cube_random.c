@@ -0,0 +1,133 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_random.c
+**  @ingroup    rubicscube
+**  @brief      Seedable random number generator.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_random.h"
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Polynomial of the jump by 2^128 numbers.
+static const uint64_t
+jumpPolynomial[4]={
+        0x180EC6D33CFD0ABAULL,
+        0xD5A61266F0C9392CULL,
+        0xA9582618E03FC9AAULL,
+        0x39ABDC4529B1661CULL
+};
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the next number of a splitmix64 sequence.
+**
+**  The sequence spreads the bits of a seed evenly to the generator state.
+**
+**  @param[in,out] x The sequence state.
+**
+**  @return The next number.
+*/
+static uint64_t
+splitmix(
+        uint64_t *x
+)
+{
+        uint64_t z;
+
+        *x+=0x9E3779B97F4A7C15ULL;
+        z=*x;
+        z=(z^(z>>30))*0xBF58476D1CE4E5B9ULL;
+        z=(z^(z>>27))*0x94D049BB133111EBULL;
+        return z^(z>>31);
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+void
+cube_random_seed(
+        CubeRandom_t *random,
+        uint64_t seed
+)
+{
+        uint8_t i;
+
+        for(i=0;i<4;i++){
+                random->s[i]=splitmix(&seed);
+        }
+}
+
+void
+cube_random_jump(
+        CubeRandom_t *random
+)
+{
+        uint64_t s[4]={0};
+        uint8_t i;
+        uint8_t b;
+
+        for(i=0;i<4;i++){
+                for(b=0;b<64;b++){
+                        if(jumpPolynomial[i]>>b&1){
+                                s[0]^=random->s[0];
+                                s[1]^=random->s[1];
+                                s[2]^=random->s[2];
+                                s[3]^=random->s[3];
+                        }
+                        cube_random_next(random);
+                }
+        }
+        for(i=0;i<4;i++){
+                random->s[i]=s[i];
+        }
+}
+
+/* EOF */
\ No newline at end of file
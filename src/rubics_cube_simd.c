@@ -0,0 +1,514 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_simd.c
+**  @ingroup    rubicscube
+**  @brief      Vectorized turn engine for packed cubes.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_simd.h"
+
+#include <string.h>
+
+#if defined(_M_X64)||defined(_M_IX86)||defined(__x86_64__)||defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if CUBE_PACKED_BYTES==64
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Enables an instruction set for one function. MSVC allows intrinsics of
+///any instruction set without it.
+#if defined(SIMD_X86)&&!defined(_MSC_VER)
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+/// Shuffle mask value that produces a zero byte.
+#define ZERO_LANE 0x80
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief A function to apply a sequence of turns.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] turns Turns to apply.
+**  @param[in] count Number of turns.
+*/
+typedef void
+(*TurnKernel_t)(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+);
+
+/******************************************************************************\
+**
+**  LOCAL VARIABLES
+**
+\******************************************************************************/
+
+/// Permutations of the turns. Sticker i of the turned cube is the sticker
+///permutation[turn][i] of the original cube.
+static CUBE_ALIGN(64) uint8_t permutation[CUBE_TURN_COUNT][64];
+
+/// Byte shuffle masks of the turns. Mask [turn][k] picks the stickers from
+///the 16-byte chunk k of the original cube and zeroes the others.
+static CUBE_ALIGN(64) uint8_t shuffleMask[CUBE_TURN_COUNT][4][64];
+
+/// Tables have been built.
+static bool tablesBuilt=false;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies a clockwise quarter turn with the scalar move functions.
+**
+**  @param[in] p A packed cube.
+**  @param[in] layer The layer to turn, as the first turn of the layer.
+*/
+static void
+quarter_turn(
+        CubePacked_t *p,
+        CubeTurn_t layer
+)
+{
+        switch(layer){
+        default:return;
+        case CUBE_TURN_U:
+                cube_packed_rotate_row(p,0,CUBE_DIRECTION_LEFT);
+                break;
+        case CUBE_TURN_R:
+                cube_packed_rotate_column(p,CUBE_SIZE-1,CUBE_DIRECTION_UP);
+                break;
+        case CUBE_TURN_F:
+                cube_packed_rotate_front_face(p,CUBE_DIRECTION_CW);
+                break;
+        case CUBE_TURN_D:
+                cube_packed_rotate_row(p,CUBE_SIZE-1,CUBE_DIRECTION_RIGHT);
+                break;
+        case CUBE_TURN_L:
+                cube_packed_rotate_column(p,0,CUBE_DIRECTION_DOWN);
+                break;
+        case CUBE_TURN_B:
+                // The back face is turned at the front.
+                cube_packed_rotate(p,CUBE_DIRECTION_LEFT);
+                cube_packed_rotate(p,CUBE_DIRECTION_LEFT);
+                cube_packed_rotate_front_face(p,CUBE_DIRECTION_CW);
+                cube_packed_rotate(p,CUBE_DIRECTION_LEFT);
+                cube_packed_rotate(p,CUBE_DIRECTION_LEFT);
+                break;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Builds the permutation and shuffle mask tables.
+**
+**  Every turn is applied to a cube whose stickers are labeled with their own
+**  index, so the result is the permutation of the turn.
+*/
+static void
+build_tables(
+        void
+)
+{
+        CubePacked_t p;
+        uint8_t t;
+        uint8_t i;
+        uint8_t k;
+
+        for(t=0;t<CUBE_TURN_COUNT;t++){
+                for(i=0;i<64;i++){
+                        p.sticker[i]=i;
+                }
+                for(i=0;i<=t%3;i++){
+                        quarter_turn(&p,t-t%3);
+                }
+                memcpy(permutation[t],p.sticker,64);
+                for(k=0;k<4;k++){
+                        for(i=0;i<64;i++){
+                                shuffleMask[t][k][i]=p.sticker[i]/16==k?
+                                        p.sticker[i]%16:ZERO_LANE;
+                        }
+                }
+        }
+        tablesBuilt=true;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies turns with portable C.
+*/
+static void
+turns_scalar(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        CubePacked_t p;
+        uint8_t *perm;
+        uint32_t i;
+        uint8_t j;
+
+        for(i=0;i<count;i++){
+                perm=permutation[turns[i]];
+                for(j=0;j<CUBE_PACKED_STICKERS;j++){
+                        p.sticker[j]=packed->sticker[perm[j]];
+                }
+                memcpy(packed->sticker,p.sticker,CUBE_PACKED_STICKERS);
+        }
+}
+
+#if defined(SIMD_X86)
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies turns with 128-bit byte shuffles.
+**
+**  Each output chunk is combined from four shuffles, one per input chunk.
+*/
+SIMD_TARGET("ssse3") static void
+turns_ssse3(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        __m128i v[4];
+        __m128i r[4];
+        uint8_t (*m)[64];
+        uint32_t i;
+        uint8_t j;
+
+        for(j=0;j<4;j++){
+                v[j]=_mm_load_si128((__m128i*)&packed->sticker[16*j]);
+        }
+        for(i=0;i<count;i++){
+                m=shuffleMask[turns[i]];
+                for(j=0;j<4;j++){
+                        r[j]=_mm_or_si128(
+                                _mm_or_si128(
+                                        _mm_shuffle_epi8(v[0],_mm_load_si128((__m128i*)&m[0][16*j])),
+                                        _mm_shuffle_epi8(v[1],_mm_load_si128((__m128i*)&m[1][16*j]))
+                                ),
+                                _mm_or_si128(
+                                        _mm_shuffle_epi8(v[2],_mm_load_si128((__m128i*)&m[2][16*j])),
+                                        _mm_shuffle_epi8(v[3],_mm_load_si128((__m128i*)&m[3][16*j]))
+                                )
+                        );
+                }
+                for(j=0;j<4;j++){
+                        v[j]=r[j];
+                }
+        }
+        for(j=0;j<4;j++){
+                _mm_store_si128((__m128i*)&packed->sticker[16*j],v[j]);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies turns with 256-bit byte shuffles.
+**
+**  Every input chunk is broadcast to both lanes, so each 32-byte half of the
+**  output is combined from four in-lane shuffles.
+*/
+SIMD_TARGET("avx2") static void
+turns_avx2(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        __m256i lo;
+        __m256i hi;
+        __m256i b[4];
+        __m256i r[2];
+        uint8_t (*m)[64];
+        uint32_t i;
+        uint8_t j;
+
+        lo=_mm256_load_si256((__m256i*)&packed->sticker[0]);
+        hi=_mm256_load_si256((__m256i*)&packed->sticker[32]);
+        for(i=0;i<count;i++){
+                m=shuffleMask[turns[i]];
+                b[0]=_mm256_permute2x128_si256(lo,lo,0x00);
+                b[1]=_mm256_permute2x128_si256(lo,lo,0x11);
+                b[2]=_mm256_permute2x128_si256(hi,hi,0x00);
+                b[3]=_mm256_permute2x128_si256(hi,hi,0x11);
+                for(j=0;j<2;j++){
+                        r[j]=_mm256_or_si256(
+                                _mm256_or_si256(
+                                        _mm256_shuffle_epi8(b[0],_mm256_load_si256((__m256i*)&m[0][32*j])),
+                                        _mm256_shuffle_epi8(b[1],_mm256_load_si256((__m256i*)&m[1][32*j]))
+                                ),
+                                _mm256_or_si256(
+                                        _mm256_shuffle_epi8(b[2],_mm256_load_si256((__m256i*)&m[2][32*j])),
+                                        _mm256_shuffle_epi8(b[3],_mm256_load_si256((__m256i*)&m[3][32*j]))
+                                )
+                        );
+                }
+                lo=r[0];
+                hi=r[1];
+        }
+        _mm256_store_si256((__m256i*)&packed->sticker[0],lo);
+        _mm256_store_si256((__m256i*)&packed->sticker[32],hi);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Applies turns with a single 512-bit byte permutation per turn.
+*/
+SIMD_TARGET("avx512f,avx512bw,avx512vbmi") static void
+turns_avx512_vbmi(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        __m512i v;
+        uint32_t i;
+
+        v=_mm512_load_si512(packed->sticker);
+        for(i=0;i<count;i++){
+                v=_mm512_permutexvar_epi8(_mm512_load_si512(permutation[turns[i]]),v);
+        }
+        _mm512_store_si512(packed->sticker,v);
+}
+
+#endif // if defined(SIMD_X86)
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if the processor supports an instruction set level.
+**
+**  @param[in] level An instruction set level.
+**
+**  @retval true The level is supported.
+**  @retval false The level is not supported.
+*/
+static bool
+level_supported(
+        CubeSimdLevel_t level
+)
+{
+#if defined(SIMD_X86)&&defined(_MSC_VER)
+        int info[4];
+        unsigned long long xcr0;
+
+        if(level==CUBE_SIMD_SCALAR){
+                return true;
+        }
+        __cpuid(info,1);
+        if(level==CUBE_SIMD_SSSE3){
+                return (info[2]>>9)&1;
+        }
+        if(!((info[2]>>27)&1)){
+                // No OSXSAVE, so the wide registers are not saved by the OS.
+                return false;
+        }
+        xcr0=_xgetbv(0);
+        __cpuidex(info,7,0);
+        switch(level){
+        default:return false;
+        case CUBE_SIMD_AVX2:
+                return (xcr0&0x06)==0x06&&((info[1]>>5)&1);
+        case CUBE_SIMD_AVX512_VBMI:
+                return (xcr0&0xE6)==0xE6&&
+                        ((info[1]>>16)&1)&&((info[1]>>30)&1)&&((info[2]>>1)&1);
+        }
+#elif defined(SIMD_X86)
+        __builtin_cpu_init();
+        switch(level){
+        default:return false;
+        case CUBE_SIMD_SCALAR:
+                return true;
+        case CUBE_SIMD_SSSE3:
+                return __builtin_cpu_supports("ssse3");
+        case CUBE_SIMD_AVX2:
+                return __builtin_cpu_supports("avx2");
+        case CUBE_SIMD_AVX512_VBMI:
+                return __builtin_cpu_supports("avx512f")&&
+                        __builtin_cpu_supports("avx512bw")&&
+                        __builtin_cpu_supports("avx512vbmi");
+        }
+#else
+        return level==CUBE_SIMD_SCALAR;
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Initializes the engine on the first use and applies the turns.
+*/
+static void
+turns_init(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+);
+
+/******************************************************************************\
+**
+**  LOCAL VARIABLES
+**
+\******************************************************************************/
+
+/// The kernel in use.
+static TurnKernel_t kernel=turns_init;
+
+/// The instruction set level in use.
+static CubeSimdLevel_t simdLevel=CUBE_SIMD_SCALAR;
+
+/// Kernels of the instruction set levels.
+static const TurnKernel_t
+levelKernel[CUBE_SIMD_LEVEL_COUNT]={
+        turns_scalar,
+#if defined(SIMD_X86)
+        turns_ssse3,
+        turns_avx2,
+        turns_avx512_vbmi
+#endif
+};
+
+static void
+turns_init(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        cube_simd_init();
+        kernel(packed,turns,count);
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+void
+cube_simd_init(
+        void
+)
+{
+        int8_t level;
+
+        for(level=CUBE_SIMD_LEVEL_COUNT-1;level>=0;level--){
+                if(cube_simd_set_level((CubeSimdLevel_t)level)){
+                        return;
+                }
+        }
+}
+
+CubeSimdLevel_t
+cube_simd_get_level(
+        void
+)
+{
+        if(kernel==turns_init){
+                cube_simd_init();
+        }
+        return simdLevel;
+}
+
+bool
+cube_simd_set_level(
+        CubeSimdLevel_t level
+)
+{
+        if(level>=CUBE_SIMD_LEVEL_COUNT||!levelKernel[level]||!level_supported(level)){
+                return false;
+        }
+        if(!tablesBuilt){
+                build_tables();
+        }
+        simdLevel=level;
+        kernel=levelKernel[level];
+        return true;
+}
+
+bool
+cube_packed_turn(
+        CubePacked_t *packed,
+        CubeTurn_t turn
+)
+{
+        if(turn>=CUBE_TURN_COUNT){
+                return false;
+        }
+        kernel(packed,&turn,1);
+        return true;
+}
+
+bool
+cube_packed_turns(
+        CubePacked_t *packed,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        uint32_t i;
+
+        // The kernels index the permutation tables with the turns unchecked.
+        for(i=0;i<count;i++){
+                if(turns[i]>=CUBE_TURN_COUNT){
+                        return false;
+                }
+        }
+        kernel(packed,turns,count);
+        return true;
+}
+
+#endif // if CUBE_PACKED_BYTES==64
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,688 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_sized.c
+**  @ingroup    rubicscube
+**  @brief      Cubes of any size chosen at run time.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_sized.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Layer moves of the outer layer turns. The layer is 0 for the near
+**  layer and 1 for the far layer of the axis.
+*/
+static const CubeMove_t
+turnMoves[CUBE_TURN_COUNT]={
+        {CUBE_AXIS_Y,0,0,1}, // U
+        {CUBE_AXIS_Y,0,0,2}, // U2
+        {CUBE_AXIS_Y,0,0,3}, // U'
+        {CUBE_AXIS_X,1,1,1}, // R
+        {CUBE_AXIS_X,1,1,2}, // R2
+        {CUBE_AXIS_X,1,1,3}, // R'
+        {CUBE_AXIS_Z,0,0,1}, // F
+        {CUBE_AXIS_Z,0,0,2}, // F2
+        {CUBE_AXIS_Z,0,0,3}, // F'
+        {CUBE_AXIS_Y,1,1,3}, // D
+        {CUBE_AXIS_Y,1,1,2}, // D2
+        {CUBE_AXIS_Y,1,1,1}, // D'
+        {CUBE_AXIS_X,0,0,3}, // L
+        {CUBE_AXIS_X,0,0,2}, // L2
+        {CUBE_AXIS_X,0,0,1}, // L'
+        {CUBE_AXIS_Z,1,1,3}, // B
+        {CUBE_AXIS_Z,1,1,2}, // B2
+        {CUBE_AXIS_Z,1,1,1} // B'
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Faces around the layers of each axis, in the order the stickers of
+**  a layer are cycled.
+*/
+static const CubeSide_t
+layerRing[CUBE_AXIS_COUNT][4]={
+        {CUBE_SIDE_TOP,CUBE_SIDE_FRONT,CUBE_SIDE_BOTTOM,CUBE_SIDE_BACK}, // X
+        {CUBE_SIDE_LEFT,CUBE_SIDE_FRONT,CUBE_SIDE_RIGHT,CUBE_SIDE_BACK}, // Y
+        {CUBE_SIDE_TOP,CUBE_SIDE_LEFT,CUBE_SIDE_BOTTOM,CUBE_SIDE_RIGHT} // Z
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Mapping of the block positions of a face to the positions of its
+**  stickers, by rotation of the face.
+**
+**  The sticker of the block on row x and column y of a face with rotation r
+**  is at origin+x*row+y*column. The step per row is rowStep[r][0]*size+
+**  rowStep[r][1], and the step per column is formed likewise. The origin is
+**  the sticker on row originRow[r]*(size-1) and column
+**  originColumn[r]*(size-1).
+*/
+static const int8_t
+rowStep[4][2]={{1,0},{0,-1},{-1,0},{0,1}};
+static const int8_t
+columnStep[4][2]={{0,1},{1,0},{0,-1},{-1,0}};
+static const uint8_t
+originRow[4]={0,0,1,1};
+static const uint8_t
+originColumn[4]={0,1,1,0};
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Cycles four stickers.
+**
+**  With one quarter turn each sticker gets the color of the next one, and
+**  the last sticker gets the color of the first one.
+**
+**  @param[in] a The first sticker.
+**  @param[in] b The second sticker.
+**  @param[in] c The third sticker.
+**  @param[in] d The fourth sticker.
+**  @param[in] turns Quarter turns (1-3).
+*/
+static inline void
+cycle_stickers(
+        uint8_t *a,
+        uint8_t *b,
+        uint8_t *c,
+        uint8_t *d,
+        uint8_t turns
+)
+{
+        uint8_t t;
+
+        switch(turns){
+        default:return;
+        case 1:
+                t=*a;
+                *a=*b;
+                *b=*c;
+                *c=*d;
+                *d=t;
+                break;
+        case 2:
+                t=*a;
+                *a=*c;
+                *c=t;
+                t=*b;
+                *b=*d;
+                *d=t;
+                break;
+        case 3:
+                t=*d;
+                *d=*c;
+                *c=*b;
+                *b=*a;
+                *a=t;
+                break;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Cycles the stickers of four strips.
+**
+**  @param[in] a The first sticker of the first strip.
+**  @param[in] sa Step to the next sticker of the first strip.
+**  @param[in] b The first sticker of the second strip.
+**  @param[in] sb Step to the next sticker of the second strip.
+**  @param[in] c The first sticker of the third strip.
+**  @param[in] sc Step to the next sticker of the third strip.
+**  @param[in] d The first sticker of the fourth strip.
+**  @param[in] sd Step to the next sticker of the fourth strip.
+**  @param[in] count Length of the strips.
+**  @param[in] turns Quarter turns (1-3).
+*/
+static inline void
+cycle_strips(
+        uint8_t *a,
+        int32_t sa,
+        uint8_t *b,
+        int32_t sb,
+        uint8_t *c,
+        int32_t sc,
+        uint8_t *d,
+        int32_t sd,
+        uint32_t count,
+        uint8_t turns
+)
+{
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                cycle_stickers(a,b,c,d,turns);
+                a+=sa;
+                b+=sb;
+                c+=sc;
+                d+=sd;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Cycles the strips of a layer by a constant turn.
+**
+**  The turn is a constant in each call, so the choice of the turn is made
+**  once instead of for each sticker.
+**
+**  @param[in] a The first sticker of the first strip.
+**  @param[in] sa Step to the next sticker of the first strip.
+**  @param[in] b The first sticker of the second strip.
+**  @param[in] sb Step to the next sticker of the second strip.
+**  @param[in] c The first sticker of the third strip.
+**  @param[in] sc Step to the next sticker of the third strip.
+**  @param[in] d The first sticker of the fourth strip.
+**  @param[in] sd Step to the next sticker of the fourth strip.
+**  @param[in] count Length of the strips.
+**  @param[in] turns Quarter turns (1-3).
+*/
+static inline void
+cycle_strips_by(
+        uint8_t *a,
+        int32_t sa,
+        uint8_t *b,
+        int32_t sb,
+        uint8_t *c,
+        int32_t sc,
+        uint8_t *d,
+        int32_t sd,
+        uint32_t count,
+        uint8_t turns
+)
+{
+        switch(turns){
+        default:return;
+        case 1:
+                cycle_strips(a,sa,b,sb,c,sc,d,sd,count,1);
+                break;
+        case 2:
+                cycle_strips(a,sa,b,sb,c,sc,d,sd,count,2);
+                break;
+        case 3:
+                cycle_strips(a,sa,b,sb,c,sc,d,sd,count,3);
+                break;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Locates the stickers of a line of blocks on a face.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] n Size of the cube.
+**  @param[in] side Side of the face.
+**  @param[in] x Row of the first block.
+**  @param[in] y Column of the first block.
+**  @param[in] dx Step of the row to the next block.
+**  @param[in] dy Step of the column to the next block.
+**  @param[out] step Step to the sticker of the next block.
+**
+**  @return The sticker of the first block.
+*/
+static inline uint8_t *
+locate_strip(
+        CubeSized_t *cube,
+        uint32_t n,
+        uint8_t side,
+        int32_t x,
+        int32_t y,
+        int32_t dx,
+        int32_t dy,
+        int32_t *step
+)
+{
+        int32_t row;
+        int32_t column;
+        int32_t origin;
+        uint8_t r;
+
+        r=cube->rotation[side];
+        row=rowStep[r][0]*(int32_t)n+rowStep[r][1];
+        column=columnStep[r][0]*(int32_t)n+columnStep[r][1];
+        origin=(originRow[r]*(int32_t)n+originColumn[r])*((int32_t)n-1);
+        *step=dx*row+dy*column;
+        return cube->sticker+side*n*n+origin+x*row+y*column;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns a face.
+**
+**  The stickers stay in place, and the turn is added to the rotation of the
+**  face.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] side Side of the face.
+**  @param[in] turns Clockwise quarter turns (1-3).
+*/
+static inline void
+turn_face(
+        CubeSized_t *cube,
+        uint8_t side,
+        uint8_t turns
+)
+{
+        cube->rotation[side]=(uint8_t)((cube->rotation[side]+turns)&3);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns one layer.
+**
+**  A face turn only changes the rotation of the face. The stickers of the
+**  four strips of the layer are located through the rotations of their
+**  faces and cycled.
+**
+**  The function is inlined with a constant size into the kernel of each
+**  small size, and with the size of the cube into the generic kernel.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] n Size of the cube.
+**  @param[in] axis Axis of the layer.
+**  @param[in] layer Index of the layer (0 - n-1).
+**  @param[in] turns Quarter turns (1-3).
+*/
+static inline void
+turn_layer(
+        CubeSized_t *cube,
+        uint32_t n,
+        uint8_t axis,
+        uint8_t layer,
+        uint8_t turns
+)
+{
+        const CubeSide_t *ring;
+        uint8_t *a;
+        uint8_t *b;
+        uint8_t *c;
+        uint8_t *d;
+        int32_t sa;
+        int32_t sb;
+        int32_t sc;
+        int32_t sd;
+        int32_t l;
+        int32_t m;
+
+        ring=layerRing[axis];
+        l=layer;
+        m=(int32_t)n-1;
+        switch(axis){
+        default:return;
+        case CUBE_AXIS_X:
+                if(!layer){
+                        turn_face(cube,CUBE_SIDE_LEFT,4-turns);
+                }
+                if(layer==n-1){
+                        turn_face(cube,CUBE_SIDE_RIGHT,turns);
+                }
+                // Row layer of the top, front, bottom and back faces.
+                a=locate_strip(cube,n,ring[0],l,0,0,1,&sa);
+                b=locate_strip(cube,n,ring[1],l,0,0,1,&sb);
+                c=locate_strip(cube,n,ring[2],l,0,0,1,&sc);
+                d=locate_strip(cube,n,ring[3],l,0,0,1,&sd);
+                break;
+        case CUBE_AXIS_Y:
+                if(!layer){
+                        turn_face(cube,CUBE_SIDE_TOP,turns);
+                }
+                if(layer==n-1){
+                        turn_face(cube,CUBE_SIDE_BOTTOM,4-turns);
+                }
+                // Column layer of the left, front and right faces, and the
+                // back face upside down.
+                a=locate_strip(cube,n,ring[0],0,l,1,0,&sa);
+                b=locate_strip(cube,n,ring[1],0,l,1,0,&sb);
+                c=locate_strip(cube,n,ring[2],0,l,1,0,&sc);
+                d=locate_strip(cube,n,ring[3],m,m-l,-1,0,&sd);
+                break;
+        case CUBE_AXIS_Z:
+                if(!layer){
+                        turn_face(cube,CUBE_SIDE_FRONT,turns);
+                }
+                if(layer==n-1){
+                        turn_face(cube,CUBE_SIDE_BACK,4-turns);
+                }
+                // Column n-1-layer of the top face down, row n-1-layer of the
+                // left face to the left, column layer of the bottom face up
+                // and row layer of the right face to the right.
+                a=locate_strip(cube,n,ring[0],0,m-l,1,0,&sa);
+                b=locate_strip(cube,n,ring[1],m-l,m,0,-1,&sb);
+                c=locate_strip(cube,n,ring[2],m,l,-1,0,&sc);
+                d=locate_strip(cube,n,ring[3],l,0,0,1,&sd);
+                break;
+        }
+        cycle_strips_by(a,sa,b,sb,c,sc,d,sd,n,turns);
+}
+
+/// Defines the turn kernel of a size.
+#define TURN_KERNEL(n)                                                          \
+static void                                                                     \
+turn_kernel_##n(                                                                \
+        CubeSized_t *cube,                                                      \
+        uint8_t axis,                                                           \
+        uint8_t layer,                                                          \
+        uint8_t turns                                                           \
+)                                                                               \
+{                                                                               \
+        turn_layer(cube,n,axis,layer,turns);                                    \
+}
+
+TURN_KERNEL(2)
+TURN_KERNEL(3)
+TURN_KERNEL(4)
+TURN_KERNEL(5)
+TURN_KERNEL(6)
+TURN_KERNEL(7)
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Turns one layer of a cube of any size.
+**
+**  @param[in] cube A pointer to a cube.
+**  @param[in] axis Axis of the layer.
+**  @param[in] layer Index of the layer (0 - size-1).
+**  @param[in] turns Quarter turns (1-3).
+*/
+static void
+turn_generic(
+        CubeSized_t *cube,
+        uint8_t axis,
+        uint8_t layer,
+        uint8_t turns
+)
+{
+        turn_layer(cube,cube->size,axis,layer,turns);
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_sized_init(
+        CubeSized_t *cube,
+        uint32_t size
+)
+{
+        cube->sticker=NULL;
+        cube->size=0;
+        if(size<CUBE_SIZED_MIN_SIZE||size>CUBE_SIZED_MAX_SIZE){
+                return false;
+        }
+        cube->sticker=(uint8_t *)malloc(CUBE_SIDE_COUNT*size*size);
+        if(!cube->sticker){
+                return false;
+        }
+        cube->size=(uint8_t)size;
+        cube_sized_reset(cube);
+        return true;
+}
+
+void
+cube_sized_free(
+        CubeSized_t *cube
+)
+{
+        free(cube->sticker);
+        cube->sticker=NULL;
+        cube->size=0;
+}
+
+void
+cube_sized_reset(
+        CubeSized_t *cube
+)
+{
+        uint32_t faceSize;
+        uint8_t i;
+
+        faceSize=(uint32_t)cube->size*cube->size;
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                memset(cube->sticker+i*faceSize,cube_get_reset_color((CubeSide_t)i),faceSize);
+        }
+        memset(cube->rotation,0,sizeof(cube->rotation));
+}
+
+bool
+cube_sized_copy(
+        CubeSized_t *src,
+        CubeSized_t *dest
+)
+{
+        if(src->size!=dest->size){
+                return false;
+        }
+        memcpy(dest->sticker,src->sticker,CUBE_SIDE_COUNT*(uint32_t)src->size*src->size);
+        memcpy(dest->rotation,src->rotation,sizeof(dest->rotation));
+        return true;
+}
+
+CubeColor_t
+cube_sized_get_block(
+        CubeSized_t *cube,
+        CubeSide_t side,
+        uint8_t x,
+        uint8_t y
+)
+{
+        int32_t step;
+
+        return (CubeColor_t)*locate_strip(cube,cube->size,side,x,y,0,0,&step);
+}
+
+void
+cube_sized_turn(
+        CubeSized_t *cube,
+        CubeAxis_t axis,
+        uint8_t layer,
+        uint8_t turns
+)
+{
+        turns&=3;
+        if(!turns||layer>=cube->size||axis>=CUBE_AXIS_COUNT){
+                return;
+        }
+        switch(cube->size){
+        case 2:
+                turn_kernel_2(cube,axis,layer,turns);
+                break;
+        case 3:
+                turn_kernel_3(cube,axis,layer,turns);
+                break;
+        case 4:
+                turn_kernel_4(cube,axis,layer,turns);
+                break;
+        case 5:
+                turn_kernel_5(cube,axis,layer,turns);
+                break;
+        case 6:
+                turn_kernel_6(cube,axis,layer,turns);
+                break;
+        case 7:
+                turn_kernel_7(cube,axis,layer,turns);
+                break;
+        default:
+                turn_generic(cube,axis,layer,turns);
+                break;
+        }
+}
+
+void
+cube_sized_apply_moves(
+        CubeSized_t *cube,
+        CubeMove_t *moves,
+        uint32_t count
+)
+{
+        uint32_t i;
+        uint16_t layer;
+
+        for(i=0;i<count;i++){
+                for(layer=moves[i].first;layer<=moves[i].last&&layer<cube->size;layer++){
+                        cube_sized_turn(cube,(CubeAxis_t)moves[i].axis,(uint8_t)layer,moves[i].turns);
+                }
+        }
+}
+
+void
+cube_sized_apply_turns(
+        CubeSized_t *cube,
+        CubeTurn_t *turns,
+        uint32_t count
+)
+{
+        const CubeMove_t *m;
+        uint32_t i;
+
+        for(i=0;i<count;i++){
+                if(turns[i]<CUBE_TURN_COUNT){
+                        m=&turnMoves[turns[i]];
+                        cube_sized_turn(cube,(CubeAxis_t)m->axis,m->first?cube->size-1:0,m->turns);
+                }
+        }
+}
+
+void
+cube_sized_shuffle(
+        CubeSized_t *cube,
+        CubeRandom_t *random,
+        uint32_t length
+)
+{
+        uint32_t i;
+        uint8_t axis;
+        uint8_t layer;
+        uint8_t a;
+        uint8_t l;
+
+        // The same draws as cube_shuffle().
+        axis=CUBE_AXIS_COUNT;
+        layer=0;
+        for(i=0;i<length;i++){
+                do{
+                        a=(uint8_t)cube_random_below(random,CUBE_AXIS_COUNT);
+                        l=(uint8_t)cube_random_below(random,(uint32_t)(cube->size-cube->size%2));
+                }while(a==axis&&l<=layer);
+                axis=a;
+                layer=l;
+                if(cube->size%2&&l>=cube->size/2){
+                        l++;
+                }
+                cube_sized_turn(cube,(CubeAxis_t)a,l,(uint8_t)(cube_random_below(random,3)+1));
+        }
+}
+
+bool
+cube_sized_is_solved(
+        CubeSized_t *cube
+)
+{
+        uint32_t faceSize;
+        uint32_t j;
+        uint8_t *face;
+        uint8_t i;
+
+        faceSize=(uint32_t)cube->size*cube->size;
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                face=cube->sticker+i*faceSize;
+                for(j=1;j<faceSize;j++){
+                        if(face[j]!=face[0]){
+                                return false;
+                        }
+                }
+        }
+        return true;
+}
+
+bool
+cube_sized_from_cube(
+        CubeSized_t *cube,
+        Cube_t *src
+)
+{
+        uint8_t *s;
+        uint8_t i;
+        uint8_t j;
+        uint8_t k;
+
+        if(cube->size!=CUBE_SIZE){
+                return false;
+        }
+        s=cube->sticker;
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                for(j=0;j<CUBE_SIZE;j++){
+                        for(k=0;k<CUBE_SIZE;k++){
+                                *s++=(uint8_t)src->face[i].blocks[j][k];
+                        }
+                }
+        }
+        memset(cube->rotation,0,sizeof(cube->rotation));
+        return true;
+}
+
+bool
+cube_sized_to_cube(
+        CubeSized_t *cube,
+        Cube_t *dest
+)
+{
+        uint8_t i;
+        uint8_t j;
+        uint8_t k;
+
+        if(cube->size!=CUBE_SIZE){
+                return false;
+        }
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                for(j=0;j<CUBE_SIZE;j++){
+                        for(k=0;k<CUBE_SIZE;k++){
+                                dest->face[i].blocks[j][k]=cube_sized_get_block(cube,(CubeSide_t)i,j,k);
+                        }
+                }
+        }
+        cube_recount(dest);
+        return true;
+}
+
+/* EOF */
\ No newline at end of file
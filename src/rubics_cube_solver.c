@@ -0,0 +1,757 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_solver.c
+**  @ingroup    rubicscube
+**  @brief      Two-phase solver for the 3x3x3 cube.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_solver.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Number of corner orientations.
+#define TWIST_COUNT 2187
+
+/// Number of edge orientations.
+#define FLIP_COUNT 2048
+
+/// Number of position sets of the middle layer edges.
+#define SLICE_COUNT 495
+
+/// Number of orders of the middle layer edges.
+#define SLICE_ORDER_COUNT 24
+
+/// Number of positions and orders of the middle layer edges.
+#define SLICE_SORTED_COUNT (SLICE_COUNT*SLICE_ORDER_COUNT)
+
+/// Number of permutations of the corners, or the top and bottom layer edges.
+#define PERM_COUNT 40320
+
+/// Number of phase 2 moves.
+#define PHASE2_MOVE_COUNT 10
+
+/// Marks a turn that is not a phase 2 move.
+#define NOT_PHASE2 0xFF
+
+/// Pruning table value of an unvisited entry, and the largest distance.
+#define PRUNE_EMPTY 15
+
+/// Size of the corner orientation move table in bytes.
+#define TWIST_MOVE_BYTES (TWIST_COUNT*CUBE_TURN_COUNT*2)
+
+/// Size of the edge orientation move table in bytes.
+#define FLIP_MOVE_BYTES (FLIP_COUNT*CUBE_TURN_COUNT*2)
+
+/// Size of the middle layer edge move table in bytes.
+#define SLICE_MOVE_BYTES (SLICE_SORTED_COUNT*CUBE_TURN_COUNT*2)
+
+/// Size of a permutation move table in bytes.
+#define PERM_MOVE_BYTES (PERM_COUNT*PHASE2_MOVE_COUNT*2)
+
+/// Size of the phase 1 corner pruning table in bytes.
+#define SLICE_TWIST_PRUNE_BYTES ((SLICE_COUNT*TWIST_COUNT+1)/2)
+
+/// Size of the phase 1 edge pruning table in bytes.
+#define SLICE_FLIP_PRUNE_BYTES ((SLICE_COUNT*FLIP_COUNT+1)/2)
+
+/// Size of a phase 2 pruning table in bytes.
+#define SLICE_PERM_PRUNE_BYTES ((SLICE_ORDER_COUNT*PERM_COUNT+1)/2)
+
+/// Size of all tables in bytes.
+#define TABLE_BYTES (TWIST_MOVE_BYTES+FLIP_MOVE_BYTES+SLICE_MOVE_BYTES+\
+        2*PERM_MOVE_BYTES+SLICE_TWIST_PRUNE_BYTES+SLICE_FLIP_PRUNE_BYTES+\
+        2*SLICE_PERM_PRUNE_BYTES)
+
+/// Identifier of the table set.
+#define TABLE_ID 0x32534352
+
+/// Version of the table set.
+#define TABLE_VERSION 1
+
+/// Moves of phase 2.
+static const CubeTurn_t
+phase2Moves[PHASE2_MOVE_COUNT]={
+        CUBE_TURN_U,
+        CUBE_TURN_U2,
+        CUBE_TURN_U_PRIME,
+        CUBE_TURN_D,
+        CUBE_TURN_D2,
+        CUBE_TURN_D_PRIME,
+        CUBE_TURN_R2,
+        CUBE_TURN_L2,
+        CUBE_TURN_F2,
+        CUBE_TURN_B2
+};
+
+/// Phase 2 move index of each turn.
+static const uint8_t
+phase2Index[CUBE_TURN_COUNT]={
+        0,1,2, // U
+        NOT_PHASE2,6,NOT_PHASE2, // R
+        NOT_PHASE2,8,NOT_PHASE2, // F
+        3,4,5, // D
+        NOT_PHASE2,7,NOT_PHASE2, // L
+        NOT_PHASE2,9,NOT_PHASE2 // B
+};
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief State of one search.
+*/
+typedef struct
+Search_t{
+        /// The solver.
+        CubeSolver_t *solver;
+        /// The cube to solve.
+        CubeCubie_t cubie;
+        /// The longest accepted solution.
+        uint8_t maxLength;
+        /// Moves of the current path.
+        uint8_t moves[CUBE_SOLVER_MAX_LENGTH];
+        /// The shortest solution found.
+        uint8_t solution[CUBE_SOLVER_MAX_LENGTH];
+        /// Length of the shortest solution found.
+        uint8_t length;
+        /// A solution was found.
+        bool found;
+        /// Phase 2 searches left after the first solution.
+        uint32_t probes;
+} Search_t;
+
+/**
+**  @brief A step of a pruning table search.
+**
+**  @param[in] solver The solver.
+**  @param[in] index A pruning table index.
+**  @param[in] move A move.
+**
+**  @return The index reached with the move.
+*/
+typedef uint32_t
+(*PruneStep_t)(
+        CubeSolver_t *solver,
+        uint32_t index,
+        uint8_t move
+);
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets a distance from a pruning table.
+**
+**  @param[in] table A pruning table of 4-bit entries.
+**  @param[in] index An entry.
+**
+**  @return The distance.
+*/
+static inline uint8_t
+get_prune(
+        uint8_t *table,
+        uint32_t index
+)
+{
+        return (table[index>>1]>>((index&1)<<2))&0x0F;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sets a distance to a pruning table.
+**
+**  @param[in] table A pruning table of 4-bit entries.
+**  @param[in] index An entry.
+**  @param[in] value The distance.
+*/
+static inline void
+set_prune(
+        uint8_t *table,
+        uint32_t index,
+        uint8_t value
+)
+{
+        uint8_t shift;
+
+        shift=(uint8_t)((index&1)<<2);
+        table[index>>1]=(uint8_t)((table[index>>1]&~(0x0F<<shift))|(value<<shift));
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Pruning step for the middle layer edges and corner orientation.
+*/
+static uint32_t
+step_slice_twist(
+        CubeSolver_t *solver,
+        uint32_t index,
+        uint8_t move
+)
+{
+        uint32_t slice;
+        uint32_t twist;
+
+        slice=solver->sliceMove[index/TWIST_COUNT*SLICE_ORDER_COUNT*CUBE_TURN_COUNT+move]/SLICE_ORDER_COUNT;
+        twist=solver->twistMove[index%TWIST_COUNT*CUBE_TURN_COUNT+move];
+        return slice*TWIST_COUNT+twist;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Pruning step for the middle layer edges and edge orientation.
+*/
+static uint32_t
+step_slice_flip(
+        CubeSolver_t *solver,
+        uint32_t index,
+        uint8_t move
+)
+{
+        uint32_t slice;
+        uint32_t flip;
+
+        slice=solver->sliceMove[index/FLIP_COUNT*SLICE_ORDER_COUNT*CUBE_TURN_COUNT+move]/SLICE_ORDER_COUNT;
+        flip=solver->flipMove[index%FLIP_COUNT*CUBE_TURN_COUNT+move];
+        return slice*FLIP_COUNT+flip;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Pruning step for the middle layer edge order and corner
+**  permutation, with phase 2 moves.
+*/
+static uint32_t
+step_slice_corner(
+        CubeSolver_t *solver,
+        uint32_t index,
+        uint8_t move
+)
+{
+        uint32_t order;
+        uint32_t corner;
+
+        order=solver->sliceMove[index%SLICE_ORDER_COUNT*CUBE_TURN_COUNT+phase2Moves[move]];
+        corner=solver->cornerMove[index/SLICE_ORDER_COUNT*PHASE2_MOVE_COUNT+move];
+        return corner*SLICE_ORDER_COUNT+order;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Pruning step for the middle layer edge order and the top and
+**  bottom layer edge permutation, with phase 2 moves.
+*/
+static uint32_t
+step_slice_edge(
+        CubeSolver_t *solver,
+        uint32_t index,
+        uint8_t move
+)
+{
+        uint32_t order;
+        uint32_t edge;
+
+        order=solver->sliceMove[index%SLICE_ORDER_COUNT*CUBE_TURN_COUNT+phase2Moves[move]];
+        edge=solver->edgeMove[index/SLICE_ORDER_COUNT*PHASE2_MOVE_COUNT+move];
+        return edge*SLICE_ORDER_COUNT+order;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Fills a pruning table with a breadth-first search from the solved
+**  state.
+**
+**  @param[in] solver The solver with the move tables ready.
+**  @param[out] table A pruning table.
+**  @param[in] count Number of entries.
+**  @param[in] step A step function.
+**  @param[in] moveCount Number of moves of the step function.
+*/
+static void
+build_prune(
+        CubeSolver_t *solver,
+        uint8_t *table,
+        uint32_t count,
+        PruneStep_t step,
+        uint8_t moveCount
+)
+{
+        uint32_t index;
+        uint32_t next;
+        uint32_t filled;
+        uint8_t depth;
+        uint8_t move;
+
+        memset(table,0xFF,(count+1)/2);
+        set_prune(table,0,0);
+        for(depth=0;depth<PRUNE_EMPTY-1;depth++){
+                filled=0;
+                for(index=0;index<count;index++){
+                        if(get_prune(table,index)!=depth){
+                                continue;
+                        }
+                        for(move=0;move<moveCount;move++){
+                                next=step(solver,index,move);
+                                if(get_prune(table,next)==PRUNE_EMPTY){
+                                        set_prune(table,next,depth+1);
+                                        filled++;
+                                }
+                        }
+                }
+                if(!filled){
+                        break;
+                }
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates all tables.
+**
+**  @param[in] solver A solver with the table memory allocated.
+*/
+static void
+build_tables(
+        CubeSolver_t *solver
+)
+{
+        CubeCubie_t c;
+        CubeCubie_t d;
+        uint32_t i;
+        uint8_t t;
+
+        cube_cubie_reset(&c);
+        for(i=0;i<TWIST_COUNT;i++){
+                cube_cubie_set_twist(&c,(uint16_t)i);
+                for(t=0;t<CUBE_TURN_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        solver->twistMove[i*CUBE_TURN_COUNT+t]=cube_cubie_get_twist(&d);
+                }
+        }
+        cube_cubie_reset(&c);
+        for(i=0;i<FLIP_COUNT;i++){
+                cube_cubie_set_flip(&c,(uint16_t)i);
+                for(t=0;t<CUBE_TURN_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        solver->flipMove[i*CUBE_TURN_COUNT+t]=cube_cubie_get_flip(&d);
+                }
+        }
+        cube_cubie_reset(&c);
+        for(i=0;i<SLICE_SORTED_COUNT;i++){
+                cube_cubie_set_slice(&c,(uint16_t)i);
+                for(t=0;t<CUBE_TURN_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,(CubeTurn_t)t);
+                        solver->sliceMove[i*CUBE_TURN_COUNT+t]=cube_cubie_get_slice(&d);
+                }
+        }
+        cube_cubie_reset(&c);
+        for(i=0;i<PERM_COUNT;i++){
+                cube_cubie_set_permutation(c.cp,CUBE_CORNER_COUNT,(uint16_t)i);
+                cube_cubie_set_permutation(c.ep,CUBE_EDGE_FR,(uint16_t)i);
+                for(t=0;t<PHASE2_MOVE_COUNT;t++){
+                        d=c;
+                        cube_cubie_turn(&d,phase2Moves[t]);
+                        solver->cornerMove[i*PHASE2_MOVE_COUNT+t]=cube_cubie_get_permutation(d.cp,CUBE_CORNER_COUNT);
+                        solver->edgeMove[i*PHASE2_MOVE_COUNT+t]=cube_cubie_get_permutation(d.ep,CUBE_EDGE_FR);
+                }
+        }
+        build_prune(solver,solver->sliceTwistPrune,SLICE_COUNT*TWIST_COUNT,step_slice_twist,CUBE_TURN_COUNT);
+        build_prune(solver,solver->sliceFlipPrune,SLICE_COUNT*FLIP_COUNT,step_slice_flip,CUBE_TURN_COUNT);
+        build_prune(solver,solver->sliceCornerPrune,SLICE_ORDER_COUNT*PERM_COUNT,step_slice_corner,PHASE2_MOVE_COUNT);
+        build_prune(solver,solver->sliceEdgePrune,SLICE_ORDER_COUNT*PERM_COUNT,step_slice_edge,PHASE2_MOVE_COUNT);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Lays out the tables in the table block.
+**
+**  @param[in] solver A solver with the table block allocated.
+*/
+static void
+layout_tables(
+        CubeSolver_t *solver
+)
+{
+        uint8_t *p;
+
+        p=solver->table.data;
+        solver->twistMove=(uint16_t *)p;
+        p+=TWIST_MOVE_BYTES;
+        solver->flipMove=(uint16_t *)p;
+        p+=FLIP_MOVE_BYTES;
+        solver->sliceMove=(uint16_t *)p;
+        p+=SLICE_MOVE_BYTES;
+        solver->cornerMove=(uint16_t *)p;
+        p+=PERM_MOVE_BYTES;
+        solver->edgeMove=(uint16_t *)p;
+        p+=PERM_MOVE_BYTES;
+        solver->sliceTwistPrune=p;
+        p+=SLICE_TWIST_PRUNE_BYTES;
+        solver->sliceFlipPrune=p;
+        p+=SLICE_FLIP_PRUNE_BYTES;
+        solver->sliceCornerPrune=p;
+        p+=SLICE_PERM_PRUNE_BYTES;
+        solver->sliceEdgePrune=p;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if a turn may follow another turn.
+**
+**  A face is not turned twice in a row, and of the opposite faces only the
+**  order U D, R L and F B is used.
+**
+**  @param[in] prev The previous turn.
+**  @param[in] turn The next turn.
+**
+**  @retval true The turn may follow.
+**  @retval false The turn is redundant.
+*/
+static inline bool
+allowed(
+        uint8_t prev,
+        uint8_t turn
+)
+{
+        uint8_t a;
+        uint8_t b;
+
+        a=prev/3;
+        b=turn/3;
+        return a!=b&&!(a%3==b%3&&b<a);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Searches phase 2 with a fixed depth.
+**
+**  @param[in] s A search.
+**  @param[in] corner Corner permutation.
+**  @param[in] edge Top and bottom layer edge permutation.
+**  @param[in] order Middle layer edge order.
+**  @param[in] n Moves so far.
+**  @param[in] togo Moves to go.
+**
+**  @retval true A solution was found.
+**  @retval false No solution of the depth.
+*/
+static bool
+search_phase2(
+        Search_t *s,
+        uint16_t corner,
+        uint16_t edge,
+        uint16_t order,
+        uint8_t n,
+        uint8_t togo
+)
+{
+        CubeSolver_t *solver;
+        uint16_t c;
+        uint16_t e;
+        uint16_t o;
+        uint8_t d;
+        uint8_t m;
+        uint8_t t;
+
+        if(!togo){
+                return !corner&&!edge&&!order;
+        }
+        solver=s->solver;
+        for(m=0;m<PHASE2_MOVE_COUNT;m++){
+                t=(uint8_t)phase2Moves[m];
+                if(n&&!allowed(s->moves[n-1],t)){
+                        continue;
+                }
+                c=solver->cornerMove[corner*PHASE2_MOVE_COUNT+m];
+                e=solver->edgeMove[edge*PHASE2_MOVE_COUNT+m];
+                o=solver->sliceMove[order*CUBE_TURN_COUNT+t];
+                d=get_prune(solver->sliceCornerPrune,(uint32_t)c*SLICE_ORDER_COUNT+o);
+                if(d>=togo){
+                        continue;
+                }
+                d=get_prune(solver->sliceEdgePrune,(uint32_t)e*SLICE_ORDER_COUNT+o);
+                if(d>=togo){
+                        continue;
+                }
+                s->moves[n]=t;
+                if(search_phase2(s,c,e,o,n+1,togo-1)){
+                        return true;
+                }
+        }
+        return false;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Starts phase 2 after a phase 1 solution.
+**
+**  A solution found is kept, and the length limit is lowered below it, so
+**  that the search goes on for a shorter solution.
+**
+**  @param[in] s A search.
+**  @param[in] order Middle layer edge order.
+**  @param[in] n Length of the phase 1 solution.
+**
+**  @retval true The search is over.
+**  @retval false The search goes on.
+*/
+static bool
+start_phase2(
+        Search_t *s,
+        uint16_t order,
+        uint8_t n
+)
+{
+        CubeCubie_t c;
+        uint16_t corner;
+        uint16_t edge;
+        uint8_t depth;
+        uint8_t d;
+        uint8_t i;
+
+        if(s->found&&!s->probes--){
+                return true;
+        }
+        c=s->cubie;
+        for(i=0;i<n;i++){
+                cube_cubie_turn(&c,(CubeTurn_t)s->moves[i]);
+        }
+        corner=cube_cubie_get_permutation(c.cp,CUBE_CORNER_COUNT);
+        edge=cube_cubie_get_permutation(c.ep,CUBE_EDGE_FR);
+        depth=get_prune(s->solver->sliceCornerPrune,(uint32_t)corner*SLICE_ORDER_COUNT+order);
+        d=get_prune(s->solver->sliceEdgePrune,(uint32_t)edge*SLICE_ORDER_COUNT+order);
+        if(d>depth){
+                depth=d;
+        }
+        for(;n+depth<=s->maxLength;depth++){
+                if(search_phase2(s,corner,edge,order,n,depth)){
+                        s->length=n+depth;
+                        s->found=true;
+                        memcpy(s->solution,s->moves,s->length);
+                        if(!s->length){
+                                return true;
+                        }
+                        s->maxLength=s->length-1;
+                        return false;
+                }
+        }
+        return false;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Searches phase 1 with a fixed depth.
+**
+**  @param[in] s A search.
+**  @param[in] twist Corner orientation.
+**  @param[in] flip Edge orientation.
+**  @param[in] slice Middle layer edge positions and order.
+**  @param[in] n Moves so far.
+**  @param[in] togo Moves to go.
+**
+**  @retval true The search is over.
+**  @retval false The search goes on.
+*/
+static bool
+search_phase1(
+        Search_t *s,
+        uint16_t twist,
+        uint16_t flip,
+        uint16_t slice,
+        uint8_t n,
+        uint8_t togo
+)
+{
+        CubeSolver_t *solver;
+        uint16_t tw;
+        uint16_t fl;
+        uint16_t sl;
+        uint8_t d;
+        uint8_t t;
+
+        // The limit is lowered by every solution found.
+        if(n+togo>s->maxLength){
+                return false;
+        }
+        if(!togo){
+                if(twist||flip||slice>=SLICE_ORDER_COUNT){
+                        return false;
+                }
+                // A phase 2 move at the end would be found as a part of a
+                // shorter phase 1 solution.
+                if(n&&phase2Index[s->moves[n-1]]!=NOT_PHASE2){
+                        return false;
+                }
+                return start_phase2(s,slice,n);
+        }
+        solver=s->solver;
+        for(t=0;t<CUBE_TURN_COUNT;t++){
+                if(n&&!allowed(s->moves[n-1],t)){
+                        continue;
+                }
+                tw=solver->twistMove[twist*CUBE_TURN_COUNT+t];
+                fl=solver->flipMove[flip*CUBE_TURN_COUNT+t];
+                sl=solver->sliceMove[slice*CUBE_TURN_COUNT+t];
+                d=get_prune(solver->sliceTwistPrune,(uint32_t)(sl/SLICE_ORDER_COUNT)*TWIST_COUNT+tw);
+                if(d>=togo){
+                        continue;
+                }
+                d=get_prune(solver->sliceFlipPrune,(uint32_t)(sl/SLICE_ORDER_COUNT)*FLIP_COUNT+fl);
+                if(d>=togo){
+                        continue;
+                }
+                s->moves[n]=t;
+                if(search_phase1(s,tw,fl,sl,n+1,togo-1)){
+                        return true;
+                }
+        }
+        return false;
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_solver_init(
+        CubeSolver_t *solver,
+        char *path
+)
+{
+        CubeTable_t mapped;
+
+        if(path&&cube_table_map(&solver->table,path,TABLE_ID,TABLE_VERSION,TABLE_BYTES)){
+                layout_tables(solver);
+                return true;
+        }
+        if(!cube_table_alloc(&solver->table,TABLE_BYTES)){
+                return false;
+        }
+        layout_tables(solver);
+        build_tables(solver);
+        // The saved file is mapped instead of the generated tables, so that
+        // the pages are shared with the other processes. A failure is
+        // ignored, as the tables are then generated again on the next run.
+        if(path&&cube_table_save(&solver->table,path,TABLE_ID,TABLE_VERSION)&&
+           cube_table_map(&mapped,path,TABLE_ID,TABLE_VERSION,TABLE_BYTES)){
+                cube_table_free(&solver->table);
+                solver->table=mapped;
+                layout_tables(solver);
+        }
+        return true;
+}
+
+void
+cube_solver_free(
+        CubeSolver_t *solver
+)
+{
+        cube_table_free(&solver->table);
+}
+
+bool
+cube_solver_solve(
+        CubeSolver_t *solver,
+        CubeCubie_t *cubie,
+        uint8_t maxLength,
+        CubeTurn_t *solution,
+        uint8_t *length
+)
+{
+        Search_t s;
+        uint16_t twist;
+        uint16_t flip;
+        uint16_t slice;
+        uint8_t depth;
+        uint8_t i;
+
+        *length=0;
+        if(!cube_cubie_is_valid(cubie)){
+                return false;
+        }
+        s.solver=solver;
+        s.cubie=*cubie;
+        s.maxLength=maxLength<CUBE_SOLVER_MAX_LENGTH?maxLength:CUBE_SOLVER_MAX_LENGTH;
+        s.found=false;
+        s.probes=CUBE_SOLVER_PROBE_COUNT;
+        twist=cube_cubie_get_twist(cubie);
+        flip=cube_cubie_get_flip(cubie);
+        slice=cube_cubie_get_slice(cubie);
+        for(depth=0;depth<=s.maxLength;depth++){
+                if(search_phase1(&s,twist,flip,slice,0,depth)){
+                        break;
+                }
+        }
+        if(!s.found){
+                return false;
+        }
+        for(i=0;i<s.length;i++){
+                solution[i]=(CubeTurn_t)s.solution[i];
+        }
+        *length=s.length;
+        return true;
+}
+
+#if CUBE_SIZE==3
+
+bool
+cube_solver_solve_cube(
+        CubeSolver_t *solver,
+        Cube_t *cube,
+        uint8_t maxLength,
+        CubeTurn_t *solution,
+        uint8_t *length
+)
+{
+        CubeCubie_t cubie;
+
+        *length=0;
+        if(!cube_cubie_from_cube(&cubie,cube)){
+                return false;
+        }
+        return cube_solver_solve(solver,&cubie,maxLength,solution,length);
+}
+
+#endif // if CUBE_SIZE==3
+
+/* EOF */
\ No newline at end of file
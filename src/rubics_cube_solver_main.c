@@ -0,0 +1,997 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_solver_main.c
+**  @ingroup    rubicscube
+**  @brief      Command line solver.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+
+#include "rubics_cube_bfs.h"
+#include "rubics_cube_notation.h"
+#include "rubics_cube_optimal.h"
+#include "rubics_cube_solver.h"
+#include "rubics_cube_thread.h"
+#include "rubics_cube_transposition.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if CUBE_SIZE==2||CUBE_SIZE==3
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Default table file.
+#define DEFAULT_TABLE_FILE "rubics_cube_solver.tables"
+
+/// Default table file of the optimal solver.
+#define DEFAULT_OPTIMAL_TABLE_FILE "rubics_cube_optimal.tables"
+
+/// The longest scramble in moves.
+#define SCRAMBLE_MAX_MOVES 1024
+
+/// Size of the solution text buffer.
+#define SOLUTION_TEXT_SIZE (CUBE_SOLVER_MAX_LENGTH*4)
+
+/// Size of a scramble line buffer in the batch mode.
+#define LINE_SIZE (SCRAMBLE_MAX_MOVES*4)
+
+/// Scrambles in the batch window for each thread.
+#define BATCH_SLOTS_PER_THREAD 16
+
+/// Size of the transposition table of the depth-first search in bytes. It is
+///small enough that a deep search replaces entries.
+#define SEARCH_TABLE_BYTES (16*1024*1024)
+
+/// Move stored with the states that have no solution within their depth.
+#define SEARCH_NO_MOVE 0xFF
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief The solver of the command.
+*/
+typedef struct
+Solvers_t{
+        /// Use the optimal solver.
+        bool useOptimal;
+        /// The longest accepted solution.
+        uint8_t maxLength;
+        /// Optimal solver.
+        CubeOptimal_t optimal;
+#if CUBE_SIZE==3
+        /// Two-phase solver.
+        CubeSolver_t solver;
+#endif
+} Solvers_t;
+
+/**
+**  @brief Result of a solve.
+*/
+typedef struct
+Result_t{
+        /// The scramble was parsed.
+        bool parsed;
+        /// A solution was found.
+        bool solved;
+        /// Number of turns in the solution.
+        uint8_t length;
+        /// The solution.
+        CubeTurn_t solution[CUBE_SOLVER_MAX_LENGTH];
+        /// Time of the solve in nanoseconds.
+        uint64_t time;
+} Result_t;
+
+/**
+**  @brief A scramble of the batch window.
+*/
+typedef struct
+BatchSlot_t{
+        /// The result is ready.
+        volatile uint32_t done;
+        /// The scramble line.
+        char line[LINE_SIZE];
+        /// The result.
+        Result_t result;
+} BatchSlot_t;
+
+/**
+**  @brief A batch of scrambles solved by several threads.
+**
+**  The main thread reads the scrambles into a window of slots and writes the
+**  results in the input order, and the other threads solve them. Scramble i
+**  is in slot i%slotCount.
+*/
+typedef struct
+Batch_t{
+        /// The solver.
+        Solvers_t *solvers;
+        /// The window.
+        BatchSlot_t *slots;
+        /// Number of slots in the window.
+        uint32_t slotCount;
+        /// Number of scrambles read.
+        volatile uint32_t read;
+        /// Number of scrambles taken by the threads.
+        volatile uint32_t taken;
+        /// The input has ended.
+        volatile uint32_t end;
+} Batch_t;
+
+/**
+**  @brief A depth-first search of a solution with the face turns, split to
+**         several threads by the first move.
+*/
+typedef struct
+Search_t{
+        /// The cube to solve.
+        Cube_t cube;
+        /// A transposition table shared by the threads, or NULL.
+        CubeTranspositionTable_t *table;
+        /// Number of threads.
+        uint32_t threadCount;
+        /// Depth of the current iteration.
+        uint8_t depth;
+        /// A thread has found a solution.
+        volatile uint32_t found;
+        /// The solution.
+        CubeTurn_t solution[CUBE_SOLVER_MAX_LENGTH];
+} Search_t;
+
+/**
+**  @brief A thread of a depth-first search.
+*/
+typedef struct
+SearchThread_t{
+        /// The search.
+        Search_t *search;
+        /// The thread.
+        CubeThread_t thread;
+        /// Index of the thread. The thread searches the first moves with
+        /// this index modulo the number of threads.
+        uint32_t index;
+        /// The cube turned along the current path.
+        Cube_t cube;
+        /// Moves of the current path.
+        CubeTurn_t moves[CUBE_SOLVER_MAX_LENGTH];
+        /// Nodes visited.
+        uint64_t nodes;
+} SearchThread_t;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Prints the usage.
+**
+**  @param[in] name Program name.
+*/
+static void
+usage(
+        char *name
+)
+{
+        printf("Usage: %s [-o] [-j threads] [-t table-file] [-n max-length] scramble\n",name);
+        printf("       %s [-o] [-j threads] [-t table-file] [-n max-length] -b file\n",name);
+        printf("       %s [-o] [-t table-file] -c\n",name);
+        printf("       %s [-j threads] [-n max-length] -x scramble\n",name);
+#if CUBE_SIZE==2
+        printf("       %s [-j threads] [-q] [-l] -e directory\n",name);
+#endif
+        printf("\n");
+        printf("Solves a %dx%dx%d cube scrambled with the given moves, for example\n",
+                CUBE_SIZE,CUBE_SIZE,CUBE_SIZE);
+        printf("%s \"R U R' U' F2 D\"\n",name);
+        printf("\n");
+        printf("  -o  Find the shortest solution, the only solver of the 2x2x2 cube.\n");
+        printf("  -j  Threads, of the shortest solution search or of the batch (%u).\n",
+                cube_thread_cpu_count());
+        printf("  -t  Table file, created on the first run (%s,\n",DEFAULT_TABLE_FILE);
+        printf("      or %s with -o).\n",DEFAULT_OPTIMAL_TABLE_FILE);
+        printf("  -n  The longest accepted solution (%d, or any length with -o).\n",
+                CUBE_SOLVER_DEFAULT_LENGTH);
+        printf("  -b  Solve the scrambles of a file, one per line, or - for the\n");
+        printf("      standard input. Each output line has the solution length,\n");
+        printf("      the time in milliseconds and the solution, or - and the\n");
+        printf("      reason of a failure.\n");
+        printf("  -c  Check the table file against its checksum.\n");
+        printf("  -x  Solve by a depth-first search of the face turns without and\n");
+        printf("      with a transposition table, and compare the nodes.\n");
+#if CUBE_SIZE==2
+        printf("  -e  Count the positions at each distance breadth-first, with the\n");
+        printf("      frontier files in the directory, to check the turns.\n");
+        printf("  -q  Count the distances in quarter turns with -e.\n");
+        printf("  -l  Turn with the layer turns instead of the packed engine with -e.\n");
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Initializes the solver.
+**
+**  @param[in,out] solvers The solver with the options set.
+**  @param[in] tableFile A path of the table file.
+**
+**  @retval true The solver is ready.
+**  @retval false Out of memory.
+*/
+static bool
+solvers_init(
+        Solvers_t *solvers,
+        char *tableFile
+)
+{
+        if(solvers->useOptimal){
+                return cube_optimal_init(&solvers->optimal,tableFile);
+        }
+#if CUBE_SIZE==3
+        return cube_solver_init(&solvers->solver,tableFile);
+#else
+        return false;
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks the tables of the solver against the checksum.
+**
+**  @param[in] solvers The solver.
+**
+**  @retval true The tables match the checksum.
+**  @retval false The tables are corrupted.
+*/
+static bool
+solvers_verify(
+        Solvers_t *solvers
+)
+{
+        if(solvers->useOptimal){
+                return cube_table_verify(&solvers->optimal.table);
+        }
+#if CUBE_SIZE==3
+        return cube_table_verify(&solvers->solver.table);
+#else
+        return false;
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Frees the solver.
+**
+**  @param[in] solvers The solver.
+*/
+static void
+solvers_free(
+        Solvers_t *solvers
+)
+{
+        if(solvers->useOptimal){
+                cube_optimal_free(&solvers->optimal);
+        }
+#if CUBE_SIZE==3
+        else{
+                cube_solver_free(&solvers->solver);
+        }
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Solves a scramble.
+**
+**  The scramble is turned on a facelet level cube, and the solution is
+**  checked with the same cube.
+**
+**  @param[in] solvers The solver.
+**  @param[in] scramble A scramble.
+**  @param[out] result The result.
+*/
+static void
+solve(
+        Solvers_t *solvers,
+        char *scramble,
+        Result_t *result
+)
+{
+        CubeMove_t moves[SCRAMBLE_MAX_MOVES];
+        Cube_t cube;
+        uint32_t count;
+        uint64_t start;
+
+        start=cube_thread_clock();
+        result->solved=false;
+        result->length=0;
+        result->parsed=cube_notation_parse(scramble,moves,SCRAMBLE_MAX_MOVES,&count);
+        if(result->parsed){
+                cube_reset(&cube);
+                cube_apply_moves(&cube,moves,count);
+                if(solvers->useOptimal){
+                        result->solved=cube_optimal_solve_cube(&solvers->optimal,&cube,
+                                solvers->maxLength,result->solution,&result->length);
+                }
+#if CUBE_SIZE==3
+                else{
+                        result->solved=cube_solver_solve_cube(&solvers->solver,&cube,
+                                solvers->maxLength,result->solution,&result->length);
+                }
+#endif
+        }
+        result->time=cube_thread_clock()-start;
+        if(result->solved){
+                cube_apply_turns(&cube,result->solution,result->length);
+                result->solved=cube_is_solved(&cube);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Writes a result line of the batch mode.
+**
+**  @param[in] output The output file.
+**  @param[in] result The result.
+*/
+static void
+write_result(
+        FILE *output,
+        Result_t *result
+)
+{
+        char text[SOLUTION_TEXT_SIZE];
+
+        if(!result->parsed){
+                fprintf(output,"-\t%.3f\tinvalid scramble\n",(double)result->time/1000000.0);
+        }
+        else if(!result->solved){
+                fprintf(output,"-\t%.3f\tno solution\n",(double)result->time/1000000.0);
+        }
+        else{
+                cube_notation_format_turns(result->solution,result->length,text,sizeof(text));
+                fprintf(output,"%u\t%.3f\t%s\n",result->length,(double)result->time/1000000.0,
+                        text);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Solves scrambles of a batch until the input ends.
+**
+**  @param[in] argument A pointer to the batch.
+*/
+static void
+run_batch(
+        void *argument
+)
+{
+        BatchSlot_t *slot;
+        Batch_t *batch;
+        uint32_t i;
+
+        batch=(Batch_t *)argument;
+        for(;;){
+                i=cube_atomic_add(&batch->taken,1);
+                // The end is checked before the read count, as the last
+                // scrambles are read before the end is set.
+                while(i>=cube_atomic_load(&batch->read)){
+                        if(cube_atomic_load(&batch->end)&&i>=cube_atomic_load(&batch->read)){
+                                return;
+                        }
+                        cube_thread_yield();
+                }
+                slot=&batch->slots[i%batch->slotCount];
+                solve(batch->solvers,slot->line,&slot->result);
+                cube_atomic_store(&slot->done,1);
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Writes the result of a scramble of the batch when it is ready, and
+**         frees its slot.
+**
+**  @param[in] batch The batch.
+**  @param[in] i Index of the scramble.
+**  @param[in] output The output file.
+**
+**  @retval true The scramble was solved.
+**  @retval false The scramble could not be solved.
+*/
+static bool
+write_slot(
+        Batch_t *batch,
+        uint32_t i,
+        FILE *output
+)
+{
+        BatchSlot_t *slot;
+
+        slot=&batch->slots[i%batch->slotCount];
+        while(!cube_atomic_load(&slot->done)){
+                cube_thread_yield();
+        }
+        write_result(output,&slot->result);
+        slot->done=0;
+        return slot->result.solved;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Solves the scrambles of a file.
+**
+**  The file is streamed through a window of a few scrambles per thread, so
+**  the size of the file does not matter. The results are written in the
+**  input order.
+**
+**  @param[in] solvers The solver.
+**  @param[in] input The scramble file.
+**  @param[in] threadCount Number of solving threads.
+**
+**  @retval true All scrambles were solved.
+**  @retval false A scramble could not be solved, or out of memory.
+*/
+static bool
+solve_batch(
+        Solvers_t *solvers,
+        FILE *input,
+        uint32_t threadCount
+)
+{
+        CubeThread_t threads[CUBE_THREAD_MAX_COUNT];
+        Batch_t batch;
+        BatchSlot_t *slot;
+        uint64_t start;
+        uint32_t started;
+        uint32_t failed;
+        uint32_t i;
+        uint32_t n;
+        int c;
+
+        batch.solvers=solvers;
+        batch.slotCount=threadCount*BATCH_SLOTS_PER_THREAD;
+        batch.slots=(BatchSlot_t *)malloc(batch.slotCount*sizeof(BatchSlot_t));
+        if(!batch.slots){
+                fprintf(stderr,"Out of memory.\n");
+                return false;
+        }
+        for(i=0;i<batch.slotCount;i++){
+                batch.slots[i].done=0;
+        }
+        batch.read=0;
+        batch.taken=0;
+        batch.end=0;
+        start=cube_thread_clock();
+        for(started=0;started<threadCount;started++){
+                if(!cube_thread_start(&threads[started],run_batch,&batch)){
+                        break;
+                }
+        }
+        if(!started){
+                free(batch.slots);
+                fprintf(stderr,"No threads.\n");
+                return false;
+        }
+
+        // A slot is reused when the result of its previous scramble has been
+        // written.
+        failed=0;
+        for(n=0;;n++){
+                if(n>=batch.slotCount&&!write_slot(&batch,n-batch.slotCount,stdout)){
+                        failed++;
+                }
+                slot=&batch.slots[n%batch.slotCount];
+                if(!fgets(slot->line,LINE_SIZE,input)){
+                        break;
+                }
+                // The rest of a too long line is skipped, and the cut scramble
+                // is marked invalid.
+                if(!strchr(slot->line,'\n')&&!feof(input)){
+                        strcpy(slot->line,"?");
+                        while((c=fgetc(input))!=EOF&&c!='\n'){
+                        }
+                }
+                cube_atomic_store(&batch.read,n+1);
+        }
+        // The slot of the scramble after the last one has already been
+        // written.
+        cube_atomic_store(&batch.end,1);
+        for(i=n>=batch.slotCount?n-batch.slotCount+1:0;i<n;i++){
+                if(!write_slot(&batch,i,stdout)){
+                        failed++;
+                }
+        }
+        for(i=0;i<started;i++){
+                cube_thread_join(&threads[i]);
+        }
+        free(batch.slots);
+        fflush(stdout);
+        fprintf(stderr,"%u scrambles, %u failed, %.3f s, %.1f scrambles/s\n",n,failed,
+                (double)(cube_thread_clock()-start)/1e9,
+                n*1e9/(double)(cube_thread_clock()-start+1));
+        return !failed;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Checks if a turn may follow another turn.
+**
+**  A face is not turned twice in a row, and of the opposite faces only the
+**  order U D, R L and F B is used.
+**
+**  @param[in] prev The previous turn.
+**  @param[in] turn The next turn.
+**
+**  @retval true The turn may follow.
+**  @retval false The turn is redundant.
+*/
+static inline bool
+search_allowed(
+        uint8_t prev,
+        uint8_t turn
+)
+{
+        uint8_t a;
+        uint8_t b;
+
+        a=prev/3;
+        b=turn/3;
+        return a!=b&&!(a%3==b%3&&b<a);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Searches the solutions of a fixed depth from a node.
+**
+**  The turns that may follow depend on the face of the previous turn, so
+**  the face is a part of the key of the state in the transposition table.
+**  A state is skipped when the table has it searched to the remaining depth
+**  without a solution. The states of the solution are stored with the move
+**  that solves them.
+**
+**  @param[in] thread A thread of the search.
+**  @param[in] n Moves so far.
+**  @param[in] togo Moves to go.
+**
+**  @retval true A solution was found.
+**  @retval false No solution of the depth, or another thread found one.
+*/
+static bool
+search_node(
+        SearchThread_t *thread,
+        uint8_t n,
+        uint8_t togo
+)
+{
+        Search_t *search;
+        uint64_t key;
+        uint8_t depth;
+        uint8_t move;
+        uint8_t t;
+
+        thread->nodes++;
+        if(!togo){
+                return cube_is_solved(&thread->cube);
+        }
+        search=thread->search;
+        if(cube_atomic_load(&search->found)){
+                return false;
+        }
+        // The root is split to the threads, so it is not in the table.
+        key=0;
+        if(search->table&&n){
+                key=cube_get_hash(&thread->cube)^
+                    (thread->moves[n-1]/3+1)*0x9E3779B97F4A7C15ULL;
+                if(cube_transposition_probe(search->table,key,&depth,&move)&&
+                   move==SEARCH_NO_MOVE&&depth>=togo){
+                        return false;
+                }
+        }
+        for(t=0;t<CUBE_TURN_COUNT;t++){
+                if(n?!search_allowed(thread->moves[n-1],t):t%search->threadCount!=thread->index){
+                        continue;
+                }
+                thread->moves[n]=(CubeTurn_t)t;
+                cube_apply_turns(&thread->cube,&thread->moves[n],1);
+                if(search_node(thread,n+1,togo-1)){
+                        if(search->table&&n){
+                                cube_transposition_store(search->table,key,togo,t);
+                        }
+                        return true;
+                }
+                // The inverse turn of the same face.
+                thread->moves[n]=(CubeTurn_t)(t/3*3+2-t%3);
+                cube_apply_turns(&thread->cube,&thread->moves[n],1);
+                thread->moves[n]=(CubeTurn_t)t;
+        }
+        // A search cut by the solution of another thread is not complete.
+        if(search->table&&n&&!cube_atomic_load(&search->found)){
+                cube_transposition_store(search->table,key,togo,SEARCH_NO_MOVE);
+        }
+        return false;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Searches the first moves of a thread with the current depth.
+**
+**  @param[in] argument A pointer to the thread.
+*/
+static void
+run_search(
+        void *argument
+)
+{
+        SearchThread_t *thread;
+        Search_t *search;
+
+        thread=(SearchThread_t *)argument;
+        search=thread->search;
+        thread->cube=search->cube;
+        if(search_node(thread,0,search->depth)&&
+           cube_atomic_compare_swap(&search->found,0,1)){
+                memcpy(search->solution,thread->moves,search->depth*sizeof(CubeTurn_t));
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Finds the shortest solution with an iterative deepening depth-first
+**         search of the face turns, without pruning tables.
+**
+**  Each iteration starts a new search on the transposition table. The
+**  entries of the earlier iterations stay valid, but they are replaced
+**  first.
+**
+**  @param[in] search The search with the cube, the table and the number of
+**                    threads set.
+**  @param[in] maxLength The longest accepted solution.
+**  @param[out] length Number of turns in the solution.
+**  @param[out] nodes Number of nodes visited.
+**
+**  @retval true A solution was found.
+**  @retval false No solution of the given length, or no threads.
+*/
+static bool
+search_solve(
+        Search_t *search,
+        uint8_t maxLength,
+        uint8_t *length,
+        uint64_t *nodes
+)
+{
+        SearchThread_t threads[CUBE_THREAD_MAX_COUNT];
+        uint32_t started;
+        uint32_t i;
+
+        *nodes=0;
+        search->found=0;
+        for(search->depth=0;search->depth<=maxLength;search->depth++){
+                if(search->table){
+                        cube_transposition_new_search(search->table);
+                }
+                for(started=0;started<search->threadCount;started++){
+                        threads[started].search=search;
+                        threads[started].index=started;
+                        threads[started].nodes=0;
+                        if(!cube_thread_start(&threads[started].thread,run_search,
+                                              &threads[started])){
+                                break;
+                        }
+                }
+                for(i=0;i<started;i++){
+                        cube_thread_join(&threads[i].thread);
+                        *nodes+=threads[i].nodes;
+                }
+                if(started<search->threadCount){
+                        return false;
+                }
+                if(search->found){
+                        *length=search->depth;
+                        return true;
+                }
+        }
+        return false;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Solves a scramble by a depth-first search without and with a
+**         transposition table, and prints the nodes of both.
+**
+**  Both searches must find a solution of the same length that solves the
+**  cube.
+**
+**  @param[in] scramble A scramble.
+**  @param[in] maxLength The longest accepted solution.
+**  @param[in] threadCount Number of threads.
+**
+**  @retval true The solutions are valid and of the same length.
+**  @retval false The scramble is invalid, no solution was found, the
+**                solutions differ in length, or out of memory.
+*/
+static bool
+search_compare(
+        char *scramble,
+        uint8_t maxLength,
+        uint32_t threadCount
+)
+{
+        CubeMove_t moves[SCRAMBLE_MAX_MOVES];
+        char text[SOLUTION_TEXT_SIZE];
+        CubeTranspositionTable_t table;
+        Search_t search;
+        Cube_t cube;
+        uint64_t start;
+        uint64_t nodes;
+        uint32_t count;
+        uint8_t length[2];
+        uint8_t i;
+        bool ok;
+
+        if(!cube_notation_parse(scramble,moves,SCRAMBLE_MAX_MOVES,&count)){
+                fprintf(stderr,"Invalid scramble.\n");
+                return false;
+        }
+        if(!cube_transposition_init(&table,SEARCH_TABLE_BYTES)){
+                fprintf(stderr,"Out of memory.\n");
+                return false;
+        }
+        cube_reset(&search.cube);
+        cube_apply_moves(&search.cube,moves,count);
+        search.threadCount=threadCount;
+        ok=true;
+        for(i=0;i<2&&ok;i++){
+                search.table=i?&table:NULL;
+                start=cube_thread_clock();
+                ok=search_solve(&search,maxLength,&length[i],&nodes);
+                if(!ok){
+                        fprintf(stderr,"No solution of %u moves or less.\n",maxLength);
+                        break;
+                }
+                cube=search.cube;
+                cube_apply_turns(&cube,search.solution,length[i]);
+                ok=cube_is_solved(&cube)&&(!i||length[i]==length[0]);
+                cube_notation_format_turns(search.solution,length[i],text,sizeof(text));
+                printf("%s table: %u moves, %llu nodes, %.3f s\n%s\n",i?"With":"Without",
+                        length[i],(unsigned long long)nodes,
+                        (double)(cube_thread_clock()-start)/1e9,text);
+        }
+        cube_transposition_free(&table);
+        return ok;
+}
+
+#if CUBE_SIZE==2
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Counts the positions at each distance and prints the counts.
+**
+**  @param[in] bfs The enumeration with the options set.
+**
+**  @retval true All positions were found with valid turns.
+**  @retval false The enumeration failed, or the turns are broken.
+*/
+static bool
+enumerate(
+        CubeBfs_t *bfs
+)
+{
+        uint64_t start;
+        uint8_t i;
+
+        start=cube_thread_clock();
+        if(!cube_bfs_run(bfs)){
+                fprintf(stderr,"Cannot write the frontier files to %s.\n",bfs->directory);
+                return false;
+        }
+        for(i=0;i<=bfs->depth;i++){
+                printf("%u\t%u\n",i,bfs->count[i]);
+        }
+        fprintf(stderr,"%u positions, %u invalid, %.3f s\n",bfs->total,bfs->invalid,
+                (double)(cube_thread_clock()-start)/1e9);
+        return bfs->total==CUBE_BFS_STATE_COUNT&&!bfs->invalid;
+}
+
+#endif // if CUBE_SIZE==2
+
+#endif // if CUBE_SIZE==2||CUBE_SIZE==3
+
+/******************************************************************************\
+**
+**  MAIN
+**
+\******************************************************************************/
+
+int
+main(
+        int argc,
+        char *argv[]
+)
+{
+#if CUBE_SIZE==2||CUBE_SIZE==3
+        char text[SOLUTION_TEXT_SIZE];
+        Solvers_t solvers;
+        Result_t result;
+#if CUBE_SIZE==2
+        CubeBfs_t bfs;
+#endif
+        FILE *input;
+        char *tableFile;
+        char *scramble;
+        char *batchFile;
+        uint32_t threadCount;
+        bool check;
+        bool compare;
+        bool ok;
+        int i;
+
+        tableFile=NULL;
+        check=false;
+        compare=false;
+        scramble=NULL;
+        batchFile=NULL;
+        threadCount=cube_thread_cpu_count();
+        solvers.maxLength=0;
+        // The 2x2x2 cube has only the optimal solver.
+        solvers.useOptimal=CUBE_SIZE==2;
+#if CUBE_SIZE==2
+        cube_bfs_init(&bfs);
+#endif
+        for(i=1;i<argc;i++){
+                if(!strcmp(argv[i],"-o")){
+                        solvers.useOptimal=true;
+                }
+                else if(!strcmp(argv[i],"-j")&&i+1<argc){
+                        threadCount=(uint32_t)atoi(argv[++i]);
+                }
+                else if(!strcmp(argv[i],"-t")&&i+1<argc){
+                        tableFile=argv[++i];
+                }
+                else if(!strcmp(argv[i],"-n")&&i+1<argc){
+                        solvers.maxLength=(uint8_t)atoi(argv[++i]);
+                }
+                else if(!strcmp(argv[i],"-b")&&i+1<argc){
+                        batchFile=argv[++i];
+                }
+                else if(!strcmp(argv[i],"-c")){
+                        check=true;
+                }
+                else if(!strcmp(argv[i],"-x")){
+                        compare=true;
+                }
+#if CUBE_SIZE==2
+                else if(!strcmp(argv[i],"-e")&&i+1<argc){
+                        bfs.directory=argv[++i];
+                }
+                else if(!strcmp(argv[i],"-q")){
+                        bfs.quarterTurns=true;
+                }
+                else if(!strcmp(argv[i],"-l")){
+                        bfs.layerTurns=true;
+                }
+#endif
+                else if(argv[i][0]!='-'&&!scramble){
+                        scramble=argv[i];
+                }
+                else{
+                        usage(argv[0]);
+                        return EXIT_FAILURE;
+                }
+        }
+#if CUBE_SIZE==2
+        if(bfs.directory){
+                if(scramble||batchFile||check||threadCount<1||threadCount>CUBE_THREAD_MAX_COUNT){
+                        usage(argv[0]);
+                        return EXIT_FAILURE;
+                }
+                bfs.threadCount=threadCount;
+                return enumerate(&bfs)?EXIT_SUCCESS:EXIT_FAILURE;
+        }
+#endif
+        if(compare){
+                if(!scramble||batchFile||check||
+                   solvers.maxLength>CUBE_SOLVER_MAX_LENGTH||threadCount<1||
+                   threadCount>CUBE_THREAD_MAX_COUNT){
+                        usage(argv[0]);
+                        return EXIT_FAILURE;
+                }
+                return search_compare(scramble,solvers.maxLength?solvers.maxLength:
+                        CUBE_SOLVER_DEFAULT_LENGTH,threadCount)?EXIT_SUCCESS:EXIT_FAILURE;
+        }
+        if(!tableFile){
+                tableFile=solvers.useOptimal?DEFAULT_OPTIMAL_TABLE_FILE:DEFAULT_TABLE_FILE;
+        }
+        if(!solvers.maxLength){
+                solvers.maxLength=solvers.useOptimal?CUBE_OPTIMAL_MAX_LENGTH:
+                        CUBE_SOLVER_DEFAULT_LENGTH;
+        }
+        if((check?scramble||batchFile:!scramble==!batchFile)||solvers.maxLength>CUBE_SOLVER_MAX_LENGTH||
+           threadCount<1||threadCount>CUBE_THREAD_MAX_COUNT){
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+        input=NULL;
+        if(batchFile){
+                input=strcmp(batchFile,"-")?fopen(batchFile,"r"):stdin;
+                if(!input){
+                        fprintf(stderr,"Cannot open %s.\n",batchFile);
+                        return EXIT_FAILURE;
+                }
+        }
+        if(!solvers_init(&solvers,tableFile)){
+                fprintf(stderr,"Out of memory.\n");
+                return EXIT_FAILURE;
+        }
+        if(check){
+                ok=solvers_verify(&solvers);
+                printf(ok?"%s is valid.\n":"%s is corrupted, remove it to generate "
+                        "the tables again.\n",tableFile);
+                solvers_free(&solvers);
+                return ok?EXIT_SUCCESS:EXIT_FAILURE;
+        }
+
+        // The batch is split by the scrambles, and a single scramble by the
+        // search.
+        if(batchFile){
+                ok=solve_batch(&solvers,input,threadCount);
+                if(input!=stdin){
+                        fclose(input);
+                }
+                solvers_free(&solvers);
+                return ok?EXIT_SUCCESS:EXIT_FAILURE;
+        }
+        solvers.optimal.threadCount=threadCount;
+        solve(&solvers,scramble,&result);
+        solvers_free(&solvers);
+        if(!result.parsed){
+                fprintf(stderr,"Invalid scramble.\n");
+                return EXIT_FAILURE;
+        }
+        if(!result.solved){
+                fprintf(stderr,"No solution of %u moves or less.\n",solvers.maxLength);
+                return EXIT_FAILURE;
+        }
+        printf("%u moves, %.3f ms\n",result.length,(double)result.time/1000000.0);
+        cube_notation_format_turns(result.solution,result.length,text,sizeof(text));
+        printf("%s\n",text);
+        return EXIT_SUCCESS;
+#else
+        (void)argc;
+        (void)argv;
+        fprintf(stderr,"The solver needs a 2x2x2 or 3x3x3 cube (CUBE_SIZE 2 or 3).\n");
+        return EXIT_FAILURE;
+#endif
+}
+
+/* EOF */
\ No newline at end of file
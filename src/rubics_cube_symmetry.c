@@ -0,0 +1,537 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_symmetry.c
+**  @ingroup    rubicscube
+**  @brief      Symmetries and canonical forms of cube states.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_symmetry.h"
+#include "rubics_cube_thread.h"
+
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Number of sides turned by the outer layer turns.
+#define TURN_SIDE_COUNT (CUBE_TURN_COUNT/3)
+
+/// A color that has not been numbered yet.
+#define NO_NUMBER 0xFF
+
+/// States of the tables.
+#define TABLES_NONE 0
+#define TABLES_BUILDING 1
+#define TABLES_READY 2
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Outward normals of the sides. The axes point to the right, up and
+**  to the front.
+*/
+static const int8_t
+sideNormal[CUBE_SIDE_COUNT][3]={
+        {0,0,1}, // Front
+        {0,0,-1}, // Back
+        {0,1,0}, // Top
+        {0,-1,0}, // Bottom
+        {-1,0,0}, // Left
+        {1,0,0} // Right
+};
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Sides of the outer layer turns, in the order of CubeTurn_t.
+*/
+static const CubeSide_t
+turnSide[TURN_SIDE_COUNT]={
+        CUBE_SIDE_TOP, // U
+        CUBE_SIDE_RIGHT, // R
+        CUBE_SIDE_FRONT, // F
+        CUBE_SIDE_BOTTOM, // D
+        CUBE_SIDE_LEFT, // L
+        CUBE_SIDE_BACK // B
+};
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Where the stickers of a side of a symmetric cube come from.
+**
+**  A symmetry maps the blocks of a side to the blocks of one side of the
+**  original cube, either turned or mirrored, so the source indices change
+**  by a constant step along the columns and rows.
+*/
+typedef struct
+SideMap_t{
+        /// Index of the source sticker of the first block.
+        int32_t first;
+        /// Step of the source index to the next column.
+        int32_t stepX;
+        /// Step of the source index to the next row.
+        int32_t stepY;
+} SideMap_t;
+
+/******************************************************************************\
+**
+**  LOCAL VARIABLES
+**
+\******************************************************************************/
+
+/// Matrices of the symmetries. A symmetry moves the point v to the point
+///matrix*v.
+static int8_t matrix[CUBE_SYMMETRY_COUNT][3][3];
+
+/// Source stickers of each side of the symmetric cubes.
+static SideMap_t sideMap[CUBE_SYMMETRY_COUNT][CUBE_SIDE_COUNT];
+
+/// Colors of the symmetric cubes by the original colors.
+static uint8_t colorMap[CUBE_SYMMETRY_COUNT][CUBE_COLOR_COUNT];
+
+/// Inverses of the symmetries.
+static uint8_t inverseSym[CUBE_SYMMETRY_COUNT];
+
+/// Turns on the symmetric cubes.
+static uint8_t turnMap[CUBE_SYMMETRY_COUNT][CUBE_TURN_COUNT];
+
+/// State of the tables (TABLES_NONE, TABLES_BUILDING or TABLES_READY).
+static volatile uint32_t tableState=TABLES_NONE;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the position of a block in space.
+**
+**  The center of the cube is the origin, the blocks are 2 units wide and
+**  the faces are at the distance of CUBE_SIZE from the origin. The top face
+**  has its first row at the back, the bottom face at the front, and the back
+**  face at the bottom with the columns from the left. The left and right
+**  faces have their first column at the back and front.
+**
+**  @param[in] side A side.
+**  @param[in] x Column of the block.
+**  @param[in] y Row of the block.
+**  @param[out] p The position.
+*/
+static void
+get_point(
+        uint8_t side,
+        int32_t x,
+        int32_t y,
+        int32_t p[3]
+)
+{
+        int32_t u;
+        int32_t v;
+
+        u=2*x-(CUBE_SIZE-1);
+        v=2*y-(CUBE_SIZE-1);
+        switch(side){
+        default:
+        case CUBE_SIDE_FRONT:
+                p[0]=u;
+                p[1]=-v;
+                p[2]=CUBE_SIZE;
+                break;
+        case CUBE_SIDE_BACK:
+                p[0]=u;
+                p[1]=v;
+                p[2]=-CUBE_SIZE;
+                break;
+        case CUBE_SIDE_TOP:
+                p[0]=u;
+                p[1]=CUBE_SIZE;
+                p[2]=v;
+                break;
+        case CUBE_SIDE_BOTTOM:
+                p[0]=u;
+                p[1]=-CUBE_SIZE;
+                p[2]=-v;
+                break;
+        case CUBE_SIDE_LEFT:
+                p[0]=-CUBE_SIZE;
+                p[1]=-v;
+                p[2]=u;
+                break;
+        case CUBE_SIDE_RIGHT:
+                p[0]=CUBE_SIZE;
+                p[1]=-v;
+                p[2]=-u;
+                break;
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the sticker at a position in space.
+**
+**  @param[in] p A position of a block, see get_point().
+**
+**  @return Index of the sticker in a packed cube.
+*/
+static int32_t
+get_sticker(
+        int32_t p[3]
+)
+{
+        uint8_t side;
+        int32_t u;
+        int32_t v;
+
+        if(p[2]==CUBE_SIZE){
+                side=CUBE_SIDE_FRONT;
+                u=p[0];
+                v=-p[1];
+        }
+        else if(p[2]==-CUBE_SIZE){
+                side=CUBE_SIDE_BACK;
+                u=p[0];
+                v=p[1];
+        }
+        else if(p[1]==CUBE_SIZE){
+                side=CUBE_SIDE_TOP;
+                u=p[0];
+                v=p[2];
+        }
+        else if(p[1]==-CUBE_SIZE){
+                side=CUBE_SIDE_BOTTOM;
+                u=p[0];
+                v=-p[2];
+        }
+        else if(p[0]==-CUBE_SIZE){
+                side=CUBE_SIDE_LEFT;
+                u=p[2];
+                v=-p[1];
+        }
+        else{
+                side=CUBE_SIDE_RIGHT;
+                u=-p[2];
+                v=-p[1];
+        }
+        return CUBE_PACKED_INDEX(side,(u+CUBE_SIZE-1)/2,(v+CUBE_SIZE-1)/2);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the side a symmetry moves a side to.
+**
+**  @param[in] sym A symmetry.
+**  @param[in] side A side.
+**
+**  @return The side.
+*/
+static uint8_t
+map_side(
+        uint8_t sym,
+        uint8_t side
+)
+{
+        int8_t n[3];
+        uint8_t i;
+        uint8_t k;
+
+        for(k=0;k<3;k++){
+                n[k]=(int8_t)(matrix[sym][k][0]*sideNormal[side][0]+
+                              matrix[sym][k][1]*sideNormal[side][1]+
+                              matrix[sym][k][2]*sideNormal[side][2]);
+        }
+        for(i=0;i<CUBE_SIDE_COUNT;i++){
+                if(!memcmp(n,sideNormal[i],sizeof(n))){
+                        break;
+                }
+        }
+        return i;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the source sticker of a block of a symmetric cube.
+**
+**  @param[in] sym A symmetry.
+**  @param[in] side Side of the block on the symmetric cube.
+**  @param[in] x Column of the block.
+**  @param[in] y Row of the block.
+**
+**  @return Index of the sticker on the original cube.
+*/
+static int32_t
+get_source(
+        uint8_t sym,
+        uint8_t side,
+        int32_t x,
+        int32_t y
+)
+{
+        int32_t p[3];
+        int32_t q[3];
+        uint8_t k;
+
+        // The inverse of a symmetry matrix is its transpose.
+        get_point(side,x,y,p);
+        for(k=0;k<3;k++){
+                q[k]=matrix[sym][0][k]*p[0]+matrix[sym][1][k]*p[1]+matrix[sym][2][k]*p[2];
+        }
+        return get_sticker(q);
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Generates the symmetry tables.
+*/
+static void
+build_tables(
+        void
+)
+{
+        static const uint8_t order[6][3]={
+                {0,1,2},{0,2,1},{1,0,2},{1,2,0},{2,0,1},{2,1,0}
+        };
+        uint8_t rotations;
+        uint8_t mirrors;
+        uint8_t sym;
+        uint8_t p;
+        uint8_t s;
+        uint8_t i;
+        uint8_t k;
+        int8_t det;
+
+        // The symmetries are the permutations of the axes with any signs.
+        // The ones that keep the handedness are the rotations.
+        rotations=0;
+        mirrors=CUBE_SYMMETRY_ROTATION_COUNT;
+        for(p=0;p<6;p++){
+                for(s=0;s<8;s++){
+                        det=(int8_t)((p==1||p==2||p==5)?-1:1);
+                        for(k=0;k<3;k++){
+                                det=(int8_t)(s>>k&1?-det:det);
+                        }
+                        sym=det>0?rotations++:mirrors++;
+                        memset(matrix[sym],0,sizeof(matrix[sym]));
+                        for(k=0;k<3;k++){
+                                matrix[sym][k][order[p][k]]=(int8_t)(s>>k&1?-1:1);
+                        }
+                }
+        }
+
+        for(sym=0;sym<CUBE_SYMMETRY_COUNT;sym++){
+                for(i=0;i<CUBE_SYMMETRY_COUNT;i++){
+                        for(k=0;k<9;k++){
+                                if(matrix[i][k/3][k%3]!=matrix[sym][k%3][k/3]){
+                                        break;
+                                }
+                        }
+                        if(k==9){
+                                inverseSym[sym]=i;
+                        }
+                }
+                for(s=0;s<CUBE_SIDE_COUNT;s++){
+                        sideMap[sym][s].first=get_source(sym,s,0,0);
+                        sideMap[sym][s].stepX=get_source(sym,s,1,0)-sideMap[sym][s].first;
+                        sideMap[sym][s].stepY=get_source(sym,s,0,1)-sideMap[sym][s].first;
+                        colorMap[sym][cube_get_reset_color((CubeSide_t)s)]=
+                                (uint8_t)cube_get_reset_color((CubeSide_t)map_side(sym,s));
+                }
+
+                // A mirror image of a clockwise turn is counter-clockwise.
+                for(i=0;i<CUBE_TURN_COUNT;i++){
+                        s=map_side(sym,turnSide[i/3]);
+                        k=0;
+                        while(turnSide[k]!=s){
+                                k++;
+                        }
+                        turnMap[sym][i]=(uint8_t)(k*3+(sym<CUBE_SYMMETRY_ROTATION_COUNT?i%3:2-i%3));
+                }
+        }
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Builds the stickers of a symmetric cube.
+**
+**  The stickers are compared with a bound while they are built, and the
+**  building stops at the first sticker greater than in the bound.
+**
+**  @param[in] packed A pointer to a packed cube.
+**  @param[in] sym A symmetry.
+**  @param[in] colors Number the colors in the order they appear.
+**  @param[in] bound Stickers to compare with, or NULL.
+**  @param[out] stickers The stickers of the symmetric cube.
+**
+**  @retval true The stickers are smaller than the bound, or there is no
+**               bound.
+**  @retval false The stickers are not smaller than the bound.
+*/
+static bool
+build_stickers(
+        CubePacked_t *packed,
+        uint8_t sym,
+        bool colors,
+        uint8_t *bound,
+        uint8_t *stickers
+)
+{
+        uint8_t number[CUBE_COLOR_COUNT];
+        SideMap_t *m;
+        int32_t src;
+        uint32_t k;
+        uint16_t x;
+        uint16_t y;
+        uint8_t next;
+        uint8_t side;
+        uint8_t c;
+        bool less;
+
+        memset(number,NO_NUMBER,sizeof(number));
+        next=0;
+        less=!bound;
+        k=0;
+        for(side=0;side<CUBE_SIDE_COUNT;side++){
+                m=&sideMap[sym][side];
+                for(x=0;x<CUBE_SIZE;x++){
+                        src=m->first+x*m->stepX;
+                        for(y=0;y<CUBE_SIZE;y++,k++,src+=m->stepY){
+                                c=packed->sticker[src];
+                                if(!colors){
+                                        c=colorMap[sym][c];
+                                }
+                                else{
+                                        if(number[c]==NO_NUMBER){
+                                                number[c]=next++;
+                                        }
+                                        c=number[c];
+                                }
+                                if(!less){
+                                        if(c>bound[k]){
+                                                return false;
+                                        }
+                                        less=c<bound[k];
+                                }
+                                stickers[k]=c;
+                        }
+                }
+        }
+        return less;
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+void
+cube_symmetry_init(
+        void
+)
+{
+        if(cube_atomic_load(&tableState)==TABLES_READY){
+                return;
+        }
+        if(cube_atomic_compare_swap(&tableState,TABLES_NONE,TABLES_BUILDING)){
+                build_tables();
+                cube_atomic_store(&tableState,TABLES_READY);
+                return;
+        }
+        while(cube_atomic_load(&tableState)!=TABLES_READY){
+                cube_thread_yield();
+        }
+}
+
+void
+cube_symmetry_apply(
+        CubePacked_t *packed,
+        uint8_t sym,
+        CubePacked_t *result
+)
+{
+        cube_symmetry_init();
+        memset(result->sticker+CUBE_PACKED_STICKERS,0,CUBE_PACKED_BYTES-CUBE_PACKED_STICKERS);
+        build_stickers(packed,sym%CUBE_SYMMETRY_COUNT,false,NULL,result->sticker);
+}
+
+uint8_t
+cube_symmetry_canonical(
+        CubePacked_t *packed,
+        bool colors,
+        CubePacked_t *result
+)
+{
+        uint8_t stickers[CUBE_PACKED_STICKERS];
+        uint8_t best;
+        uint8_t sym;
+
+        cube_symmetry_init();
+        memset(result->sticker+CUBE_PACKED_STICKERS,0,CUBE_PACKED_BYTES-CUBE_PACKED_STICKERS);
+        build_stickers(packed,0,colors,NULL,result->sticker);
+        best=0;
+        for(sym=1;sym<CUBE_SYMMETRY_COUNT;sym++){
+                if(build_stickers(packed,sym,colors,result->sticker,stickers)){
+                        memcpy(result->sticker,stickers,CUBE_PACKED_STICKERS);
+                        best=sym;
+                }
+        }
+        return best;
+}
+
+uint8_t
+cube_symmetry_inverse(
+        uint8_t sym
+)
+{
+        cube_symmetry_init();
+        return inverseSym[sym%CUBE_SYMMETRY_COUNT];
+}
+
+CubeTurn_t
+cube_symmetry_map_turn(
+        uint8_t sym,
+        CubeTurn_t turn
+)
+{
+        cube_symmetry_init();
+        if(turn>=CUBE_TURN_COUNT){
+                return turn;
+        }
+        return (CubeTurn_t)turnMap[sym%CUBE_SYMMETRY_COUNT][turn];
+}
+
+/* EOF */
\ No newline at end of file
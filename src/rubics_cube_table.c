@@ -0,0 +1,402 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_table.c
+**  @ingroup    rubicscube
+**  @brief      Memory mapped table files.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+// The table file is written with the standard C library functions.
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "rubics_cube_table.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Table file identifier.
+#define TABLE_MAGIC 0x42544352
+
+/// Version of the table file format.
+#define TABLE_FORMAT 1
+
+/// Multiplier of the checksum.
+#define CHECKSUM_PRIME 0x100000001B3ULL
+
+/// Initial value of the checksum.
+#define CHECKSUM_BASIS 0xCBF29CE484222325ULL
+
+/// Size of the name of the temporary file.
+#define TEMP_PATH_SIZE 1024
+
+/******************************************************************************\
+**
+**  LOCAL TYPE DEFINITIONS
+**
+\******************************************************************************/
+
+/**
+**  @brief Header of a table file.
+*/
+typedef struct
+TableHeader_t{
+        /// File identifier.
+        uint32_t magic;
+        /// Version of the file format.
+        uint32_t format;
+        /// Identifier of the table set.
+        uint32_t id;
+        /// Version of the table set.
+        uint32_t version;
+        /// Cube size.
+        uint32_t cubeSize;
+        /// Offset of the tables in the file.
+        uint32_t offset;
+        /// Size of the tables in bytes.
+        uint64_t size;
+        /// Checksum of the tables.
+        uint64_t checksum;
+        /// Checksum of the fields above.
+        uint64_t headerChecksum;
+} TableHeader_t;
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Calculates a checksum.
+**
+**  Eight bytes are mixed in at a time, which runs at the memory speed.
+**
+**  @param[in] data The data.
+**  @param[in] size Size of the data in bytes.
+**
+**  @return The checksum.
+*/
+static uint64_t
+checksum(
+        uint8_t *data,
+        uint64_t size
+)
+{
+        uint64_t h;
+        uint64_t w;
+        uint64_t i;
+
+        h=CHECKSUM_BASIS^size;
+        for(i=0;i+8<=size;i+=8){
+                memcpy(&w,data+i,8);
+                h=(h^w)*CHECKSUM_PRIME;
+                h^=h>>32;
+        }
+        for(;i<size;i++){
+                h=(h^data[i])*CHECKSUM_PRIME;
+        }
+        return h;
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Calculates the checksum of a header.
+**
+**  @param[in] header A header.
+**
+**  @return The checksum of the fields before the header checksum.
+*/
+static uint64_t
+header_checksum(
+        TableHeader_t *header
+)
+{
+        return checksum((uint8_t *)header,offsetof(TableHeader_t,headerChecksum));
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Maps a file read-only.
+**
+**  @param[in] path A path of the file.
+**  @param[out] size Size of the file in bytes.
+**
+**  @return The mapped file, or NULL if it cannot be mapped.
+*/
+static void *
+map_file(
+        char *path,
+        uint64_t *size
+)
+{
+#if defined(_WIN32)
+        LARGE_INTEGER fileSize;
+        HANDLE file;
+        HANDLE mapping;
+        void *map;
+
+        file=CreateFileA(path,GENERIC_READ,FILE_SHARE_READ|FILE_SHARE_DELETE,NULL,
+                OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL|FILE_FLAG_RANDOM_ACCESS,NULL);
+        if(file==INVALID_HANDLE_VALUE){
+                return NULL;
+        }
+        map=NULL;
+        *size=0;
+        if(GetFileSizeEx(file,&fileSize)&&fileSize.QuadPart>0&&
+           (uint64_t)fileSize.QuadPart<=(SIZE_T)-1){
+                // The view keeps the mapping open after the handles are closed.
+                mapping=CreateFileMappingA(file,NULL,PAGE_READONLY,0,0,NULL);
+                if(mapping){
+                        map=MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+                        CloseHandle(mapping);
+                }
+                *size=(uint64_t)fileSize.QuadPart;
+        }
+        CloseHandle(file);
+        return map;
+#else
+        struct stat st;
+        void *map;
+        int fd;
+
+        fd=open(path,O_RDONLY);
+        if(fd<0){
+                return NULL;
+        }
+        map=NULL;
+        *size=0;
+        if(!fstat(fd,&st)&&st.st_size>0&&(uint64_t)st.st_size<=(size_t)-1){
+                // The mapping stays valid after the file is closed.
+                map=mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_SHARED,fd,0);
+                if(map==MAP_FAILED){
+                        map=NULL;
+                }
+                *size=(uint64_t)st.st_size;
+        }
+        close(fd);
+        return map;
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Unmaps a file.
+**
+**  @param[in] map The mapped file.
+**  @param[in] size Size of the file in bytes.
+*/
+static void
+unmap_file(
+        void *map,
+        uint64_t size
+)
+{
+#if defined(_WIN32)
+        (void)size;
+        UnmapViewOfFile(map);
+#else
+        munmap(map,(size_t)size);
+#endif
+}
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Replaces a file with another one.
+**
+**  @param[in] from A path of the new file.
+**  @param[in] to A path of the file to replace.
+**
+**  @retval true The file was replaced.
+**  @retval false The file could not be replaced.
+*/
+static bool
+replace_file(
+        char *from,
+        char *to
+)
+{
+#if defined(_WIN32)
+        return MoveFileExA(from,to,MOVEFILE_REPLACE_EXISTING)!=0;
+#else
+        return !rename(from,to);
+#endif
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_table_alloc(
+        CubeTable_t *table,
+        uint64_t size
+)
+{
+        table->map=NULL;
+        table->mapSize=0;
+        table->checksum=0;
+        table->size=size;
+        table->data=size<=(size_t)-1?(uint8_t *)malloc((size_t)size):NULL;
+        return table->data!=NULL;
+}
+
+bool
+cube_table_map(
+        CubeTable_t *table,
+        char *path,
+        uint32_t id,
+        uint32_t version,
+        uint64_t size
+)
+{
+        TableHeader_t header;
+
+        table->data=NULL;
+        table->map=map_file(path,&table->mapSize);
+        if(!table->map){
+                return false;
+        }
+        if(table->mapSize<sizeof(header)){
+                cube_table_free(table);
+                return false;
+        }
+        memcpy(&header,table->map,sizeof(header));
+        if(header.magic!=TABLE_MAGIC||
+           header.format!=TABLE_FORMAT||
+           header.headerChecksum!=header_checksum(&header)||
+           header.id!=id||
+           header.version!=version||
+           header.cubeSize!=CUBE_SIZE||
+           header.offset!=CUBE_TABLE_DATA_OFFSET||
+           header.size!=size||
+           table->mapSize!=header.offset+header.size){
+                cube_table_free(table);
+                return false;
+        }
+        table->data=(uint8_t *)table->map+header.offset;
+        table->size=header.size;
+        table->checksum=header.checksum;
+        return true;
+}
+
+bool
+cube_table_save(
+        CubeTable_t *table,
+        char *path,
+        uint32_t id,
+        uint32_t version
+)
+{
+        static const uint8_t zero[CUBE_TABLE_DATA_OFFSET]={0};
+        char temp[TEMP_PATH_SIZE];
+        TableHeader_t header;
+        FILE *f;
+        bool ok;
+
+        if(strlen(path)+5>sizeof(temp)){
+                return false;
+        }
+        sprintf(temp,"%s.tmp",path);
+        table->checksum=checksum(table->data,table->size);
+        memset(&header,0,sizeof(header));
+        header.magic=TABLE_MAGIC;
+        header.format=TABLE_FORMAT;
+        header.id=id;
+        header.version=version;
+        header.cubeSize=CUBE_SIZE;
+        header.offset=CUBE_TABLE_DATA_OFFSET;
+        header.size=table->size;
+        header.checksum=table->checksum;
+        header.headerChecksum=header_checksum(&header);
+
+        f=fopen(temp,"wb");
+        if(!f){
+                return false;
+        }
+        ok=fwrite(&header,sizeof(header),1,f)==1&&
+           fwrite(zero,1,CUBE_TABLE_DATA_OFFSET-sizeof(header),f)==
+                CUBE_TABLE_DATA_OFFSET-sizeof(header)&&
+           fwrite(table->data,1,(size_t)table->size,f)==table->size;
+        ok=!fclose(f)&&ok;
+        if(!ok||!replace_file(temp,path)){
+                remove(temp);
+                return false;
+        }
+        return true;
+}
+
+bool
+cube_table_verify(
+        CubeTable_t *table
+)
+{
+        return checksum(table->data,table->size)==table->checksum;
+}
+
+void
+cube_table_free(
+        CubeTable_t *table
+)
+{
+        if(table->map){
+                unmap_file(table->map,table->mapSize);
+        }
+        else{
+                free(table->data);
+        }
+        table->map=NULL;
+        table->data=NULL;
+}
+
+/* EOF */
\ No newline at end of file
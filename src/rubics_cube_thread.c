@@ -0,0 +1,182 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_thread.c
+**  @ingroup    rubicscube
+**  @brief      Threads and atomic operations.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_thread.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Entry point of a thread.
+**
+**  @param[in] argument A pointer to the thread.
+**
+**  @return Always 0.
+*/
+#if defined(_WIN32)
+static DWORD WINAPI
+thread_entry(
+        LPVOID argument
+)
+#else
+static void *
+thread_entry(
+        void *argument
+)
+#endif
+{
+        CubeThread_t *thread;
+
+        thread=(CubeThread_t *)argument;
+        thread->function(thread->argument);
+        return 0;
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_thread_start(
+        CubeThread_t *thread,
+        CubeThreadFunction_t function,
+        void *argument
+)
+{
+        thread->function=function;
+        thread->argument=argument;
+#if defined(_WIN32)
+        thread->handle=CreateThread(NULL,0,thread_entry,thread,0,NULL);
+        return thread->handle!=NULL;
+#else
+        return !pthread_create(&thread->handle,NULL,thread_entry,thread);
+#endif
+}
+
+void
+cube_thread_join(
+        CubeThread_t *thread
+)
+{
+#if defined(_WIN32)
+        WaitForSingleObject(thread->handle,INFINITE);
+        CloseHandle(thread->handle);
+        thread->handle=NULL;
+#else
+        pthread_join(thread->handle,NULL);
+#endif
+}
+
+void
+cube_thread_yield(
+        void
+)
+{
+#if defined(_WIN32)
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+}
+
+uint32_t
+cube_thread_cpu_count(
+        void
+)
+{
+        uint32_t count;
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+
+        GetSystemInfo(&info);
+        count=info.dwNumberOfProcessors;
+#else
+        long n;
+
+        n=sysconf(_SC_NPROCESSORS_ONLN);
+        count=n>0?(uint32_t)n:1;
+#endif
+        if(count<1){
+                count=1;
+        }
+        if(count>CUBE_THREAD_MAX_COUNT){
+                count=CUBE_THREAD_MAX_COUNT;
+        }
+        return count;
+}
+
+uint64_t
+cube_thread_clock(
+        void
+)
+{
+#if defined(_WIN32)
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER counter;
+
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&counter);
+        return (uint64_t)(counter.QuadPart/frequency.QuadPart)*1000000000+
+               (uint64_t)(counter.QuadPart%frequency.QuadPart)*1000000000/
+               (uint64_t)frequency.QuadPart;
+#else
+        struct timespec t;
+
+        clock_gettime(CLOCK_MONOTONIC,&t);
+        return (uint64_t)t.tv_sec*1000000000+(uint64_t)t.tv_nsec;
+#endif
+}
+
+/* EOF */
\ No newline at end of file
@@ -0,0 +1,229 @@
+/***************************************************************************//**
+**
+**  @file       rubics_cube_transposition.c
+**  @ingroup    rubicscube
+**  @brief      Lock-free transposition table.
+**  @copyright  Copyright (C) 2018 Tuomas Terho. All rights reserved.
+**
+*******************************************************************************/
+/*
+**  BSD 3-Clause License
+**
+**  Copyright (c) 2018, Tuomas Terho
+**  All rights reserved.
+**
+**  Redistribution and use in source and binary forms, with or without
+**  modification, are permitted provided that the following conditions are met:
+**
+**  * Redistributions of source code must retain the above copyright notice,
+**    this list of conditions and the following disclaimer.
+**
+**  * Redistributions in binary form must reproduce the above copyright notice,
+**    this list of conditions and the following disclaimer in the documentation
+**    and/or other materials provided with the distribution.
+**
+**  * Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+**  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+**  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+**  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+**  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+**  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+**  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+**  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+**  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+**  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+**  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+**  POSSIBILITY OF SUCH DAMAGE.
+**
+\******************************************************************************/
+
+#include "rubics_cube_transposition.h"
+#include "rubics_cube_thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************\
+**
+**  LOCAL CONSTANT DEFINITIONS
+**
+\******************************************************************************/
+
+/// Size of a cache line in bytes.
+#define CACHE_LINE_SIZE 64
+
+/// Size of a bucket in bytes.
+#define BUCKET_BYTES (CUBE_TRANSPOSITION_BUCKET_SIZE*sizeof(CubeTranspositionEntry_t))
+
+/// Data word of an entry: the depth in bits 0-7, the move in bits 8-15 and
+///the generation in bits 16-23. The valid bit keeps the data of a stored
+///entry from being 0.
+#define DATA_MOVE_SHIFT 8
+#define DATA_GENERATION_SHIFT 16
+#define DATA_VALID ((uint64_t)1<<63)
+
+/// Fields of a data word.
+#define DATA_DEPTH(data) ((uint8_t)(data))
+#define DATA_MOVE(data) ((uint8_t)((data)>>DATA_MOVE_SHIFT))
+#define DATA_GENERATION(data) ((uint8_t)((data)>>DATA_GENERATION_SHIFT))
+
+/******************************************************************************\
+**
+**  LOCAL FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+/*-------------------------------------------------------------------------*//**
+**  @brief Gets the bucket of a state.
+**
+**  @param[in] table A pointer to a table.
+**  @param[in] hash Hash of the state.
+**
+**  @return The first entry of the bucket.
+*/
+static inline CubeTranspositionEntry_t *
+get_bucket(
+        CubeTranspositionTable_t *table,
+        uint64_t hash
+)
+{
+        return table->entries+(hash&table->bucketMask)*CUBE_TRANSPOSITION_BUCKET_SIZE;
+}
+
+/******************************************************************************\
+**
+**  API FUNCTION DEFINITIONS
+**
+\******************************************************************************/
+
+bool
+cube_transposition_init(
+        CubeTranspositionTable_t *table,
+        uint64_t size
+)
+{
+        uint64_t buckets;
+
+        buckets=1;
+        while(buckets*2*BUCKET_BYTES<=size){
+                buckets*=2;
+        }
+        table->entries=NULL;
+        table->bucketMask=buckets-1;
+        table->generation=0;
+        table->memory=buckets*BUCKET_BYTES+CACHE_LINE_SIZE<=(size_t)-1?
+                malloc((size_t)(buckets*BUCKET_BYTES+CACHE_LINE_SIZE)):NULL;
+        if(!table->memory){
+                return false;
+        }
+        table->entries=(CubeTranspositionEntry_t *)
+                (((uintptr_t)table->memory+CACHE_LINE_SIZE-1)&~(uintptr_t)(CACHE_LINE_SIZE-1));
+        cube_transposition_clear(table);
+        return true;
+}
+
+void
+cube_transposition_clear(
+        CubeTranspositionTable_t *table
+)
+{
+        memset((void *)table->entries,0,(size_t)((table->bucketMask+1)*BUCKET_BYTES));
+        table->generation=0;
+}
+
+void
+cube_transposition_new_search(
+        CubeTranspositionTable_t *table
+)
+{
+        table->generation++;
+}
+
+bool
+cube_transposition_probe(
+        CubeTranspositionTable_t *table,
+        uint64_t hash,
+        uint8_t *depth,
+        uint8_t *move
+)
+{
+        CubeTranspositionEntry_t *entry;
+        uint64_t data;
+        uint8_t i;
+
+        entry=get_bucket(table,hash);
+        for(i=0;i<CUBE_TRANSPOSITION_BUCKET_SIZE;i++,entry++){
+                data=cube_atomic_load64(&entry->data);
+                if(data&&(cube_atomic_load64(&entry->check)^data)==hash){
+                        *depth=DATA_DEPTH(data);
+                        *move=DATA_MOVE(data);
+                        return true;
+                }
+        }
+        return false;
+}
+
+void
+cube_transposition_store(
+        CubeTranspositionTable_t *table,
+        uint64_t hash,
+        uint8_t depth,
+        uint8_t move
+)
+{
+        CubeTranspositionEntry_t *entry;
+        CubeTranspositionEntry_t *victim;
+        uint64_t data;
+        uint32_t score;
+        uint32_t lowest;
+        uint8_t i;
+
+        entry=get_bucket(table,hash);
+        victim=entry;
+        lowest=UINT32_MAX;
+        for(i=0;i<CUBE_TRANSPOSITION_BUCKET_SIZE;i++,entry++){
+                data=cube_atomic_load64(&entry->data);
+                if(!data){
+                        victim=entry;
+                        break;
+                }
+                if((cube_atomic_load64(&entry->check)^data)==hash){
+                        if(DATA_GENERATION(data)==table->generation&&DATA_DEPTH(data)>depth){
+                                return;
+                        }
+                        victim=entry;
+                        break;
+                }
+                // The entries of the current search are kept before the ones
+                // of the earlier searches, and deep entries before shallow.
+                score=DATA_DEPTH(data);
+                if(DATA_GENERATION(data)==table->generation){
+                        score+=256;
+                }
+                if(score<lowest){
+                        lowest=score;
+                        victim=entry;
+                }
+        }
+        data=DATA_VALID|
+             (uint64_t)table->generation<<DATA_GENERATION_SHIFT|
+             (uint64_t)move<<DATA_MOVE_SHIFT|
+             depth;
+        cube_atomic_store64(&victim->check,hash^data);
+        cube_atomic_store64(&victim->data,data);
+}
+
+void
+cube_transposition_free(
+        CubeTranspositionTable_t *table
+)
+{
+        free(table->memory);
+        table->memory=NULL;
+        table->entries=NULL;
+}
+
+/* EOF */
\ No newline at end of file
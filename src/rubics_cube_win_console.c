@@ -44,6 +44,7 @@
 
 #include <windows.h>
 #include <conio.h>
+#include <stdio.h>
 
 /******************************************************************************\
 **
@@ -55,13 +56,13 @@
 #define FACE_SIZE (CUBE_SIZE*BLOCK_SIZE)
 
 /// A character for cube drawing.
-#define CUBE_CHAR "#"
+#define CUBE_CHAR '#'
 
 /// A character for row cursor.
-#define ROW_CURSOR_CHAR ">"
+#define ROW_CURSOR_CHAR '>'
 
 /// A character for column cursor.
-#define COL_CURSOR_CHAR "v"
+#define COL_CURSOR_CHAR 'v'
 
 /// Cursor color.
 #define CURSOR_COLOR 0x0F // White on black.
@@ -78,6 +79,19 @@
 /// Cube vertical position.
 #define CUBE_POS_Y 5
 
+/// Cube solved notification.
+#define SOLVED_TEXT "Congratulations! You solved the cube!"
+
+/// Width of the cube in characters.
+#define CUBE_WIDTH (CUBE_POS_X+3*FACE_SIZE+2*FACE_SPACING)
+
+/// Frame width in characters, wide enough for the cube and the texts.
+#define FRAME_WIDTH \
+        (CUBE_WIDTH>sizeof(SOLVED_TEXT)-1?CUBE_WIDTH:sizeof(SOLVED_TEXT)-1)
+
+/// Frame height in characters.
+#define FRAME_HEIGHT (CUBE_POS_Y+4*FACE_SIZE+3*FACE_SPACING)
+
 /// Face offsets for drawing.
 static const COORD faceOffset[CUBE_SIDE_COUNT]={
         {FACE_SIZE+FACE_SPACING,FACE_SIZE+FACE_SPACING},
@@ -98,6 +112,38 @@ static const uint16_t txtColor[CUBE_COLOR_COUNT]={
         0xFF // 7 // CUBE_COLOR_WHITE
 };
 
+/******************************************************************************\
+**
+**  LOCAL VARIABLES
+**
+\******************************************************************************/
+
+/// Console output handle.
+static HANDLE console;
+
+/// The frame, the characters and colors of the game area at the top left
+/// corner of the console.
+static CHAR_INFO frame[FRAME_HEIGHT][FRAME_WIDTH];
+
+/// The area of the frame changed since the frame was last written.
+static SMALL_RECT dirty;
+
+/// The frame has changed since it was last written.
+static bool isDirty;
+
+/// The cube as it was last drawn. Only the blocks and cursors that differ
+/// from it are drawn again.
+static Cube_t drawnCube;
+
+/// The drawn cube is in the frame.
+static bool isCubeDrawn;
+
+/// The turn count as it was last drawn.
+static uint32_t drawnTurns;
+
+/// The drawn turn count is in the frame.
+static bool isTurnsDrawn;
+
 /******************************************************************************\
 **
 **  LOCAL FUNCTIONS
@@ -105,71 +151,116 @@ static const uint16_t txtColor[CUBE_COLOR_COUNT]={
 \******************************************************************************/
 
 /**
-**  @brief A function to position the text cursor.
+**  @brief Fills a rectangle of the frame with a character.
+**
+**  The rectangle must be inside the frame.
 **
-**  @param[in] x Cursor horizontal position.
-**  @param[in] y Cursor vertical position.
+**  @param[in] c A character.
+**  @param[in] color Color of the character.
+**  @param[in] x Horizontal position of the top left corner.
+**  @param[in] y Vertical position of the top left corner.
+**  @param[in] width Width of the rectangle.
+**  @param[in] height Height of the rectangle.
 */
 static void
-gotoxy(
+fill(
+        char c,
+        uint16_t color,
         uint16_t x,
-        uint16_t y
+        uint16_t y,
+        uint16_t width,
+        uint16_t height
 )
 {
-        COORD c={x,y};
-        SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE),c);
+        uint16_t i;
+        uint16_t j;
+
+        for(j=y;j<y+height;j++){
+                for(i=x;i<x+width;i++){
+                        frame[j][i].Char.AsciiChar=c;
+                        frame[j][i].Attributes=color;
+                }
+        }
+        if(!isDirty){
+                dirty.Left=x;
+                dirty.Top=y;
+                dirty.Right=x+width-1;
+                dirty.Bottom=y+height-1;
+                isDirty=true;
+                return;
+        }
+        if(x<dirty.Left){
+                dirty.Left=x;
+        }
+        if(y<dirty.Top){
+                dirty.Top=y;
+        }
+        if(x+width-1>dirty.Right){
+                dirty.Right=x+width-1;
+        }
+        if(y+height-1>dirty.Bottom){
+                dirty.Bottom=y+height-1;
+        }
 }
 
 /**
-**  @brief A function to set text color.
+**  @brief Puts a text to the frame.
 **
-**  @param[in] color Color to set.
+**  The text is cut at the right edge of the frame.
+**
+**  @param[in] text A text.
+**  @param[in] color Color of the text.
+**  @param[in] x Horizontal position of the text.
+**  @param[in] y Vertical position of the text.
 */
 static void
-textcolor(
-        uint16_t color
+put_text(
+        const char *text,
+        uint16_t color,
+        uint16_t x,
+        uint16_t y
 )
 {
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),color);
+        for(;*text&&x<FRAME_WIDTH;text++,x++){
+                fill(*text,color,x,y,1,1);
+        }
 }
 
 /**
-**  @brief Draws one block.
+**  @brief Writes the changed area of the frame to the console.
 **
-**  @param[in] color Color of the block.
-**  @param[in] x Horizontal position of the top left corner.
-**  @param[in] y Vertical position of the top left corner.
+**  The area is written with one call, so a frame appears at once.
 */
-static void 
-draw_block(
-        CubeColor_t color,
-        uint16_t x,
-        uint16_t y
+static void
+present(
+        void
 )
 {
-        uint8_t i;
-        uint8_t j;
+        COORD size={FRAME_WIDTH,FRAME_HEIGHT};
+        COORD from;
 
-        textcolor(txtColor[color]);
-
-        for(i=0;i<BLOCK_SIZE;i++){
-                for(j=0;j<BLOCK_SIZE;j++){
-                        gotoxy(x+i,y+j);
-                        _cprintf(CUBE_CHAR);
-                }
+        if(!isDirty){
+                return;
         }
+        from.X=dirty.Left;
+        from.Y=dirty.Top;
+        WriteConsoleOutputA(console,&frame[0][0],size,from,&dirty);
+        isDirty=false;
 }
 
 /**
-**  @brief Draws a cube face.
+**  @brief Draws the blocks of a cube face that have changed.
 **
 **  @param[in] face Face to draw.
+**  @param[in] drawn The face as it is in the frame, or NULL to draw all
+**                   blocks.
 **  @param[in] x Horizontal position of the top left corner.
 **  @param[in] y Vertical position of the top left corner.
 */
 static void 
 draw_face(
         CubeFace_t *face,
+        CubeFace_t *drawn,
         uint16_t x,
         uint16_t y
 )
@@ -179,76 +270,71 @@ draw_face(
 
         for(i=0;i<CUBE_SIZE;i++){
                 for(j=0;j<CUBE_SIZE;j++){
-                        draw_block(
-                                face->blocks[i][j],
+                        if(drawn&&face->blocks[i][j]==drawn->blocks[i][j]){
+                                continue;
+                        }
+                        fill(
+                                CUBE_CHAR,
+                                txtColor[face->blocks[i][j]],
                                 x+i*BLOCK_SIZE,
-                                y+j*BLOCK_SIZE
+                                y+j*BLOCK_SIZE,
+                                BLOCK_SIZE,
+                                BLOCK_SIZE
                         );
                 }
         }
 }
 
 /**
-**  @brief Clears the cursors from the screen.
+**  @brief Draws the row cursor at one row.
 **
-**  @param[in] cube A pointer to a cube.
+**  @param[in] row Row of the cursor.
+**  @param[in] cursor Cursor character, or a space to clear the cursor.
 **  @param[in] x Overall horizontal position of the cube.
 **  @param[in] y Overall vertical position of the cube.
 */
 static void 
-clear_cursors(
-        Cube_t *cube,
+draw_row_cursor(
+        uint8_t row,
+        char cursor,
         uint16_t x,
         uint16_t y
 )
 {
-        uint8_t i;
-
-        textcolor(CURSOR_COLOR);
-
-        for(i=0;i<FACE_SIZE;i++){
-                gotoxy(
-                        faceOffset[CUBE_SIDE_FRONT].X+x+i,
-                        faceOffset[CUBE_SIDE_FRONT].Y+y-1
-                );
-                _cprintf(" ");
-                gotoxy(
-                        faceOffset[CUBE_SIDE_FRONT].X+x-1,
-                        faceOffset[CUBE_SIDE_FRONT].Y+y+i
-                );
-                _cprintf(" ");
-        }
+        fill(
+                cursor,
+                CURSOR_COLOR,
+                faceOffset[CUBE_SIDE_FRONT].X+x-1,
+                faceOffset[CUBE_SIDE_FRONT].Y+y+row*BLOCK_SIZE,
+                1,
+                BLOCK_SIZE
+        );
 }
 
 /**
-**  @brief Draws the cursors to the screen.
+**  @brief Draws the column cursor at one column.
 **
+**  @param[in] col Column of the cursor.
+**  @param[in] cursor Cursor character, or a space to clear the cursor.
 **  @param[in] x Overall horizontal position of the cube.
 **  @param[in] y Overall vertical position of the cube.
 */
 static void 
-draw_cursors(
-        Cube_t *cube,
+draw_col_cursor(
+        uint8_t col,
+        char cursor,
         uint16_t x,
         uint16_t y
 )
 {
-        uint8_t i;
-
-        textcolor(CURSOR_COLOR);
-
-        for(i=0;i<BLOCK_SIZE;i++){
-                gotoxy(
-                        faceOffset[CUBE_SIDE_FRONT].X+x-1,
-                        faceOffset[CUBE_SIDE_FRONT].Y+y+cube->row*BLOCK_SIZE+i
-                );
-                _cprintf(">");
-                gotoxy(
-                        faceOffset[CUBE_SIDE_FRONT].X+x+cube->col*BLOCK_SIZE+i,
-                        faceOffset[CUBE_SIDE_FRONT].Y+y-1
-                );
-                _cprintf("v");
-        }
+        fill(
+                cursor,
+                CURSOR_COLOR,
+                faceOffset[CUBE_SIDE_FRONT].X+x+col*BLOCK_SIZE,
+                faceOffset[CUBE_SIDE_FRONT].Y+y-1,
+                BLOCK_SIZE,
+                1
+        );
 }
 
 /******************************************************************************\
@@ -259,6 +345,8 @@ draw_cursors(
 
 /**
 **  @brief A function to init game graphics.
+**
+**  The game area is cleared.
 */
 static void
 winconsole_graphics_init(
@@ -267,15 +355,25 @@ winconsole_graphics_init(
 {
         CONSOLE_CURSOR_INFO ci;
 
+        console=GetStdHandle(STD_OUTPUT_HANDLE);
+        isDirty=false;
+        isCubeDrawn=false;
+        isTurnsDrawn=false;
+        fill(' ',TEXT_COLOR,0,0,FRAME_WIDTH,FRAME_HEIGHT);
+
+        GetConsoleCursorInfo(console,&ci);
         ci.bVisible=false;
 
-        SetConsoleCursorInfo(GetStdHandle(STD_OUTPUT_HANDLE),&ci);
-        _cprintf("                                     ");
+        SetConsoleCursorInfo(console,&ci);
 }
 
 /**
 **  @brief A function to draw a cube.
 **
+**  Only the blocks and cursors that have changed since the previous frame
+**  are drawn. The frame is written to the console when the next control is
+**  read.
+**
 **  @param[in] cube A cube to draw.
 */
 static void
@@ -284,16 +382,31 @@ winconsole_graphics_draw_cube(
 )
 {
         uint8_t i;
+        uint16_t x=CUBE_POS_X;
+        uint16_t y=CUBE_POS_Y;
 
         for(i=0;i<CUBE_SIDE_COUNT;i++){
                 draw_face(
                         &cube->face[i],
-                        faceOffset[i].X+CUBE_POS_X,
-                        faceOffset[i].Y+CUBE_POS_Y
+                        isCubeDrawn?&drawnCube.face[i]:NULL,
+                        faceOffset[i].X+x,
+                        faceOffset[i].Y+y
                 );
         }
-        clear_cursors(cube,CUBE_POS_X,CUBE_POS_Y);
-        draw_cursors(cube,CUBE_POS_X,CUBE_POS_Y);
+        if(!isCubeDrawn||cube->row!=drawnCube.row){
+                if(isCubeDrawn){
+                        draw_row_cursor(drawnCube.row,' ',x,y);
+                }
+                draw_row_cursor(cube->row,ROW_CURSOR_CHAR,x,y);
+        }
+        if(!isCubeDrawn||cube->col!=drawnCube.col){
+                if(isCubeDrawn){
+                        draw_col_cursor(drawnCube.col,' ',x,y);
+                }
+                draw_col_cursor(cube->col,COL_CURSOR_CHAR,x,y);
+        }
+        drawnCube=*cube;
+        isCubeDrawn=true;
 }
 
 /**
@@ -310,11 +423,15 @@ winconsole_graphics_print_statistics(
         int8_t *player
 )
 {
-        textcolor(TEXT_COLOR);
-        gotoxy(0,0);
-        _cprintf("Turns:         ");
-        gotoxy(0,0);
-        _cprintf("Turns: %d\n",turns);
+        char s[32];
+
+        if(isTurnsDrawn&&turns==drawnTurns){
+                return;
+        }
+        snprintf(s,sizeof(s),"Turns: %-8u",turns);
+        put_text(s,TEXT_COLOR,0,0);
+        drawnTurns=turns;
+        isTurnsDrawn=true;
 }
 
 /**
@@ -325,9 +442,7 @@ winconsole_graphics_cube_solved(
         void
 )
 {
-        gotoxy(0,1);
-        textcolor(SOLVED_COLOR);
-        _cprintf("Congratulations! You solved the cube!");
+        put_text(SOLVED_TEXT,SOLVED_COLOR,0,1);
 }
 
 /******************************************************************************\
@@ -349,6 +464,9 @@ winconsole_input_init(
 /**
 **  @brief Gets an input control.
 **
+**  The frame drawn since the previous control is written to the console
+**  first.
+**
 **  @return An input control value.
 */
 static CubeGameControl_t
@@ -356,6 +474,8 @@ winconsole_input_get(
         void
 )
 {
+        present();
+
         switch(_getch()){
         default:return GAME_CONTROL_UNKNOWN;
         case 'w':return GAME_CONTROL_MOVE_CURSOR_UP;